@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+volatile double benchmarkSink = 0;
+
+void Benchmark::run(const std::string& name, long size, long operations, const std::function<void()>& body) {
+	for (int i = 0; i < warmup; i++) {
+		body();
+	}
+
+	std::vector<double> times;
+	times.reserve(BENCHMARK_TAIL_SAMPLES);
+	double measured = 0;
+	while (static_cast<int>(times.size()) < repetitions || (times.size() < BENCHMARK_TAIL_SAMPLES && measured < BENCHMARK_TIME_BUDGET * 1e9)) {
+		auto start = std::chrono::steady_clock::now();
+		body();
+		double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		times.push_back(elapsed / operations);
+		measured += elapsed;
+	}
+	std::sort(times.begin(), times.end());
+
+	BenchmarkCase result;
+	result.name = name;
+	result.size = size;
+	result.operations = operations;
+	result.samples = static_cast<long>(times.size());
+	result.min = times.front();
+	result.median = times[times.size() / 2];
+	// Nearest rank, the maximum only for cases too slow for a hundred samples in the budget
+	result.p99 = times[static_cast<size_t>(std::ceil(times.size() * 0.99)) - 1];
+	result.max = times.back();
+	results.push_back(result);
+
+	printf("%-40s %9ld | median = %10.2f ns | p99 = %10.2f ns | min = %10.2f ns | %5ld samples\n", name.c_str(), size, result.median, result.p99, result.min, result.samples);
+}
+
+bool Benchmark::writeResults(const std::string& path) {
+	std::filesystem::create_directory("logData");
+	std::ofstream resultFile(path, std::ios::out);
+	if (!resultFile.is_open()) {
+		std::cout << "Error: Could not open " << path << std::endl;
+		return false;
+	}
+	resultFile << "benchmark;size;operations;repetitions;min[ns];median[ns];p99[ns];max[ns];\n";
+	for (const BenchmarkCase& result : results) {
+		resultFile << result.name << ";" << result.size << ";" << result.operations << ";" << result.samples << ";"
+			<< result.min << ";" << result.median << ";" << result.p99 << ";" << result.max << ";\n";
+	}
+	std::cout << "Results written to " << path << std::endl;
+	return true;
+}
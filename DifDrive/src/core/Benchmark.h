@@ -0,0 +1,48 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_TAIL_SAMPLES 1000		//cheap cases repeat until this many samples, so p99 is not the maximum
+#define BENCHMARK_TIME_BUDGET 1.0		//[s] of measurement per case for the extra samples
+
+// Sink for benchmark results, keeps the compiler from removing the measured work
+extern volatile double benchmarkSink;
+
+// Repeats a measured body after a few warmup runs and keeps per operation statistics of
+// every case, written as one CSV row per case so results of two builds can be diffed.
+// Every case runs at least repetitionRuns times, cheap ones more within the time budget
+class Benchmark {
+public:
+	Benchmark(int warmupRuns, int repetitionRuns) {
+		warmup = warmupRuns;
+		repetitions = repetitionRuns;
+	}
+
+	// body performs `operations` operations of the measured function per call
+	void run(const std::string& name, long size, long operations, const std::function<void()>& body);
+
+	// Median time per operation of the last case [ns]
+	double getLastMedian() const {
+		return results.empty() ? 0 : results.back().median;
+	}
+
+	bool writeResults(const std::string& path);
+
+private:
+	struct BenchmarkCase {
+		std::string name;
+		long size;
+		long operations;
+		long samples;
+		double min;
+		double median;
+		double p99;
+		double max;
+	};
+
+	int warmup;
+	int repetitions;
+	std::vector<BenchmarkCase> results;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#define DEFAULT_WHEEL_RADIUS 0.05f					//0.05[m] -> 0.5[dm] -> 5 [cm] -> 50 [mm]
+#define DEFAULT_WHEELDIST 0.1f						//0.10[m] -> 1.0[dm] -> 10[cm] -> 100[mm]
+#define DEFAULT_WHEELBASE (DEFAULT_WHEELDIST * 2)	//0.20[m] -> 2.0[dm] -> 20[cm] -> 200[mm]
+#define DEFAULT_TRAIL_LEN 100
+
+#define TIME_mS 0.001f
+#define TIME_uS (TIME_mS * TIME_mS)
+
+#define SIMULATION_FIXED_STEP 0.005f
+#define SIMULATION_SECOND_STEP_AMOUNT 200.f
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+inline double degToRad(double degrees) {
+	return degrees * (M_PI / 180.0);
+}
+
+// Simulated time after a number of fixed steps, in double so long runs keep the step resolution
+inline double getStepTime(long step) {
+	return step / static_cast<double>(SIMULATION_SECOND_STEP_AMOUNT);
+}
@@ -0,0 +1,164 @@
+#include "CoverageMap.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+bool CoverageMap::create(long columnCount, long rowCount, double metersPerCell, double x0, double y0) {
+	if (columnCount <= 0 || rowCount <= 0 || !(metersPerCell > 0)) {
+		std::cout << "Error: Coverage map needs a positive size and resolution" << std::endl;
+		return false;
+	}
+	if (static_cast<long long>(columnCount) * rowCount > COVERAGE_MAX_CELLS) {
+		std::cout << "Error: Coverage map of " << columnCount << " x " << rowCount << " cells is too large" << std::endl;
+		return false;
+	}
+	columns = columnCount;
+	rows = rowCount;
+	tileColumns = ((columns - 1) >> COVERAGE_TILE_SHIFT) + 1;
+	long tileRows = ((rows - 1) >> COVERAGE_TILE_SHIFT) + 1;
+	resolution = metersPerCell;
+	originX = x0;
+	originY = y0;
+
+	tiles.clear();
+	tiles.resize(static_cast<size_t>(tileColumns) * tileRows);
+	return true;
+}
+
+std::uint32_t CoverageMap::getMaxCount() const {
+	std::uint32_t maximum = 0;
+	for (const std::vector<std::uint32_t>& tile : tiles) {
+		for (std::uint32_t count : tile) {
+			maximum = std::max(maximum, count);
+		}
+	}
+	return maximum;
+}
+
+std::uint64_t CoverageMap::getTotal() const {
+	std::uint64_t total = 0;
+	for (const std::vector<std::uint32_t>& tile : tiles) {
+		for (std::uint32_t count : tile) {
+			total += count;
+		}
+	}
+	return total;
+}
+
+size_t CoverageMap::getMemoryBytes() const {
+	size_t bytes = tiles.size() * sizeof(std::vector<std::uint32_t>);
+	for (const std::vector<std::uint32_t>& tile : tiles) {
+		bytes += tile.size() * sizeof(std::uint32_t);
+	}
+	return bytes;
+}
+
+void CoverageMap::mergeTiles(const std::vector<const CoverageMap*>& parts, size_t first, size_t last) {
+	const size_t tileCells = static_cast<size_t>(1) << (2 * COVERAGE_TILE_SHIFT);
+	for (size_t index = first; index < last && index < tiles.size(); index++) {
+		for (const CoverageMap* part : parts) {
+			const std::vector<std::uint32_t>& source = part->tiles[index];
+			if (source.empty())
+				continue;
+			std::vector<std::uint32_t>& target = tiles[index];
+			if (target.empty()) {
+				target = source;
+				continue;
+			}
+			for (size_t cell = 0; cell < tileCells; cell++) {
+				target[cell] += source[cell];
+			}
+		}
+	}
+}
+
+bool CoverageMap::saveToFile(const std::string& path) const {
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cout << "Error: Could not open " << path << std::endl;
+		return false;
+	}
+	CoverageFileHeader header = CoverageFileHeader();
+	header.magic = COVERAGE_MAGIC;
+	header.version = COVERAGE_VERSION;
+	header.columns = columns;
+	header.rows = rows;
+	header.resolution = resolution;
+	header.originX = originX;
+	header.originY = originY;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	std::vector<std::uint32_t> row(columns);
+	for (long r = 0; r < rows; r++) {
+		for (long c = 0; c < columns; c++) {
+			row[c] = getCount(c, r);
+		}
+		file.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(std::uint32_t));
+	}
+	if (!file.good()) {
+		std::cout << "Error: Could not write " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool CoverageMap::loadFromFile(const std::string& path) {
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		std::cout << "Error: Could not open " << path << std::endl;
+		return false;
+	}
+	CoverageFileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != COVERAGE_MAGIC) {
+		std::cout << "Error: " << path << " is not a coverage map" << std::endl;
+		return false;
+	}
+	if (header.version != COVERAGE_VERSION) {
+		std::cout << "Error: Coverage map version " << header.version << " is not supported" << std::endl;
+		return false;
+	}
+	if (!create(static_cast<long>(header.columns), static_cast<long>(header.rows), header.resolution, header.originX, header.originY))
+		return false;
+
+	const long tileSize = 1L << COVERAGE_TILE_SHIFT;
+	std::vector<std::uint32_t> row(columns);
+	for (long r = 0; r < rows; r++) {
+		if (!file.read(reinterpret_cast<char*>(row.data()), row.size() * sizeof(std::uint32_t))) {
+			std::cout << "Error: Coverage map " << path << " is truncated" << std::endl;
+			*this = CoverageMap();
+			return false;
+		}
+		for (long c = 0; c < columns; c++) {
+			if (row[c] == 0)
+				continue;
+			std::vector<std::uint32_t>& tile = tiles[(r >> COVERAGE_TILE_SHIFT) * tileColumns + (c >> COVERAGE_TILE_SHIFT)];
+			if (tile.empty())
+				tile.assign(static_cast<size_t>(tileSize) * tileSize, 0);
+			tile[((r & TILE_MASK) << COVERAGE_TILE_SHIFT) + (c & TILE_MASK)] = row[c];
+		}
+	}
+	return true;
+}
+
+bool mergeCoverage(const std::vector<CoverageMap>& parts, CoverageMap& result, JobSystem& jobs) {
+	std::vector<const CoverageMap*> sources;
+	for (const CoverageMap& part : parts) {
+		if (!part.hasSameGeometry(result)) {
+			std::cout << "Error: Coverage maps of different geometry cannot be merged" << std::endl;
+			return false;
+		}
+		sources.push_back(&part);
+	}
+	size_t tileCount = result.getTileCount();
+	size_t jobCount = std::max<size_t>(1, std::min<size_t>(tileCount, jobs.getWorkerCount() * 4));
+	size_t perJob = (tileCount + jobCount - 1) / jobCount;
+	for (size_t first = 0; first < tileCount; first += perJob) {
+		size_t last = std::min(first + perJob, tileCount);
+		jobs.submit([&result, &sources, first, last]() {
+			result.mergeTiles(sources, first, last);
+		});
+	}
+	jobs.wait();
+	return true;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+
+#define COVERAGE_TILE_SHIFT 6				//64 x 64 cells per tile
+#define COVERAGE_MAX_CELLS 1000000000LL
+#define COVERAGE_MAGIC 0x4D434444			// "DDCM" little endian
+#define COVERAGE_VERSION 1
+
+// Header of the binary export, followed by columns * rows uint32 counts row by row from
+// row 0 (the lower left corner), native endian
+struct CoverageFileHeader {
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::int64_t columns;
+	std::int64_t rows;
+	double resolution;		//[m] per cell
+	double originX;			//[m]
+	double originY;			//[m]
+};
+static_assert(sizeof(CoverageFileHeader) == 48, "CoverageFileHeader layout changed");
+
+// World space grid of visit counts. A visit is a trajectory entering a cell, so a vehicle
+// standing still or crossing a cell in many steps counts once per pass; cells should be
+// larger than the travel of one step. Counts live in 64 x 64 tiles allocated on the first
+// visit, a map only pays for the area trajectories actually cover, which keeps one private
+// map per worker cheap.
+class CoverageMap {
+public:
+	CoverageMap() {
+		columns = 0;
+		rows = 0;
+		tileColumns = 0;
+		resolution = 1;
+		originX = 0;
+		originY = 0;
+	}
+
+	// All counts zero, origin is the lower left corner of the map [m]
+	bool create(long columnCount, long rowCount, double metersPerCell, double x0, double y0);
+
+	bool empty() const {
+		return this->tiles.empty();
+	}
+
+	long getColumns() const {
+		return this->columns;
+	}
+
+	long getRows() const {
+		return this->rows;
+	}
+
+	double getResolution() const {
+		return this->resolution;
+	}
+
+	double getOriginX() const {
+		return this->originX;
+	}
+
+	double getOriginY() const {
+		return this->originY;
+	}
+
+	bool hasSameGeometry(const CoverageMap& other) const {
+		return columns == other.columns && rows == other.rows && resolution == other.resolution && originX == other.originX && originY == other.originY;
+	}
+
+	// Counts the cell under the position unless it is lastCell, the cell of the previous
+	// sample of the same trajectory; lastCell is updated, -1 outside the map
+	void visit(double x, double y, long& lastCell) {
+		double columnF = (x - originX) / resolution;
+		double rowF = (y - originY) / resolution;
+		if (!(columnF >= 0 && rowF >= 0 && columnF < columns && rowF < rows)) {
+			lastCell = -1;
+			return;
+		}
+		long column = static_cast<long>(columnF);
+		long row = static_cast<long>(rowF);
+		long cell = row * columns + column;
+		if (cell == lastCell)
+			return;
+		lastCell = cell;
+		std::vector<std::uint32_t>& tile = tiles[(row >> COVERAGE_TILE_SHIFT) * tileColumns + (column >> COVERAGE_TILE_SHIFT)];
+		if (tile.empty())
+			tile.assign(static_cast<size_t>(1) << (2 * COVERAGE_TILE_SHIFT), 0);
+		tile[((row & TILE_MASK) << COVERAGE_TILE_SHIFT) + (column & TILE_MASK)]++;
+	}
+
+	std::uint32_t getCount(long column, long row) const {
+		if (column < 0 || row < 0 || column >= columns || row >= rows)
+			return 0;
+		const std::vector<std::uint32_t>& tile = tiles[(row >> COVERAGE_TILE_SHIFT) * tileColumns + (column >> COVERAGE_TILE_SHIFT)];
+		return tile.empty() ? 0 : tile[((row & TILE_MASK) << COVERAGE_TILE_SHIFT) + (column & TILE_MASK)];
+	}
+
+	size_t getTileCount() const {
+		return this->tiles.size();
+	}
+
+	bool isTileAllocated(size_t tile) const {
+		return !this->tiles[tile].empty();
+	}
+
+	// First column and row of a tile
+	void getTileOrigin(size_t tile, long& column, long& row) const {
+		column = static_cast<long>(tile % tileColumns) << COVERAGE_TILE_SHIFT;
+		row = static_cast<long>(tile / tileColumns) << COVERAGE_TILE_SHIFT;
+	}
+
+	std::uint32_t getMaxCount() const;
+	std::uint64_t getTotal() const;
+
+	// Allocated tiles only
+	size_t getMemoryBytes() const;
+
+	// Adds the counts of the tiles first..last - 1 of every part, which must all have the
+	// geometry of this map. Jobs merging disjoint tile ranges never touch the same tile.
+	void mergeTiles(const std::vector<const CoverageMap*>& parts, size_t first, size_t last);
+
+	bool saveToFile(const std::string& path) const;
+	bool loadFromFile(const std::string& path);
+
+private:
+	static constexpr long TILE_MASK = (1L << COVERAGE_TILE_SHIFT) - 1;
+
+	std::vector<std::vector<std::uint32_t>> tiles;
+	long columns;
+	long rows;
+	long tileColumns;
+	double resolution;		//[m] per cell
+	double originX;			//[m]
+	double originY;			//[m]
+};
+
+// Sum of per worker maps, merged in parallel by tile ranges
+bool mergeCoverage(const std::vector<CoverageMap>& parts, CoverageMap& result, JobSystem& jobs);
@@ -0,0 +1,120 @@
+#include "DifDriveApi.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "FastMath.h"
+#include "Integration.h"
+#include "Kinematics.h"
+
+#define DD_BATCH_BLOCK 256		// vehicles stepped together by the Euler path
+
+static_assert(sizeof(dd_vehicle_state) == 5 * sizeof(double), "dd_vehicle_state layout changed");
+static_assert(sizeof(dd_wheel_command) == 2 * sizeof(double), "dd_wheel_command layout changed");
+static_assert(DD_INTEGRATION_EXACT_ARC == static_cast<int>(IntegrationMethod::EXACT_ARC), "integration methods out of order");
+
+int dd_get_api_version(void) {
+	return DD_API_VERSION;
+}
+
+int dd_init_states(dd_vehicle_state* states, size_t count) {
+	if (states == nullptr && count > 0)
+		return DD_ERROR_NULL_POINTER;
+
+	for (size_t i = 0; i < count; i++) {
+		states[i] = dd_vehicle_state{ 0, 0, 0, 0, 0 };
+	}
+	return DD_OK;
+}
+
+// Euler needs one sine and cosine per step, blocks of vehicles are stepped together so that
+// fastSinCosBatch evaluates them with SIMD. Same results as the per vehicle loop.
+static void stepEulerBlocks(dd_vehicle_state* states, const dd_wheel_command* commands, size_t count, unsigned int steps, double dt, const RuntimeGeometry& geometry) {
+	double x[DD_BATCH_BLOCK], y[DD_BATCH_BLOCK], phi[DD_BATCH_BLOCK], v[DD_BATCH_BLOCK], omega[DD_BATCH_BLOCK];
+	double sine[DD_BATCH_BLOCK], cosine[DD_BATCH_BLOCK];
+
+	for (size_t first = 0; first < count; first += DD_BATCH_BLOCK) {
+		size_t size = std::min<size_t>(DD_BATCH_BLOCK, count - first);
+		for (size_t j = 0; j < size; j++) {
+			x[j] = states[first + j].x;
+			y[j] = states[first + j].y;
+			phi[j] = states[first + j].phi;
+			getBodyVelocity(geometry, commands[first + j].left, commands[first + j].right, v[j], omega[j]);
+		}
+
+		for (unsigned int step = 0; step < steps; step++) {
+			for (size_t j = 0; j < size; j++) {
+				phi[j] += omega[j] * dt;
+			}
+			fastSinCosBatch(phi, sine, cosine, size);
+			for (size_t j = 0; j < size; j++) {
+				x[j] += v[j] * cosine[j] * dt;
+				y[j] += v[j] * sine[j] * dt;
+			}
+		}
+
+		for (size_t j = 0; j < size; j++) {
+			states[first + j].x = x[j];
+			states[first + j].y = y[j];
+			states[first + j].phi = phi[j];
+			states[first + j].v = v[j];
+			states[first + j].omega = omega[j];
+		}
+	}
+}
+
+// Same order of operations as Vehicle::recalculate, the state stays in registers for
+// all steps of one vehicle before the next one is loaded
+int dd_step_batch(dd_vehicle_state* states, const dd_wheel_command* commands, size_t count, unsigned int steps, const dd_step_params* params) {
+	if (params == nullptr || (count > 0 && (states == nullptr || commands == nullptr)))
+		return DD_ERROR_NULL_POINTER;
+	if (!(params->dt > 0) || !(params->wheelbase > 0) || params->integration < DD_INTEGRATION_EULER || params->integration > DD_INTEGRATION_EXACT_ARC)
+		return DD_ERROR_INVALID_ARGUMENT;
+
+	IntegrationMethod method = static_cast<IntegrationMethod>(params->integration);
+	double dt = params->dt;
+	RuntimeGeometry geometry(params->wheelbase);
+
+	if (method == IntegrationMethod::EULER && steps > 0) {
+		stepEulerBlocks(states, commands, count, steps, dt, geometry);
+		return DD_OK;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		dd_vehicle_state state = states[i];
+		double v, omega, dx, dy;
+		getBodyVelocity(geometry, commands[i].left, commands[i].right, v, omega);
+
+		for (unsigned int step = 0; step < steps; step++) {
+			getStepDisplacement(method, state.phi, v, omega, dt, dx, dy);
+			state.phi += omega * dt;
+			state.x += dx;
+			state.y += dy;
+		}
+		if (steps > 0) {
+			state.v = v;
+			state.omega = omega;
+		}
+		states[i] = state;
+	}
+	return DD_OK;
+}
+
+int dd_get_wheel_positions(const dd_vehicle_state* states, size_t count, double wheelbase, double* left, double* right) {
+	if (count > 0 && (states == nullptr || left == nullptr || right == nullptr))
+		return DD_ERROR_NULL_POINTER;
+	if (!(wheelbase > 0))
+		return DD_ERROR_INVALID_ARGUMENT;
+
+	RuntimeGeometry geometry(wheelbase);
+	for (size_t i = 0; i < count; i++) {
+		double sinPhi, cosPhi;
+		getSinCos(states[i].phi, sinPhi, cosPhi);
+		WheelPositions<double> wheels = computeWheelPositions(geometry, states[i].x, states[i].y, sinPhi, cosPhi);
+		left[2 * i] = wheels.leftX;
+		left[2 * i + 1] = wheels.leftY;
+		right[2 * i] = wheels.rightX;
+		right[2 * i + 1] = wheels.rightY;
+	}
+	return DD_OK;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+/* C interface of the vehicle kinematics for controllers outside this code base.
+ * Plain structs, no C++ types and no allocation inside the library; the caller owns
+ * every array. Layouts only grow at the end and DD_API_VERSION changes with them. */
+
+#include <stddef.h>
+
+#define DD_API_VERSION 1
+
+#ifdef _WIN32
+#if defined(DD_API_BUILD_SHARED)
+#define DD_API __declspec(dllexport)
+#elif defined(DD_API_USE_SHARED)
+#define DD_API __declspec(dllimport)
+#else
+#define DD_API
+#endif
+#else
+#define DD_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Status codes */
+#define DD_OK 0
+#define DD_ERROR_NULL_POINTER -1
+#define DD_ERROR_INVALID_ARGUMENT -2
+
+/* Integration methods, same order as IntegrationMethod */
+#define DD_INTEGRATION_EULER 0
+#define DD_INTEGRATION_MIDPOINT 1
+#define DD_INTEGRATION_RK4 2
+#define DD_INTEGRATION_EXACT_ARC 3
+
+/* Pose of the vehicle center and its speeds from the last step, [m], [rad], [m/s], [rad/s] */
+typedef struct dd_vehicle_state {
+	double x;
+	double y;
+	double phi;
+	double v;
+	double omega;
+} dd_vehicle_state;
+
+/* Tangential wheel speeds [m/s], constant for all steps of one call */
+typedef struct dd_wheel_command {
+	double left;
+	double right;
+} dd_wheel_command;
+
+typedef struct dd_step_params {
+	double dt;				/* [s] */
+	double wheelbase;		/* distance of the wheels [m] */
+	int integration;		/* DD_INTEGRATION_* */
+	int reserved;
+} dd_step_params;
+
+/* Version the library was built with, compare against DD_API_VERSION */
+DD_API int dd_get_api_version(void);
+
+/* Initial pose of a vehicle, the same as a new Vehicle */
+DD_API int dd_init_states(dd_vehicle_state* states, size_t count);
+
+/* Advances count vehicles by steps steps of params->dt, vehicle i driven by commands[i].
+ * Results are identical to Vehicle::recalculate with the same method and time step. */
+DD_API int dd_step_batch(dd_vehicle_state* states, const dd_wheel_command* commands, size_t count, unsigned int steps, const dd_step_params* params);
+
+/* Wheel contact points of count vehicles, written to left and right as x, y pairs */
+DD_API int dd_get_wheel_positions(const dd_vehicle_state* states, size_t count, double wheelbase, double* left, double* right);
+
+#ifdef __cplusplus
+}
+#endif
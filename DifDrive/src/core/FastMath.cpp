@@ -0,0 +1,63 @@
+#include "FastMath.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FAST_SINCOS_SSE2
+#endif
+
+void fastSinCosBatch(const double* x, double* sine, double* cosine, size_t count) {
+	size_t i = 0;
+#ifdef FAST_SINCOS_SSE2
+	using namespace fastmath;
+	const __m128d signMask = _mm_set1_pd(-0.0);
+	const __m128d maxArgument = _mm_set1_pd(FAST_SINCOS_MAX_ARGUMENT);
+	const __m128i one = _mm_set1_epi64x(1);
+	const __m128i two = _mm_set1_epi64x(2);
+
+	for (; i + 2 <= count; i += 2) {
+		__m128d vx = _mm_loadu_pd(x + i);
+		if (_mm_movemask_pd(_mm_cmple_pd(_mm_andnot_pd(signMask, vx), maxArgument)) != 3) {
+			fastSinCos(x[i], sine[i], cosine[i]);
+			fastSinCos(x[i + 1], sine[i + 1], cosine[i + 1]);
+			continue;
+		}
+
+		// Same operations in the same order as fastSinCos
+		__m128d shifted = _mm_add_pd(_mm_mul_pd(vx, _mm_set1_pd(TWO_OVER_PI)), _mm_set1_pd(ROUND_MAGIC));
+		__m128d k = _mm_sub_pd(shifted, _mm_set1_pd(ROUND_MAGIC));
+		__m128i quadrant = _mm_castpd_si128(shifted);
+
+		__m128d r = _mm_sub_pd(vx, _mm_mul_pd(k, _mm_set1_pd(PIO2_1)));
+		r = _mm_sub_pd(r, _mm_mul_pd(k, _mm_set1_pd(PIO2_2)));
+		r = _mm_sub_pd(r, _mm_mul_pd(k, _mm_set1_pd(PIO2_3)));
+		__m128d z = _mm_mul_pd(r, r);
+
+		__m128d ps = _mm_add_pd(_mm_set1_pd(S5), _mm_mul_pd(z, _mm_set1_pd(S6)));
+		ps = _mm_add_pd(_mm_set1_pd(S4), _mm_mul_pd(z, ps));
+		ps = _mm_add_pd(_mm_set1_pd(S3), _mm_mul_pd(z, ps));
+		ps = _mm_add_pd(_mm_set1_pd(S2), _mm_mul_pd(z, ps));
+		ps = _mm_add_pd(_mm_set1_pd(S1), _mm_mul_pd(z, ps));
+		__m128d s = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, z), ps));
+
+		__m128d pc = _mm_add_pd(_mm_set1_pd(C5), _mm_mul_pd(z, _mm_set1_pd(C6)));
+		pc = _mm_add_pd(_mm_set1_pd(C4), _mm_mul_pd(z, pc));
+		pc = _mm_add_pd(_mm_set1_pd(C3), _mm_mul_pd(z, pc));
+		pc = _mm_add_pd(_mm_set1_pd(C2), _mm_mul_pd(z, pc));
+		pc = _mm_add_pd(_mm_set1_pd(C1), _mm_mul_pd(z, pc));
+		__m128d c = _mm_add_pd(_mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(_mm_set1_pd(0.5), z)), _mm_mul_pd(_mm_mul_pd(z, z), pc));
+
+		// Odd quadrants swap sine and cosine, the signs follow bit 1 of q and of q + 1
+		__m128d swap = _mm_castsi128_pd(_mm_sub_epi64(_mm_setzero_si128(), _mm_and_si128(quadrant, one)));
+		__m128d sineSign = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(quadrant, two), 62));
+		__m128d cosineSign = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(_mm_add_epi64(quadrant, one), two), 62));
+
+		__m128d resultSine = _mm_or_pd(_mm_and_pd(swap, c), _mm_andnot_pd(swap, s));
+		__m128d resultCosine = _mm_or_pd(_mm_and_pd(swap, s), _mm_andnot_pd(swap, c));
+		_mm_storeu_pd(sine + i, _mm_xor_pd(resultSine, sineSign));
+		_mm_storeu_pd(cosine + i, _mm_xor_pd(resultCosine, cosineSign));
+	}
+#endif
+	for (; i < count; i++) {
+		fastSinCos(x[i], sine[i], cosine[i]);
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Polynomial sine and cosine for the kinematics. The argument is reduced to |r| <= pi/4
+// with a three part pi/2 (Cody-Waite, exact for |x| below FAST_SINCOS_MAX_ARGUMENT),
+// then the fdlibm minimax polynomials of degree 13 (sin) and 14 (cos) are evaluated.
+// Measured by --bench-sincos the error against long double stays below 2.0e-16 absolute
+// (libm: 5.6e-17), at most two ulp of results near one. Larger arguments fall back to
+// std::sin / std::cos.
+#define FAST_SINCOS_MAX_ARGUMENT 823549.6		//2^19 * pi/2 [rad]
+
+namespace fastmath {
+	constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+	constexpr double ROUND_MAGIC = 6755399441055744.0;		// 1.5 * 2^52, rounds to integer when added
+	constexpr double PIO2_1 = 1.57079632673412561417e+00;	// first 33 bits of pi/2
+	constexpr double PIO2_2 = 6.07710050630396597660e-11;	// next 33 bits
+	constexpr double PIO2_3 = 2.02226624871116645580e-21;	// next 33 bits
+
+	constexpr double S1 = -1.66666666666666324348e-01;
+	constexpr double S2 = 8.33333333332248946124e-03;
+	constexpr double S3 = -1.98412698298579493134e-04;
+	constexpr double S4 = 2.75573137070700676789e-06;
+	constexpr double S5 = -2.50507602534068634195e-08;
+	constexpr double S6 = 1.58969099521155010221e-10;
+
+	constexpr double C1 = 4.16666666666666019037e-02;
+	constexpr double C2 = -1.38888888888741095749e-03;
+	constexpr double C3 = 2.48015872894767294178e-05;
+	constexpr double C4 = -2.75573143513906633035e-07;
+	constexpr double C5 = 2.08757232129817482790e-09;
+	constexpr double C6 = -1.13596475577881948265e-11;
+}
+
+// Scalar version, gives exactly the same results as fastSinCosBatch
+inline void fastSinCos(double x, double& sine, double& cosine) {
+	using namespace fastmath;
+	if (!(std::fabs(x) <= FAST_SINCOS_MAX_ARGUMENT)) {
+		sine = std::sin(x);
+		cosine = std::cos(x);
+		return;
+	}
+
+	double shifted = x * TWO_OVER_PI + ROUND_MAGIC;
+	double k = shifted - ROUND_MAGIC;
+	std::int64_t bits;
+	std::memcpy(&bits, &shifted, sizeof(bits));
+	int quadrant = static_cast<int>(bits & 3);
+
+	double r = ((x - k * PIO2_1) - k * PIO2_2) - k * PIO2_3;
+	double z = r * r;
+	double s = r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+	double c = (1.0 - 0.5 * z) + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+
+	switch (quadrant) {
+	case 0:
+		sine = s;
+		cosine = c;
+		break;
+	case 1:
+		sine = c;
+		cosine = -s;
+		break;
+	case 2:
+		sine = -s;
+		cosine = -c;
+		break;
+	default:
+		sine = -c;
+		cosine = s;
+		break;
+	}
+}
+
+// count sines and cosines at once, two per SSE2 instruction where available
+void fastSinCosBatch(const double* x, double* sine, double* cosine, size_t count);
@@ -0,0 +1,23 @@
+#include "FileHandler.h"
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+void FileHandler::createNewFile(const std::string& suffix) {
+	currentFileStream.close();
+
+	auto now = std::chrono::system_clock::now(); // Get the current time
+	auto now_c = std::chrono::system_clock::to_time_t(now); // Convert to time_t
+	std::stringstream filename_ss;
+	std::tm timeinfo;
+#ifdef _WIN32
+	localtime_s(&timeinfo, &now_c); // Convert time_t to tm structure
+#else
+	localtime_r(&now_c, &timeinfo);
+#endif
+	filename_ss << std::put_time(&timeinfo, "%Y_%m_%d__%H_%M_%S"); // Format the time
+
+	openFile("logData/" + filename_ss.str() + suffix + ".csv");
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+#include "Vehicle.h"
+
+// CSV log of the vehicle state, one row per physics step
+class FileHandler {
+public:
+	// No file is open until createNewFile()
+	FileHandler() {
+		std::filesystem::create_directory("logData");
+	}
+
+	// Log with given name (without extension) in logData, used by headless runs
+	// where several logs are created in the same second
+	FileHandler(const std::string& name) {
+		std::filesystem::create_directory("logData");
+		openFile("logData/" + name + ".csv");
+	}
+
+	// Log with its own columns instead of the vehicle state, e.g. odometry traces
+	FileHandler(const std::string& name, const std::vector<std::string>& header) {
+		std::filesystem::create_directory("logData");
+		openFile("logData/" + name + ".csv", header);
+	}
+
+	// Rows end with '\n' instead of std::endl, flushing every row costs a syscall per step
+	void writeToFile(const std::vector<double>& data) {
+		if (currentFileStream.is_open()) {
+			for (int i = 0; i < data.size(); i++) {
+				currentFileStream << data[i] << ";";
+			}
+			currentFileStream << '\n';
+		}
+		else {
+			std::cout << "Error: File not open for writing" << std::endl;
+		}
+	}
+
+	void writeToFile(const std::vector<std::string>& data) {
+		if (currentFileStream.is_open()) {
+			for (int i = 0; i < data.size(); i++) {
+				currentFileStream << data[i] << ";";
+			}
+			currentFileStream << '\n';
+		}
+		else {
+			std::cout << "Error: File not open for writing" << std::endl;
+		}
+	}
+
+	void writeVehicleState(double time, long step, Vehicle& vehicle) {
+		WheelPositions<double> wheels = vehicle.getWheelPositions();
+		this->writeToFile(std::vector<double>{
+			time,								/*time*/
+			(double)step,						/*steps*/
+			vehicle.getTangencialVel(),			/*vehicle vT*/
+			vehicle.getAngularVel(),			/*vehicle omegaT*/
+			vehicle.getX(),						/*vehicle x*/
+			vehicle.getY(),						/*vehicle y*/
+			vehicle.getPhi(),					/*vehicle phi*/
+			vehicle.lWheel.getTangencialVel(),	/*L wheel vT*/
+			vehicle.lWheel.getAngularVel(),		/*L wheel omega*/
+			wheels.leftX,						/*L wheel x*/
+			wheels.leftY,						/*L wheel y*/
+			vehicle.rWheel.getTangencialVel(),	/*R wheel vT*/
+			vehicle.rWheel.getAngularVel(),		/*R wheel omega*/
+			wheels.rightX,						/*R wheel x*/
+			wheels.rightY});					/*R wheel y*/
+	}
+
+	void flush() {
+		currentFileStream.flush();
+	}
+
+	// Log named by the current time followed by suffix, e.g. "-FIX_DELTA-SIMULATION-CURVE"
+	void createNewFile(const std::string& suffix);
+
+private:
+	std::string filename;
+	std::ofstream currentFileStream;
+
+	void openFile(const std::string& path, const std::vector<std::string>& header = {}) {
+		currentFileStream.close();
+		filename = path;
+
+		// Open the file for writing
+		currentFileStream.open(filename, std::ios::out);
+		if (!currentFileStream.is_open()) {
+			std::cout << "Error: Could not open file for writing" << std::endl;
+			return;
+		}
+
+		if (!header.empty()) {
+			this->writeToFile(header);
+		}
+		else {
+			this->writeToFile(std::vector<std::string>{ "t[s]", "step","vT[m/s]","omegaT[rad/s]","xT[m]", "yT[m]", "phiT[rad]",
+														"vL[m/s]", "omegaL[rad/s]", "xL[m]", "yL[m]",
+														"vR[m/s]", "omegaR[rad/s]", "xR[m]", "yR[m]" });
+		}
+	}
+};
@@ -0,0 +1,34 @@
+#include "Integration.h"
+
+#include <cmath>
+
+#include "Constants.h"
+
+const char* getIntegrationMethodName(IntegrationMethod method) {
+	switch (method) {
+	case IntegrationMethod::MIDPOINT:
+		return "midpoint";
+	case IntegrationMethod::RK4:
+		return "rk4";
+	case IntegrationMethod::EXACT_ARC:
+		return "exact_arc";
+	default:
+		return "euler";
+	}
+}
+
+void integrateArc(long double& x, long double& y, long double& phi, long double v, long double omega, long double duration) {
+	if (fabsl(omega) > 1e-12L) {
+		x += v / omega * (sinl(phi + omega * duration) - sinl(phi));
+		y -= v / omega * (cosl(phi + omega * duration) - cosl(phi));
+	}
+	else {
+		x += v * cosl(phi) * duration;
+		y += v * sinl(phi) * duration;
+	}
+	phi += omega * duration;
+}
+
+double getHeadingError(double phi, double reference) {
+	return fabs(remainder(phi - reference, 2 * M_PI));
+}
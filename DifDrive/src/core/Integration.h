@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cmath>
+
+#include "FastMath.h"
+
+// Pose update of one step, wheel speeds are constant during the step
+enum class IntegrationMethod {
+	EULER,		// heading first, then position along the new heading
+	MIDPOINT,	// position along the heading in the middle of the step
+	RK4,		// Simpson rule over the heading change of the step
+	EXACT_ARC	// closed form circular arc
+};
+
+const char* getIntegrationMethodName(IntegrationMethod method);
+
+// Advances a pose along a constant speed segment as exact arc, in long double
+void integrateArc(long double& x, long double& y, long double& phi, long double v, long double omega, long double duration);
+
+// Heading difference wrapped to <-pi, pi>
+double getHeadingError(double phi, double reference);
+
+// Sine and cosine of a heading, double uses the polynomial kernel of FastMath.h, the other
+// precisions keep libm
+template <typename Real>
+inline void getSinCos(Real phi, Real& sine, Real& cosine) {
+	sine = std::sin(phi);
+	cosine = std::cos(phi);
+}
+
+template <>
+inline void getSinCos<double>(double phi, double& sine, double& cosine) {
+	fastSinCos(phi, sine, cosine);
+}
+
+// Position change of one step with constant v and omega, the heading goes from phi to
+// phi + omega * dt. Shared by Vehicle and the batch C API so both give the same results,
+// Real is the precision of the vehicle state.
+template <typename Real>
+inline void getStepDisplacement(IntegrationMethod method, Real phi, Real v, Real omega, Real dt, Real& dx, Real& dy) {
+	Real phiEnd = phi + omega * dt;
+	Real sinEnd, cosEnd;
+
+	switch (method) {
+	case IntegrationMethod::MIDPOINT: {
+		Real phiMid = phi + omega * dt * Real(0.5);
+		Real sinMid, cosMid;
+		getSinCos(phiMid, sinMid, cosMid);
+		dx = v * cosMid * dt;
+		dy = v * sinMid * dt;
+		break;
+	}
+	case IntegrationMethod::RK4: {
+		Real phiMid = phi + omega * dt * Real(0.5);
+		Real sinStart, cosStart, sinMid, cosMid;
+		getSinCos(phi, sinStart, cosStart);
+		getSinCos(phiMid, sinMid, cosMid);
+		getSinCos(phiEnd, sinEnd, cosEnd);
+		dx = v * dt / Real(6) * (cosStart + 4 * cosMid + cosEnd);
+		dy = v * dt / Real(6) * (sinStart + 4 * sinMid + sinEnd);
+		break;
+	}
+	case IntegrationMethod::EXACT_ARC: {
+		Real sinStart, cosStart;
+		getSinCos(phi, sinStart, cosStart);
+		if (std::fabs(omega) > Real(1e-9)) {
+			getSinCos(phiEnd, sinEnd, cosEnd);
+			dx = v / omega * (sinEnd - sinStart);
+			dy = -v / omega * (cosEnd - cosStart);
+		}
+		else {
+			dx = v * cosStart * dt;
+			dy = v * sinStart * dt;
+		}
+		break;
+	}
+	default: {
+		getSinCos(phiEnd, sinEnd, cosEnd);
+		Real vX = v * cosEnd;
+		Real vY = v * sinEnd;
+		dx = vX * dt;
+		dy = vY * dt;
+		break;
+	}
+	}
+}
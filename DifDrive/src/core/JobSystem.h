@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work stealing job system. Every worker owns a deque guarded by its own lock, takes
+// jobs from its front and, when it runs dry, steals from the back of the other deques.
+// The shared sleep lock is touched only by idle workers and by submit() when some
+// worker sleeps, so busy workers never contend on a global lock.
+class JobSystem {
+public:
+	JobSystem(unsigned int workerCount) {
+		if (workerCount == 0)
+			workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+		running = true;
+		queuedJobs = 0;
+		pendingJobs = 0;
+		sleepingWorkers = 0;
+		nextQueue = 0;
+
+		for (unsigned int i = 0; i < workerCount; i++) {
+			queues.push_back(std::make_unique<WorkerQueue>());
+		}
+		for (unsigned int i = 0; i < workerCount; i++) {
+			workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+		}
+	}
+
+	~JobSystem() {
+		wait();
+		{
+			std::lock_guard<std::mutex> lock(sleepLock);
+			running = false;
+		}
+		wakeUp.notify_all();
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Jobs submitted from a worker go to its own deque, others are spread round robin
+	void submit(std::function<void()> job) {
+		pendingJobs++;
+		size_t index = (currentSystem == this) ? currentWorker : (nextQueue++ % queues.size());
+		{
+			std::lock_guard<std::mutex> lock(queues[index]->lock);
+			queues[index]->jobs.push_back(std::move(job));
+		}
+		queuedJobs++;
+
+		if (sleepingWorkers > 0) {
+			{
+				std::lock_guard<std::mutex> lock(sleepLock);
+			}
+			wakeUp.notify_one();
+		}
+	}
+
+	// Blocks until every submitted job has finished
+	void wait() {
+		std::unique_lock<std::mutex> lock(doneLock);
+		allDone.wait(lock, [this] { return pendingJobs == 0; });
+	}
+
+	unsigned int getWorkerCount() {
+		return static_cast<unsigned int>(this->workers.size());
+	}
+
+private:
+	struct WorkerQueue {
+		std::mutex lock;
+		std::deque<std::function<void()>> jobs;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<std::thread> workers;
+
+	std::atomic<bool> running;
+	std::atomic<long> queuedJobs;
+	std::atomic<long> pendingJobs;
+	std::atomic<int> sleepingWorkers;
+	std::atomic<size_t> nextQueue;
+
+	std::mutex sleepLock;
+	std::condition_variable wakeUp;
+	std::mutex doneLock;
+	std::condition_variable allDone;
+
+	static inline thread_local JobSystem* currentSystem = nullptr;
+	static inline thread_local size_t currentWorker = 0;
+
+	bool takeJob(size_t index, std::function<void()>& job) {
+		{
+			WorkerQueue& own = *queues[index];
+			std::lock_guard<std::mutex> lock(own.lock);
+			if (!own.jobs.empty()) {
+				job = std::move(own.jobs.front());
+				own.jobs.pop_front();
+				queuedJobs--;
+				return true;
+			}
+		}
+		for (size_t i = 1; i < queues.size(); i++) {
+			WorkerQueue& victim = *queues[(index + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.lock);
+			if (!victim.jobs.empty()) {
+				job = std::move(victim.jobs.back());
+				victim.jobs.pop_back();
+				queuedJobs--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void workerLoop(size_t index) {
+		currentSystem = this;
+		currentWorker = index;
+
+		std::function<void()> job;
+		while (true) {
+			if (takeJob(index, job)) {
+				try {
+					job();
+				}
+				catch (const std::exception& e) {
+					std::cout << "Error: Job failed: " << e.what() << std::endl;
+				}
+				job = nullptr;
+
+				if (--pendingJobs == 0) {
+					std::lock_guard<std::mutex> lock(doneLock);
+					allDone.notify_all();
+				}
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepLock);
+			sleepingWorkers++;
+			wakeUp.wait(lock, [this] { return !running || queuedJobs > 0; });
+			sleepingWorkers--;
+			if (!running && queuedJobs == 0)
+				return;
+		}
+	}
+};
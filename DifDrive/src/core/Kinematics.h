@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cmath>
+
+#include "Constants.h"
+#include "Snapshot.h"
+
+// Geometry policies of a differential drive. Both offer the same accessors, so the
+// kinematics below and BasicWheel / BasicVehicle are written once for either of them.
+
+// Dimensions of a fixed fleet build, FixedGeometry<DefaultDimensions> is the default robot
+struct DefaultDimensions {
+	static constexpr double wheelbase = DEFAULT_WHEELBASE;
+	static constexpr double wheelRadius = DEFAULT_WHEEL_RADIUS;
+};
+
+// Geometry known at compile time, l/2, 1/l and 1/r fold into constants
+template <typename Dimensions>
+class FixedGeometry {
+public:
+	static_assert(Dimensions::wheelbase > 0 && Dimensions::wheelRadius > 0, "vehicle dimensions must be positive");
+
+	static constexpr double getWheelbase() {
+		return Dimensions::wheelbase;
+	}
+
+	static constexpr double getHalfWheelbase() {
+		return Dimensions::wheelbase / 2;
+	}
+
+	static constexpr double getInverseWheelbase() {
+		return 1 / Dimensions::wheelbase;
+	}
+
+	static constexpr double getWheelRadius() {
+		return Dimensions::wheelRadius;
+	}
+
+	static constexpr double getInverseWheelRadius() {
+		return 1 / Dimensions::wheelRadius;
+	}
+
+	void saveState(SnapshotWriter& writer) const {
+		writer.write(getWheelbase());
+		writer.write(getWheelRadius());
+	}
+
+	// A snapshot only restores into a build with the same dimensions
+	bool loadState(SnapshotReader& reader) {
+		double wheelbase = 0, wheelRadius = 0;
+		return reader.read(wheelbase) && reader.read(wheelRadius) && wheelbase == getWheelbase() && wheelRadius == getWheelRadius();
+	}
+};
+
+// Geometry chosen at run time, e.g. for sweeps over robot sizes. The derived values are
+// computed once, so the kinematics only multiply like with FixedGeometry.
+class RuntimeGeometry {
+public:
+	RuntimeGeometry() {
+		setDimensions(DEFAULT_WHEELBASE, DEFAULT_WHEEL_RADIUS);
+	}
+
+	explicit RuntimeGeometry(double wheelbase, double wheelRadius = DEFAULT_WHEEL_RADIUS) {
+		setDimensions(wheelbase, wheelRadius);
+	}
+
+	void setDimensions(double wheelbase, double wheelRadius) {
+		this->wheelbase = wheelbase;
+		this->halfWheelbase = wheelbase / 2;
+		this->inverseWheelbase = 1 / wheelbase;
+		this->wheelRadius = wheelRadius;
+		this->inverseWheelRadius = 1 / wheelRadius;
+	}
+
+	double getWheelbase() const {
+		return this->wheelbase;
+	}
+
+	double getHalfWheelbase() const {
+		return this->halfWheelbase;
+	}
+
+	double getInverseWheelbase() const {
+		return this->inverseWheelbase;
+	}
+
+	double getWheelRadius() const {
+		return this->wheelRadius;
+	}
+
+	double getInverseWheelRadius() const {
+		return this->inverseWheelRadius;
+	}
+
+	void saveState(SnapshotWriter& writer) const {
+		writer.write(wheelbase);
+		writer.write(wheelRadius);
+	}
+
+	bool loadState(SnapshotReader& reader) {
+		double savedWheelbase = 0, savedRadius = 0;
+		if (!reader.read(savedWheelbase) || !reader.read(savedRadius) || !(savedWheelbase > 0) || !(savedRadius > 0))
+			return false;
+		setDimensions(savedWheelbase, savedRadius);
+		return true;
+	}
+
+private:
+	double wheelbase;
+	double halfWheelbase;
+	double inverseWheelbase;
+	double wheelRadius;
+	double inverseWheelRadius;
+};
+
+// Kinematics below compute in Real, the precision of the vehicle state; the geometry is
+// rounded to it once.
+
+// Body speeds from the tangential wheel speeds
+template <typename Geometry, typename Real>
+inline void getBodyVelocity(const Geometry& geometry, Real vLeft, Real vRight, Real& v, Real& omega) {
+	v = (vRight + vLeft) * Real(0.5);
+	omega = (vRight - vLeft) * static_cast<Real>(geometry.getInverseWheelbase());
+}
+
+// Tangential wheel speeds for requested body speeds
+template <typename Geometry, typename Real>
+inline void getWheelVelocities(const Geometry& geometry, Real v, Real omega, Real& vLeft, Real& vRight) {
+	vLeft = v - static_cast<Real>(geometry.getHalfWheelbase()) * omega;
+	vRight = v + static_cast<Real>(geometry.getHalfWheelbase()) * omega;
+}
+
+// Contact point of a wheel mounted at angle offset from the heading
+template <typename Geometry, typename Real>
+inline void getWheelPosition(const Geometry& geometry, Real x, Real y, Real phi, Real offset, Real& wheelX, Real& wheelY) {
+	wheelX = x + static_cast<Real>(geometry.getHalfWheelbase()) * std::cos(phi + offset);
+	wheelY = y + static_cast<Real>(geometry.getHalfWheelbase()) * std::sin(phi + offset);
+}
+
+// World positions of both wheel contact points
+template <typename Real>
+struct WheelPositions {
+	Real leftX;
+	Real leftY;
+	Real rightX;
+	Real rightY;
+};
+
+// Contact points of both wheels from the sine and cosine of the heading, the left wheel is
+// mounted at -pi/2 and the right one at +pi/2, so the offsets are a rotation without libm calls
+template <typename Geometry, typename Real>
+inline WheelPositions<Real> computeWheelPositions(const Geometry& geometry, Real x, Real y, Real sinPhi, Real cosPhi) {
+	Real halfWheelbase = static_cast<Real>(geometry.getHalfWheelbase());
+	return WheelPositions<Real>{ x + halfWheelbase * sinPhi, y - halfWheelbase * cosPhi, x - halfWheelbase * sinPhi, y + halfWheelbase * cosPhi };
+}
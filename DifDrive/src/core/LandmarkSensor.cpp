@@ -0,0 +1,79 @@
+#include "LandmarkSensor.h"
+
+#include <cmath>
+
+LandmarkMap::LandmarkMap(const std::vector<Landmark>& landmarkList, double cellSizeMeters) {
+	cellSize = (cellSizeMeters > 0) ? cellSizeMeters : 1;
+	minX = 0;
+	minY = 0;
+	columns = 0;
+	rows = 0;
+	if (landmarkList.empty())
+		return;
+
+	double maxX = landmarkList[0].x, maxY = landmarkList[0].y;
+	minX = maxX;
+	minY = maxY;
+	for (const Landmark& landmark : landmarkList) {
+		minX = std::min(minX, landmark.x);
+		minY = std::min(minY, landmark.y);
+		maxX = std::max(maxX, landmark.x);
+		maxY = std::max(maxY, landmark.y);
+	}
+	columns = static_cast<long>(std::floor((maxX - minX) / cellSize)) + 1;
+	rows = static_cast<long>(std::floor((maxY - minY) / cellSize)) + 1;
+
+	// Counting sort by cell, stable so landmarks keep their order within a cell
+	std::vector<long> cellOf(landmarkList.size());
+	cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+	for (size_t i = 0; i < landmarkList.size(); i++) {
+		long column = std::min(static_cast<long>(std::floor((landmarkList[i].x - minX) / cellSize)), columns - 1);
+		long row = std::min(static_cast<long>(std::floor((landmarkList[i].y - minY) / cellSize)), rows - 1);
+		cellOf[i] = row * columns + column;
+		cellStart[cellOf[i] + 1]++;
+	}
+	for (size_t cell = 1; cell < cellStart.size(); cell++) {
+		cellStart[cell] += cellStart[cell - 1];
+	}
+	landmarks.resize(landmarkList.size());
+	std::vector<long> next(cellStart.begin(), cellStart.end() - 1);
+	for (size_t i = 0; i < landmarkList.size(); i++) {
+		landmarks[next[cellOf[i]]++] = landmarkList[i];
+	}
+}
+
+void LandmarkSensor::observe(double x, double y, double phi, const OccupancyGrid* world, std::vector<LandmarkObservation>& observations) {
+	observations.clear();
+	double rangeSquared = settings.maxRange * settings.maxRange;
+	const std::vector<Landmark>& list = landmarks->getLandmarks();
+	landmarks->forEachNear(x, y, settings.maxRange, [&](long i) {
+		double dx = list[i].x - x;
+		double dy = list[i].y - y;
+		double squared = dx * dx + dy * dy;
+		if (squared > rangeSquared || squared == 0)
+			return;
+		double range = std::sqrt(squared);
+		if (world && world->castRay(x, y, dx / range, dy / range, range) < range)
+			return;
+
+		LandmarkObservation observation;
+		observation.landmark = i;
+		observation.range = range + random.gaussian() * settings.rangeNoise;
+		observation.bearing = std::remainder(std::atan2(dy, dx) - phi + random.gaussian() * settings.bearingNoise, 2 * M_PI);
+		observations.push_back(observation);
+	});
+}
+
+std::vector<Landmark> makeLandmarkGrid(double minX, double minY, double maxX, double maxY, double spacing, const OccupancyGrid* world) {
+	std::vector<Landmark> landmarks;
+	if (!(spacing > 0))
+		return landmarks;
+	for (double y = minY; y <= maxY; y += spacing) {
+		for (double x = minX; x <= maxX; x += spacing) {
+			if (world && world->collidesCircle(x, y, world->getResolution() * 1.5))
+				continue;
+			landmarks.push_back({ x, y });
+		}
+	}
+	return landmarks;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Constants.h"
+#include "OccupancyGrid.h"
+#include "Random.h"
+
+#define LANDMARK_DEFAULT_SPACING 3.0		//[m]
+#define LANDMARK_DEFAULT_RANGE 5.0			//[m]
+#define LANDMARK_DEFAULT_RANGE_NOISE 0.02	//[m]
+#define LANDMARK_DEFAULT_BEARING_NOISE 0.01	//[rad]
+#define LANDMARK_DEFAULT_RATE 10.0			//[Hz]
+#define LANDMARK_DEADLINE_TOLERANCE 0.01	//of the period, step times do not land exactly on the rate grid
+
+struct Landmark {
+	double x;	//[m]
+	double y;	//[m]
+};
+
+// Landmarks sorted into square cells (compressed rows: the landmarks of cell i are
+// cellStart[i]..cellStart[i + 1] - 1), a query visits only the cells around the position
+// however large the map is
+class LandmarkMap {
+public:
+	LandmarkMap() {
+		minX = 0;
+		minY = 0;
+		cellSize = 1;
+		columns = 0;
+		rows = 0;
+	}
+
+	// Cell size is usually the sensor range, a query then reads 3 x 3 cells
+	LandmarkMap(const std::vector<Landmark>& landmarkList, double cellSizeMeters);
+
+	const std::vector<Landmark>& getLandmarks() const {
+		return this->landmarks;
+	}
+
+	size_t size() const {
+		return this->landmarks.size();
+	}
+
+	// Calls visit(index) for every landmark in the cells overlapping the square of half
+	// size radius around the position, the caller checks the exact distance
+	template <typename Visit>
+	void forEachNear(double x, double y, double radius, Visit visit) const {
+		if (landmarks.empty())
+			return;
+		long firstColumn = std::max(static_cast<long>(std::floor((x - radius - minX) / cellSize)), 0L);
+		long lastColumn = std::min(static_cast<long>(std::floor((x + radius - minX) / cellSize)), columns - 1);
+		long firstRow = std::max(static_cast<long>(std::floor((y - radius - minY) / cellSize)), 0L);
+		long lastRow = std::min(static_cast<long>(std::floor((y + radius - minY) / cellSize)), rows - 1);
+		for (long row = firstRow; row <= lastRow; row++) {
+			for (long column = firstColumn; column <= lastColumn; column++) {
+				long cell = row * columns + column;
+				for (long i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+					visit(i);
+				}
+			}
+		}
+	}
+
+private:
+	std::vector<Landmark> landmarks;
+	std::vector<long> cellStart;
+	double minX;		//[m] lower left corner of cell 0
+	double minY;		//[m]
+	double cellSize;	//[m]
+	long columns;
+	long rows;
+};
+
+struct LandmarkObservation {
+	long landmark;		// index in LandmarkMap::getLandmarks()
+	double range;		//[m]
+	double bearing;		//[rad] relative to the heading
+};
+
+struct LandmarkSensorSettings {
+	double maxRange = LANDMARK_DEFAULT_RANGE;
+	double rangeNoise = LANDMARK_DEFAULT_RANGE_NOISE;		// standard deviation
+	double bearingNoise = LANDMARK_DEFAULT_BEARING_NOISE;	// standard deviation
+	double rate = LANDMARK_DEFAULT_RATE;					//[Hz] of simulation time
+};
+
+// Range and bearing sensor for point landmarks at known positions, measured from the true
+// pose with gaussian noise. With a world map only landmarks in line of sight are seen.
+// The landmark map is shared, e.g. by a whole fleet, and must outlive the sensor.
+class LandmarkSensor {
+public:
+	LandmarkSensor(const LandmarkMap* landmarkMap, const LandmarkSensorSettings& sensorSettings = LandmarkSensorSettings(),
+		std::uint64_t seed = 0, std::uint64_t stream = 0)
+		: random(seed, stream) {
+		landmarks = landmarkMap;
+		settings = sensorSettings;
+		nextObservationTime = -std::numeric_limits<double>::infinity();
+	}
+
+	const LandmarkSensorSettings& getSettings() const {
+		return this->settings;
+	}
+
+	const LandmarkMap& getLandmarks() const {
+		return *this->landmarks;
+	}
+
+	// Replaces the content of observations with the landmarks seen from the pose
+	void observe(double x, double y, double phi, const OccupancyGrid* world, std::vector<LandmarkObservation>& observations);
+
+	// True once per period of the rate, time in [s] of simulation time. Deadlines stay on the
+	// rate grid like the lidar scans
+	bool isObservationDue(double time) {
+		if (settings.rate <= 0)
+			return true;
+		double period = 1 / settings.rate;
+		if (time < nextObservationTime - period * LANDMARK_DEADLINE_TOLERANCE)
+			return false;
+		nextObservationTime += period;
+		if (nextObservationTime <= time - period)
+			nextObservationTime = time + period;
+		return true;
+	}
+
+	void resetSchedule() {
+		this->nextObservationTime = -std::numeric_limits<double>::infinity();
+	}
+
+private:
+	const LandmarkMap* landmarks;
+	LandmarkSensorSettings settings;
+	RandomStream random;
+	double nextObservationTime;
+};
+
+// Landmarks on a square grid covering the rectangle; with a world map only the ones at least
+// a cell away from obstacles (landmarks are mounted in free space, e.g. on poles)
+std::vector<Landmark> makeLandmarkGrid(double minX, double minY, double maxX, double maxY, double spacing, const OccupancyGrid* world = nullptr);
@@ -0,0 +1,59 @@
+#include "Lidar.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "FastMath.h"
+
+Lidar::Lidar(const LidarSettings& lidarSettings) {
+	settings = lidarSettings;
+	settings.beams = std::max(1L, settings.beams);
+	bool fullCircle = settings.fieldOfView >= 2 * M_PI;
+	angleMin = -settings.fieldOfView / 2;
+	// A full circle has no duplicate beam at its end
+	angleIncrement = (fullCircle || settings.beams == 1) ? settings.fieldOfView / settings.beams : settings.fieldOfView / (settings.beams - 1);
+	nextScanTime = -std::numeric_limits<double>::infinity();
+
+	std::vector<double> angles(settings.beams);
+	for (long i = 0; i < settings.beams; i++) {
+		angles[i] = angleMin + i * angleIncrement;
+	}
+	beamSin.resize(settings.beams);
+	beamCos.resize(settings.beams);
+	fastSinCosBatch(angles.data(), beamSin.data(), beamCos.data(), angles.size());
+}
+
+void Lidar::scanBeams(const OccupancyGrid& world, double x, double y, double phi, long first, long count, float* ranges) const {
+	double sinPhi, cosPhi;
+	fastSinCos(phi, sinPhi, cosPhi);
+
+	// Beam directions rotated by the heading a chunk at a time, a loop the compiler vectorizes
+	double dirX[LIDAR_BEAMS_PER_JOB], dirY[LIDAR_BEAMS_PER_JOB];
+	for (long chunk = 0; chunk < count; chunk += LIDAR_BEAMS_PER_JOB) {
+		long chunkSize = std::min(static_cast<long>(LIDAR_BEAMS_PER_JOB), count - chunk);
+		const double* s = beamSin.data() + first + chunk;
+		const double* c = beamCos.data() + first + chunk;
+		for (long i = 0; i < chunkSize; i++) {
+			dirX[i] = cosPhi * c[i] - sinPhi * s[i];
+			dirY[i] = sinPhi * c[i] + cosPhi * s[i];
+		}
+		for (long i = 0; i < chunkSize; i++) {
+			ranges[chunk + i] = static_cast<float>(world.castRay(x, y, dirX[i], dirY[i], settings.maxRange));
+		}
+	}
+}
+
+void scanFleet(const Lidar& lidar, const OccupancyGrid& world, const double* x, const double* y, const double* phi,
+	size_t poseCount, float* ranges, JobSystem& jobs) {
+	long beams = lidar.getSettings().beams;
+	for (size_t pose = 0; pose < poseCount; pose++) {
+		for (long first = 0; first < beams; first += LIDAR_BEAMS_PER_JOB) {
+			long count = std::min(static_cast<long>(LIDAR_BEAMS_PER_JOB), beams - first);
+			float* target = ranges + pose * beams + first;
+			jobs.submit([&lidar, &world, target, first, count, px = x[pose], py = y[pose], pphi = phi[pose]]() {
+				lidar.scanBeams(world, px, py, pphi, first, count, target);
+			});
+		}
+	}
+	jobs.wait();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "Constants.h"
+#include "JobSystem.h"
+#include "OccupancyGrid.h"
+
+#define LIDAR_DEFAULT_BEAMS 1080
+#define LIDAR_DEFAULT_RANGE 10.0		//[m]
+#define LIDAR_DEFAULT_RATE 20.0			//[Hz]
+#define LIDAR_BEAMS_PER_JOB 256
+#define LIDAR_DEADLINE_TOLERANCE 0.01	//of the period, step times do not land exactly on the rate grid
+
+struct LidarSettings {
+	long beams = LIDAR_DEFAULT_BEAMS;
+	double fieldOfView = 2 * M_PI;		//[rad] centered on the heading
+	double maxRange = LIDAR_DEFAULT_RANGE;	//[m]
+	double rate = LIDAR_DEFAULT_RATE;	//[Hz] of simulation time
+};
+
+// 2D scanner at the vehicle center casting its beams into an occupancy grid. Beam angles
+// are fixed relative to the heading, their sines and cosines are computed once and only
+// rotated by the heading per scan.
+class Lidar {
+public:
+	Lidar(const LidarSettings& lidarSettings = LidarSettings());
+
+	const LidarSettings& getSettings() const {
+		return this->settings;
+	}
+
+	// Angle of beam 0 relative to the heading [rad]
+	double getAngleMin() const {
+		return this->angleMin;
+	}
+
+	double getAngleIncrement() const {
+		return this->angleIncrement;
+	}
+
+	// Ranges of all beams from the pose [m], maxRange where nothing was hit
+	void scan(const OccupancyGrid& world, double x, double y, double phi, float* ranges) const {
+		scanBeams(world, x, y, phi, 0, settings.beams, ranges);
+	}
+
+	// Beams first..first + count - 1, ranges[0] is the range of beam first
+	void scanBeams(const OccupancyGrid& world, double x, double y, double phi, long first, long count, float* ranges) const;
+
+	// True once per period of the rate, time in [s] of simulation time. Deadlines stay on the
+	// rate grid so scans do not drift to the next step; resynced after a jump of more than a period
+	bool isScanDue(double time) {
+		if (settings.rate <= 0)
+			return true;
+		double period = 1 / settings.rate;
+		if (time < nextScanTime - period * LIDAR_DEADLINE_TOLERANCE)
+			return false;
+		nextScanTime += period;
+		if (nextScanTime <= time - period)
+			nextScanTime = time + period;
+		return true;
+	}
+
+	void resetSchedule() {
+		this->nextScanTime = -std::numeric_limits<double>::infinity();
+	}
+
+private:
+	LidarSettings settings;
+	double angleMin;
+	double angleIncrement;
+	double nextScanTime;
+	std::vector<double> beamSin;
+	std::vector<double> beamCos;
+};
+
+// Scans from many poses at once, split into jobs of at most LIDAR_BEAMS_PER_JOB beams so a
+// few vehicles use all workers as well. ranges[pose * beams + beam]
+void scanFleet(const Lidar& lidar, const OccupancyGrid& world, const double* x, const double* y, const double* phi,
+	size_t poseCount, float* ranges, JobSystem& jobs);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// Read only view of a whole file (mmap or Windows file mapping)
+class MappedFile {
+public:
+	MappedFile();
+
+	~MappedFile() {
+		close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+
+	const char* getData() {
+		return this->data;
+	}
+
+	size_t getSize() {
+		return this->size;
+	}
+
+private:
+	const char* data;
+	size_t size;
+
+#ifdef _WIN32
+	void* fileHandle;		// HANDLE, windows.h stays out of the header
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+};
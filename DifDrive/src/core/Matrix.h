@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+// Fixed size row major matrix for the small filters, no heap. Products and sums are
+// expanded element by element from index sequences at compile time, so they come out
+// fully unrolled whatever loop unrolling the optimizer is set to (GCC -O2 leaves the
+// loops of a 3 x 3 product rolled and the filter update twice as slow).
+template <int Rows, int Cols>
+struct Matrix {
+	double values[Rows][Cols];
+
+	static Matrix zero() {
+		Matrix result;
+		for (int r = 0; r < Rows; r++) {
+			for (int c = 0; c < Cols; c++) {
+				result.values[r][c] = 0;
+			}
+		}
+		return result;
+	}
+
+	static Matrix identity() {
+		static_assert(Rows == Cols, "identity of a non square matrix");
+		Matrix result = zero();
+		for (int i = 0; i < Rows; i++) {
+			result.values[i][i] = 1;
+		}
+		return result;
+	}
+
+	double& operator()(int row, int col) {
+		return values[row][col];
+	}
+
+	double operator()(int row, int col) const {
+		return values[row][col];
+	}
+
+	Matrix<Cols, Rows> transposed() const {
+		Matrix<Cols, Rows> result;
+		for (int r = 0; r < Rows; r++) {
+			for (int c = 0; c < Cols; c++) {
+				result.values[c][r] = values[r][c];
+			}
+		}
+		return result;
+	}
+
+	// Average with the transpose, removes the asymmetry rounding adds to covariances
+	void symmetrize() {
+		static_assert(Rows == Cols, "symmetrize of a non square matrix");
+		for (int r = 0; r < Rows; r++) {
+			for (int c = r + 1; c < Cols; c++) {
+				double mean = (values[r][c] + values[c][r]) * 0.5;
+				values[r][c] = mean;
+				values[c][r] = mean;
+			}
+		}
+	}
+};
+
+namespace matrixdetail {
+	template <int Rows, int Inner, int Cols, size_t... K>
+	inline double dot(const Matrix<Rows, Inner>& a, const Matrix<Inner, Cols>& b, size_t row, size_t col, std::index_sequence<K...>) {
+		return ((a.values[row][K] * b.values[K][col]) + ...);
+	}
+
+	// Element e of the result is row e / Cols, column e % Cols
+	template <int Rows, int Inner, int Cols, size_t... Element>
+	inline void multiply(const Matrix<Rows, Inner>& a, const Matrix<Inner, Cols>& b, Matrix<Rows, Cols>& result, std::index_sequence<Element...>) {
+		((result.values[Element / Cols][Element % Cols] = dot(a, b, Element / Cols, Element % Cols, std::make_index_sequence<Inner>())), ...);
+	}
+
+	template <int Rows, int Cols, size_t... Element>
+	inline void add(const Matrix<Rows, Cols>& a, const Matrix<Rows, Cols>& b, double sign, Matrix<Rows, Cols>& result,
+		std::index_sequence<Element...>) {
+		((result.values[Element / Cols][Element % Cols] = a.values[Element / Cols][Element % Cols] + sign * b.values[Element / Cols][Element % Cols]), ...);
+	}
+}
+
+template <int Rows, int Inner, int Cols>
+inline Matrix<Rows, Cols> operator*(const Matrix<Rows, Inner>& a, const Matrix<Inner, Cols>& b) {
+	Matrix<Rows, Cols> result;
+	matrixdetail::multiply(a, b, result, std::make_index_sequence<Rows * Cols>());
+	return result;
+}
+
+template <int Rows, int Cols>
+inline Matrix<Rows, Cols> operator+(const Matrix<Rows, Cols>& a, const Matrix<Rows, Cols>& b) {
+	Matrix<Rows, Cols> result;
+	matrixdetail::add(a, b, 1.0, result, std::make_index_sequence<Rows * Cols>());
+	return result;
+}
+
+template <int Rows, int Cols>
+inline Matrix<Rows, Cols> operator-(const Matrix<Rows, Cols>& a, const Matrix<Rows, Cols>& b) {
+	Matrix<Rows, Cols> result;
+	matrixdetail::add(a, b, -1.0, result, std::make_index_sequence<Rows * Cols>());
+	return result;
+}
+
+// Closed form inverses, false when the matrix is singular
+inline bool invert(const Matrix<2, 2>& m, Matrix<2, 2>& inverse) {
+	double determinant = m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+	if (!(std::fabs(determinant) > 0))
+		return false;
+	double scale = 1 / determinant;
+	inverse(0, 0) = m(1, 1) * scale;
+	inverse(0, 1) = -m(0, 1) * scale;
+	inverse(1, 0) = -m(1, 0) * scale;
+	inverse(1, 1) = m(0, 0) * scale;
+	return true;
+}
+
+inline bool invert(const Matrix<3, 3>& m, Matrix<3, 3>& inverse) {
+	double c00 = m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+	double c01 = m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2);
+	double c02 = m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0);
+	double determinant = m(0, 0) * c00 + m(0, 1) * c01 + m(0, 2) * c02;
+	if (!(std::fabs(determinant) > 0))
+		return false;
+	double scale = 1 / determinant;
+	inverse(0, 0) = c00 * scale;
+	inverse(1, 0) = c01 * scale;
+	inverse(2, 0) = c02 * scale;
+	inverse(0, 1) = (m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2)) * scale;
+	inverse(1, 1) = (m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0)) * scale;
+	inverse(2, 1) = (m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1)) * scale;
+	inverse(0, 2) = (m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1)) * scale;
+	inverse(1, 2) = (m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2)) * scale;
+	inverse(2, 2) = (m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)) * scale;
+	return true;
+}
+
+// Axes (square roots of the eigenvalues) and orientation of the major axis [rad] of the
+// one sigma ellipse of a 2 x 2 covariance
+inline void getCovarianceEllipse(const Matrix<2, 2>& covariance, double& major, double& minor, double& angle) {
+	double a = covariance(0, 0), b = covariance(0, 1), c = covariance(1, 1);
+	double mean = (a + c) * 0.5;
+	double spread = std::sqrt((a - c) * (a - c) * 0.25 + b * b);
+	major = std::sqrt(std::max(mean + spread, 0.0));
+	minor = std::sqrt(std::max(mean - spread, 0.0));
+	angle = 0.5 * std::atan2(2 * b, a - c);
+}
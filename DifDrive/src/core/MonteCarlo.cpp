@@ -0,0 +1,169 @@
+#include "MonteCarlo.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Constants.h"
+#include "FastMath.h"
+
+std::vector<SpeedSegment> getAppliedSegments(VelocitySchedule& schedule, long stepCount, double& duration) {
+	duration = getStepTime(stepCount);
+
+	// Wheels stand still until the first breakpoint applies
+	std::vector<SpeedSegment> segments;
+	std::vector<long> firstSteps;
+	segments.push_back({ 0, 0, 0 });
+	firstSteps.push_back(0);
+	for (size_t i = 0; i < schedule.size(); i++) {
+		// Same time expression as the stepped run, the speed applies once it is past the breakpoint
+		double time = schedule.getTime(i);
+		long first = std::max(0L, static_cast<long>(std::floor(time * SIMULATION_SECOND_STEP_AMOUNT)) - 1);
+		while (!(getStepTime(first) > time)) {
+			first++;
+		}
+		if (first >= stepCount)
+			break;
+		if (first == firstSteps.back()) {
+			segments.back() = { getStepTime(first), schedule.getLeftSpeed(i), schedule.getRightSpeed(i) };
+		}
+		else {
+			segments.push_back({ getStepTime(first), schedule.getLeftSpeed(i), schedule.getRightSpeed(i) });
+			firstSteps.push_back(first);
+		}
+	}
+	return segments;
+}
+
+void runPerturbed(const std::vector<SpeedSegment>& segments, double duration, double wheelbase, const PerturbationSettings& settings,
+	RandomStream& random, double& x, double& y, double& phi) {
+	double inverseWheelbase = 1 / wheelbase;
+	double scaleLeft = 1, scaleRight = 1;
+	if (settings.slip > 0) {
+		scaleLeft += settings.slip * random.gaussian();
+		scaleRight += settings.slip * random.gaussian();
+	}
+	bool noisy = settings.speedNoise > 0 && settings.correlationTime > 0;
+	double noiseLeft = 0, noiseRight = 0;
+	long draws = 0;
+	double nextDraw = 0;
+
+	double sinPhi, cosPhi;
+	fastSinCos(phi, sinPhi, cosPhi);
+	double time = 0;
+	size_t segment = 0;
+	while (time < duration) {
+		if (noisy && time >= nextDraw) {
+			noiseLeft = settings.speedNoise * random.gaussian();
+			noiseRight = settings.speedNoise * random.gaussian();
+			nextDraw = ++draws * settings.correlationTime;
+		}
+		double segmentEnd = (segment + 1 < segments.size()) ? std::min(segments[segment + 1].start, duration) : duration;
+		double end = noisy ? std::min(segmentEnd, nextDraw) : segmentEnd;
+
+		double vLeft = segments[segment].vLeft * scaleLeft + noiseLeft;
+		double vRight = segments[segment].vRight * scaleRight + noiseRight;
+		double v = (vLeft + vRight) * 0.5;
+		double omega = (vRight - vLeft) * inverseWheelbase;
+		double dt = end - time;
+		double phiEnd = phi + omega * dt;
+		double sinEnd, cosEnd;
+		fastSinCos(phiEnd, sinEnd, cosEnd);
+		if (std::fabs(omega) > 1e-9) {
+			double radius = v / omega;
+			x += radius * (sinEnd - sinPhi);
+			y -= radius * (cosEnd - cosPhi);
+		}
+		else {
+			x += v * cosPhi * dt;
+			y += v * sinPhi * dt;
+		}
+		phi = phiEnd;
+		sinPhi = sinEnd;
+		cosPhi = cosEnd;
+
+		time = end;
+		if (time >= segmentEnd)
+			segment++;
+	}
+}
+
+void runMonteCarlo(const std::vector<SpeedSegment>& segments, double duration, double wheelbase, const PerturbationSettings& settings,
+	double startX, double startY, double startPhi, long samples, std::uint64_t seed, double* endX, double* endY, double* endPhi, JobSystem& jobs) {
+	for (long first = 0; first < samples; first += MONTE_CARLO_SAMPLES_PER_JOB) {
+		long last = std::min(first + static_cast<long>(MONTE_CARLO_SAMPLES_PER_JOB), samples);
+		jobs.submit([&segments, &settings, duration, wheelbase, startX, startY, startPhi, first, last, seed, endX, endY, endPhi]() {
+			for (long i = first; i < last; i++) {
+				RandomStream random(seed, static_cast<std::uint64_t>(i));
+				double x = startX, y = startY, phi = startPhi;
+				runPerturbed(segments, duration, wheelbase, settings, random, x, y, phi);
+				endX[i] = x;
+				endY[i] = y;
+				endPhi[i] = phi;
+			}
+		});
+	}
+	jobs.wait();
+}
+
+PoseDistribution summarizePoses(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& phi) {
+	PoseDistribution distribution;
+	size_t count = x.size();
+	distribution.samples = static_cast<long>(count);
+	if (count == 0)
+		return distribution;
+
+	const std::vector<double>* values[3] = { &x, &y, &phi };
+	for (int axis = 0; axis < 3; axis++) {
+		double sum = 0;
+		for (double value : *values[axis]) {
+			sum += value;
+		}
+		distribution.mean(axis, 0) = sum / count;
+	}
+	double sums[3][3] = {};
+	for (size_t i = 0; i < count; i++) {
+		double d[3] = { x[i] - distribution.mean(0, 0), y[i] - distribution.mean(1, 0), phi[i] - distribution.mean(2, 0) };
+		for (int r = 0; r < 3; r++) {
+			for (int c = r; c < 3; c++) {
+				sums[r][c] += d[r] * d[c];
+			}
+		}
+	}
+	double divisor = (count > 1) ? static_cast<double>(count - 1) : 1.0;
+	for (int r = 0; r < 3; r++) {
+		for (int c = r; c < 3; c++) {
+			distribution.covariance(r, c) = sums[r][c] / divisor;
+			distribution.covariance(c, r) = sums[r][c] / divisor;
+		}
+	}
+
+	// Nearest rank percentiles, nth_element on a copy of every axis
+	std::vector<double> sorted(count);
+	double* targets[4] = { distribution.x, distribution.y, distribution.phi, distribution.radius };
+	for (int axis = 0; axis < 4; axis++) {
+		if (axis < 3) {
+			sorted = *values[axis];
+		}
+		else {
+			for (size_t i = 0; i < count; i++) {
+				sorted[i] = std::hypot(x[i] - distribution.mean(0, 0), y[i] - distribution.mean(1, 0));
+			}
+		}
+		for (int p = 0; p < 3; p++) {
+			size_t rank = std::min(count - 1, static_cast<size_t>(distribution.percentiles[p] * count));
+			std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+			targets[axis][p] = sorted[rank];
+		}
+	}
+
+	Matrix<2, 2> position;
+	position(0, 0) = distribution.covariance(0, 0);
+	position(0, 1) = distribution.covariance(0, 1);
+	position(1, 0) = distribution.covariance(1, 0);
+	position(1, 1) = distribution.covariance(1, 1);
+	getCovarianceEllipse(position, distribution.ellipseMajor, distribution.ellipseMinor, distribution.ellipseAngle);
+	double scale = std::sqrt(MONTE_CARLO_CONFIDENCE_CHI2);
+	distribution.ellipseMajor *= scale;
+	distribution.ellipseMinor *= scale;
+	return distribution;
+}
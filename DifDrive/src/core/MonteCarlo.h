@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Matrix.h"
+#include "Random.h"
+#include "VelocitySchedule.h"
+
+#define MONTE_CARLO_DEFAULT_SAMPLES 1000000
+#define MONTE_CARLO_DEFAULT_SPEED_NOISE 0.02	//[m/s]
+#define MONTE_CARLO_DEFAULT_SLIP 0.01			//[-]
+#define MONTE_CARLO_DEFAULT_CORRELATION 0.1		//[s]
+#define MONTE_CARLO_SAMPLES_PER_JOB 4096
+#define MONTE_CARLO_CONFIDENCE_CHI2 5.991		//95 % of chi square with 2 degrees of freedom
+
+struct PerturbationSettings {
+	double speedNoise = MONTE_CARLO_DEFAULT_SPEED_NOISE;		// standard deviation added to each wheel speed
+	double slip = MONTE_CARLO_DEFAULT_SLIP;						// standard deviation of the per run scale of each wheel speed
+	double correlationTime = MONTE_CARLO_DEFAULT_CORRELATION;	//[s] the speed noise is held this long
+};
+
+// Wheel speeds held from start until the start of the next segment or the run end
+struct SpeedSegment {
+	double start;	//[s]
+	double vLeft;	//[m/s]
+	double vRight;	//[m/s]
+};
+
+// Speeds of a schedule the way the fixed step simulation applies them: a breakpoint takes
+// effect with the first step after it, the run has ScenarioRun::getStepCount steps.
+// duration receives the length of that run [s].
+std::vector<SpeedSegment> getAppliedSegments(VelocitySchedule& schedule, long stepCount, double& duration);
+
+// One run along the segments from the pose, with perturbed wheel speeds: every wheel gets
+// a scale 1 + slip * N(0, 1) for the whole run and N(0, speedNoise) added, drawn again
+// every correlationTime. Speeds are then constant between segment starts and noise draws,
+// so each piece is integrated as an exact arc, no fixed steps.
+void runPerturbed(const std::vector<SpeedSegment>& segments, double duration, double wheelbase, const PerturbationSettings& settings,
+	RandomStream& random, double& x, double& y, double& phi);
+
+// End poses of samples runs from the pose, written to endX/endY/endPhi (samples entries).
+// Sample i uses the stream (seed, i), so the poses are the same for any worker count.
+void runMonteCarlo(const std::vector<SpeedSegment>& segments, double duration, double wheelbase, const PerturbationSettings& settings,
+	double startX, double startY, double startPhi, long samples, std::uint64_t seed, double* endX, double* endY, double* endPhi, JobSystem& jobs);
+
+struct PoseDistribution {
+	long samples = 0;
+	Matrix<3, 1> mean = Matrix<3, 1>::zero();			// x, y, phi
+	Matrix<3, 3> covariance = Matrix<3, 3>::zero();
+	double percentiles[3] = { 0.05, 0.5, 0.95 };
+	double x[3] = { 0, 0, 0 };			// at the percentiles
+	double y[3] = { 0, 0, 0 };
+	double phi[3] = { 0, 0, 0 };
+	double radius[3] = { 0, 0, 0 };		// distance of the end position from the mean [m]
+	double ellipseMajor = 0;			// MONTE_CARLO_CONFIDENCE_CHI2 ellipse of the position [m]
+	double ellipseMinor = 0;
+	double ellipseAngle = 0;			//[rad]
+};
+
+// Mean and covariance (two pass, in sample order) and percentiles of the end poses
+PoseDistribution summarizePoses(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& phi);
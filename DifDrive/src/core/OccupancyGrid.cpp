@@ -0,0 +1,170 @@
+#include "OccupancyGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+bool OccupancyGrid::create(long columnCount, long rowCount, double metersPerCell, double x0, double y0) {
+	if (columnCount <= 0 || rowCount <= 0 || !(metersPerCell > 0)) {
+		std::cout << "Error: Occupancy grid needs a positive size and resolution" << std::endl;
+		return false;
+	}
+	if (static_cast<long long>(columnCount) * rowCount > OCCUPANCY_MAX_CELLS) {
+		std::cout << "Error: Occupancy grid of " << columnCount << " x " << rowCount << " cells is too large" << std::endl;
+		return false;
+	}
+	columns = columnCount;
+	rows = rowCount;
+	wordsPerRow = (columns + 63) >> 6;
+	blockColumns = ((columns - 1) >> OCCUPANCY_BLOCK_SHIFT) + 1;
+	blockRows = ((rows - 1) >> OCCUPANCY_BLOCK_SHIFT) + 1;
+	blockWordsPerRow = (blockColumns + 63) >> 6;
+	resolution = metersPerCell;
+	originX = x0;
+	originY = y0;
+
+	cells.assign(static_cast<size_t>(rows) * wordsPerRow, 0);
+	blocks.assign(static_cast<size_t>(blockRows) * blockWordsPerRow, 0);
+	return true;
+}
+
+bool OccupancyGrid::isOccupiedAt(double x, double y) const {
+	double column = std::floor((x - originX) / resolution);
+	double row = std::floor((y - originY) / resolution);
+	if (column < 0 || row < 0 || column >= columns || row >= rows)
+		return false;
+	return isOccupied(static_cast<long>(column), static_cast<long>(row));
+}
+
+bool OccupancyGrid::anyInRow(const std::uint64_t* row, long first, long last) {
+	long firstWord = first >> 6;
+	long lastWord = last >> 6;
+	std::uint64_t firstMask = ~std::uint64_t(0) << (first & 63);
+	std::uint64_t lastMask = ~std::uint64_t(0) >> (63 - (last & 63));
+	if (firstWord == lastWord)
+		return (row[firstWord] & firstMask & lastMask) != 0;
+	if (row[firstWord] & firstMask)
+		return true;
+	for (long word = firstWord + 1; word < lastWord; word++) {
+		if (row[word])
+			return true;
+	}
+	return (row[lastWord] & lastMask) != 0;
+}
+
+bool OccupancyGrid::collidesCircle(double x, double y, double radius) const {
+	if (cells.empty())
+		return false;
+
+	// Cell centers inside the bounding box of the disc, in cell units
+	double cx = (x - originX) / resolution - 0.5;
+	double cy = (y - originY) / resolution - 0.5;
+	double r = radius / resolution;
+	double firstRowF = std::ceil(cy - r), lastRowF = std::floor(cy + r);
+	double firstColumnF = std::ceil(cx - r), lastColumnF = std::floor(cx + r);
+	if (lastRowF < 0 || lastColumnF < 0 || firstRowF >= rows || firstColumnF >= columns || firstRowF > lastRowF || firstColumnF > lastColumnF)
+		return false;
+	long firstRow = static_cast<long>(std::max(firstRowF, 0.0));
+	long lastRow = static_cast<long>(std::min(lastRowF, rows - 1.0));
+	long firstColumn = static_cast<long>(std::max(firstColumnF, 0.0));
+	long lastColumn = static_cast<long>(std::min(lastColumnF, columns - 1.0));
+
+	// Nothing in the blocks under the bounding box, the usual case away from obstacles
+	bool blockHit = false;
+	for (long blockRow = firstRow >> OCCUPANCY_BLOCK_SHIFT; blockRow <= (lastRow >> OCCUPANCY_BLOCK_SHIFT) && !blockHit; blockRow++) {
+		blockHit = anyInRow(&blocks[blockRow * blockWordsPerRow], firstColumn >> OCCUPANCY_BLOCK_SHIFT, lastColumn >> OCCUPANCY_BLOCK_SHIFT);
+	}
+	if (!blockHit)
+		return false;
+
+	// Row by row the columns whose centers lie inside the disc, rows free across the whole
+	// bounding box need no square root
+	double rSquared = r * r;
+	for (long row = firstRow; row <= lastRow; row++) {
+		const std::uint64_t* rowCells = &cells[row * wordsPerRow];
+		if (!anyInRow(rowCells, firstColumn, lastColumn))
+			continue;
+		double dy = row - cy;
+		double halfWidth = std::sqrt(std::max(rSquared - dy * dy, 0.0));
+		double firstF = std::max(std::ceil(cx - halfWidth), static_cast<double>(firstColumn));
+		double lastF = std::min(std::floor(cx + halfWidth), static_cast<double>(lastColumn));
+		if (firstF > lastF)
+			continue;
+		if (anyInRow(rowCells, static_cast<long>(firstF), static_cast<long>(lastF)))
+			return true;
+	}
+	return false;
+}
+
+double OccupancyGrid::castRay(double x, double y, double dirX, double dirY, double maxRange) const {
+	if (cells.empty())
+		return maxRange;
+
+	// In cell units; the part of the ray inside the map and within range is [t, tLeave)
+	double ox = (x - originX) / resolution;
+	double oy = (y - originY) / resolution;
+	double invX = (dirX != 0) ? 1 / dirX : INFINITY;
+	double invY = (dirY != 0) ? 1 / dirY : INFINITY;
+	double t = 0;
+	double tLeave = maxRange / resolution;
+	if (dirX != 0) {
+		double t0 = -ox * invX, t1 = (columns - ox) * invX;
+		t = std::max(t, std::min(t0, t1));
+		tLeave = std::min(tLeave, std::max(t0, t1));
+	}
+	else if (ox < 0 || ox >= columns) {
+		return maxRange;
+	}
+	if (dirY != 0) {
+		double t0 = -oy * invY, t1 = (rows - oy) * invY;
+		t = std::max(t, std::min(t0, t1));
+		tLeave = std::min(tLeave, std::max(t0, t1));
+	}
+	else if (oy < 0 || oy >= rows) {
+		return maxRange;
+	}
+	if (t >= tLeave)
+		return maxRange;
+
+	long column = std::clamp(static_cast<long>(std::floor(ox + t * dirX)), 0L, columns - 1);
+	long row = std::clamp(static_cast<long>(std::floor(oy + t * dirY)), 0L, rows - 1);
+	long stepX = (dirX > 0) ? 1 : -1;
+	long stepY = (dirY > 0) ? 1 : -1;
+	const long blockSize = 1L << OCCUPANCY_BLOCK_SHIFT;
+	while (true) {
+		long blockColumn = column >> OCCUPANCY_BLOCK_SHIFT;
+		long blockRow = row >> OCCUPANCY_BLOCK_SHIFT;
+		if (!isBlockOccupied(blockColumn, blockRow)) {
+			// Straight to the first cell past the block edge the ray leaves through
+			long firstColumn = blockColumn * blockSize, firstRow = blockRow * blockSize;
+			double tx = (dirX != 0) ? ((firstColumn + (stepX > 0 ? blockSize : 0)) - ox) * invX : INFINITY;
+			double ty = (dirY != 0) ? ((firstRow + (stepY > 0 ? blockSize : 0)) - oy) * invY : INFINITY;
+			if (tx < ty) {
+				t = tx;
+				column = (stepX > 0) ? firstColumn + blockSize : firstColumn - 1;
+				row = std::clamp(static_cast<long>(std::floor(oy + t * dirY)), firstRow, firstRow + blockSize - 1);
+			}
+			else {
+				t = ty;
+				row = (stepY > 0) ? firstRow + blockSize : firstRow - 1;
+				column = std::clamp(static_cast<long>(std::floor(ox + t * dirX)), firstColumn, firstColumn + blockSize - 1);
+			}
+		}
+		else {
+			if (isOccupied(column, row))
+				return t * resolution;
+			double tx = (dirX != 0) ? ((column + (stepX > 0)) - ox) * invX : INFINITY;
+			double ty = (dirY != 0) ? ((row + (stepY > 0)) - oy) * invY : INFINITY;
+			if (tx < ty) {
+				t = tx;
+				column += stepX;
+			}
+			else {
+				t = ty;
+				row += stepY;
+			}
+		}
+		if (t >= tLeave || column < 0 || row < 0 || column >= columns || row >= rows)
+			return maxRange;
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define OCCUPANCY_BLOCK_SHIFT 5		//summary bit per 32 x 32 cells
+#define OCCUPANCY_MAX_CELLS 4000000000LL
+
+// Static world map of square cells, one bit per cell packed 64 to a word row by row.
+// A 10k x 10k map takes 12.5 MB; a summary with one bit per 32 x 32 block (12 kB for the
+// same map, it stays in L1) answers queries in free space without touching the cells, and
+// near obstacles a vehicle sized footprint reads one or two words of a few dozen rows.
+// Column 0 / row 0 is the cell at the origin (lower left corner), rows grow along +y.
+class OccupancyGrid {
+public:
+	OccupancyGrid() {
+		columns = 0;
+		rows = 0;
+		wordsPerRow = 0;
+		blockColumns = 0;
+		blockRows = 0;
+		blockWordsPerRow = 0;
+		resolution = 1;
+		originX = 0;
+		originY = 0;
+	}
+
+	// All cells free, origin is the lower left corner of the map [m]
+	bool create(long columnCount, long rowCount, double metersPerCell, double x0, double y0);
+
+	bool empty() const {
+		return this->cells.empty();
+	}
+
+	long getColumns() const {
+		return this->columns;
+	}
+
+	long getRows() const {
+		return this->rows;
+	}
+
+	double getResolution() const {
+		return this->resolution;
+	}
+
+	double getOriginX() const {
+		return this->originX;
+	}
+
+	double getOriginY() const {
+		return this->originY;
+	}
+
+	// Cells and summary
+	size_t getMemoryBytes() const {
+		return (cells.size() + blocks.size()) * sizeof(std::uint64_t);
+	}
+
+	void setOccupied(long column, long row) {
+		cells[row * wordsPerRow + (column >> 6)] |= std::uint64_t(1) << (column & 63);
+		long blockColumn = column >> OCCUPANCY_BLOCK_SHIFT;
+		blocks[(row >> OCCUPANCY_BLOCK_SHIFT) * blockWordsPerRow + (blockColumn >> 6)] |= std::uint64_t(1) << (blockColumn & 63);
+	}
+
+	// Cells outside the map are free
+	bool isOccupied(long column, long row) const {
+		if (column < 0 || row < 0 || column >= columns || row >= rows)
+			return false;
+		return (cells[row * wordsPerRow + (column >> 6)] >> (column & 63)) & 1;
+	}
+
+	// Occupied cell at a world position [m]
+	bool isOccupiedAt(double x, double y) const;
+
+	// Any occupied cell with its center within radius of the position, i.e. a disc shaped
+	// footprint [m]
+	bool collidesCircle(double x, double y, double radius) const;
+
+	// Distance along the unit direction to the first occupied cell, maxRange when there is
+	// none within range [m]. Cells are traversed one by one (Amanatides-Woo DDA), blocks
+	// without any obstacle are crossed in one jump.
+	double castRay(double x, double y, double dirX, double dirY, double maxRange) const;
+
+private:
+	std::vector<std::uint64_t> cells;
+	std::vector<std::uint64_t> blocks;
+	long columns;
+	long rows;
+	long wordsPerRow;
+	long blockColumns;
+	long blockRows;
+	long blockWordsPerRow;
+	double resolution;		//[m] per cell
+	double originX;			//[m]
+	double originY;			//[m]
+
+	// Any set bit in columns first..last (inclusive) of one row of a bit plane
+	static bool anyInRow(const std::uint64_t* row, long first, long last);
+
+	bool isBlockOccupied(long blockColumn, long blockRow) const {
+		return (blocks[blockRow * blockWordsPerRow + (blockColumn >> 6)] >> (blockColumn & 63)) & 1;
+	}
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "Constants.h"
+#include "FastMath.h"
+#include "Kinematics.h"
+#include "Random.h"
+#include "Trail.h"
+
+#define ENCODER_DEFAULT_TICKS 1024
+
+struct EncoderSettings {
+	long ticksPerRevolution = ENCODER_DEFAULT_TICKS;
+	double slipLeft = 0;		//[-] wheel rotation beyond the ground travel, e.g. 0.02
+	double slipRight = 0;		//[-]
+	double noise = 0;			//[rad/sqrt(s)] random walk of the measured wheel angles
+};
+
+// Incremental encoder, counts whole ticks of the accumulated measured wheel angle
+class WheelEncoder {
+public:
+	WheelEncoder(long ticksPerRevolution = ENCODER_DEFAULT_TICKS) {
+		ticksPerRadian = ticksPerRevolution / (2 * M_PI);
+		angle = 0;
+		ticks = 0;
+	}
+
+	void advance(double measuredAngle) {
+		angle += measuredAngle;
+		// Floor without the library call, the cast truncates toward zero
+		double scaled = angle * ticksPerRadian;
+		ticks = static_cast<std::int64_t>(scaled);
+		if (scaled < ticks)
+			ticks--;
+	}
+
+	std::int64_t getTicks() const {
+		return this->ticks;
+	}
+
+private:
+	double ticksPerRadian;
+	double angle;		//[rad]
+	std::int64_t ticks;
+};
+
+// Dead reckoning from two wheel encoders running next to the true vehicle. The wheels turn
+// with the speeds of the true vehicle, the encoders measure that rotation with slip and
+// noise and quantize it to ticks; the estimate integrates the tick differences with the
+// nominal geometry (midpoint heading, one sine and cosine per step).
+class Odometry {
+public:
+	Odometry(const RuntimeGeometry& geometry, const EncoderSettings& encoderSettings = EncoderSettings(), std::uint64_t seed = 0, std::uint64_t stream = 0)
+		: random(seed, stream), left(encoderSettings.ticksPerRevolution), right(encoderSettings.ticksPerRevolution) {
+		settings = encoderSettings;
+		inverseWheelRadius = geometry.getInverseWheelRadius();
+		inverseWheelbase = geometry.getInverseWheelbase();
+		metersPerTick = 2 * M_PI * geometry.getWheelRadius() / settings.ticksPerRevolution;
+		lastDeltaTime = 0;
+		noiseScale = 0;
+		lastDistanceLeft = 0;
+		lastDistanceRight = 0;
+		reset(0, 0, 0);
+	}
+
+	const EncoderSettings& getSettings() const {
+		return this->settings;
+	}
+
+	// Estimate starts again from the pose, the encoders keep counting
+	void reset(double startX, double startY, double startPhi) {
+		x = startX;
+		y = startY;
+		phi = startPhi;
+		lastLeftTicks = left.getTicks();
+		lastRightTicks = right.getTicks();
+		trail.deleteTrail();
+	}
+
+	// One physics step with the wheel speeds of the true vehicle
+	void step(double deltaTime, double vLeft, double vRight) {
+		double angleLeft = vLeft * deltaTime * inverseWheelRadius * (1 + settings.slipLeft);
+		double angleRight = vRight * deltaTime * inverseWheelRadius * (1 + settings.slipRight);
+		if (settings.noise > 0) {
+			if (deltaTime != lastDeltaTime) {
+				lastDeltaTime = deltaTime;
+				noiseScale = settings.noise * std::sqrt(deltaTime);
+			}
+			angleLeft += random.gaussian() * noiseScale;
+			angleRight += random.gaussian() * noiseScale;
+		}
+		left.advance(angleLeft);
+		right.advance(angleRight);
+
+		std::int64_t leftTicks = left.getTicks(), rightTicks = right.getTicks();
+		lastDistanceLeft = 0;
+		lastDistanceRight = 0;
+		if (leftTicks == lastLeftTicks && rightTicks == lastRightTicks)
+			return;
+		double distanceLeft = (leftTicks - lastLeftTicks) * metersPerTick;
+		double distanceRight = (rightTicks - lastRightTicks) * metersPerTick;
+		lastDistanceLeft = distanceLeft;
+		lastDistanceRight = distanceRight;
+		lastLeftTicks = leftTicks;
+		lastRightTicks = rightTicks;
+
+		double distance = (distanceLeft + distanceRight) * 0.5;
+		double rotation = (distanceRight - distanceLeft) * inverseWheelbase;
+		double sinPhi, cosPhi;
+		fastSinCos(phi + rotation * 0.5, sinPhi, cosPhi);
+		x += distance * cosPhi;
+		y += distance * sinPhi;
+		phi += rotation;
+	}
+
+	double getX() const {
+		return this->x;
+	}
+
+	double getY() const {
+		return this->y;
+	}
+
+	double getPhi() const {
+		return this->phi;
+	}
+
+	std::int64_t getLeftTicks() const {
+		return left.getTicks();
+	}
+
+	std::int64_t getRightTicks() const {
+		return right.getTicks();
+	}
+
+	// Wheel travel measured in the last step, whole ticks only [m]
+	double getLastDistanceLeft() const {
+		return this->lastDistanceLeft;
+	}
+
+	double getLastDistanceRight() const {
+		return this->lastDistanceRight;
+	}
+
+	// Distance of the estimate from the true position [m]
+	double getPositionError(double trueX, double trueY) const {
+		return std::hypot(x - trueX, y - trueY);
+	}
+
+	// Estimated minus true heading, <-pi, pi> [rad]
+	double getHeadingError(double truePhi) const {
+		return std::remainder(phi - truePhi, 2 * M_PI);
+	}
+
+	// Estimated positions for drawing, filled at the observer's rate like the wheel trails
+	BasicTrail<double>& getTrail() {
+		return this->trail;
+	}
+
+	void sampleTrail() {
+		trail.addTrailPoint(x, y);
+	}
+
+private:
+	EncoderSettings settings;
+	RandomStream random;
+	WheelEncoder left;
+	WheelEncoder right;
+	std::int64_t lastLeftTicks;
+	std::int64_t lastRightTicks;
+	double inverseWheelRadius;
+	double inverseWheelbase;
+	double metersPerTick;
+	double lastDeltaTime;
+	double noiseScale;		//[rad] standard deviation per step of lastDeltaTime
+	double lastDistanceLeft;	//[m]
+	double lastDistanceRight;	//[m]
+
+	double x;
+	double y;
+	double phi;
+	BasicTrail<double> trail;
+};
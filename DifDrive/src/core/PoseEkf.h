@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cmath>
+
+#include "Constants.h"
+#include "FastMath.h"
+#include "Matrix.h"
+
+#define EKF_DEFAULT_WHEEL_VARIANCE 4e-4		//[m^2 per m] of wheel travel
+#define EKF_DEFAULT_POSITION_DEVIATION 0.05	//[m] of the start pose
+#define EKF_DEFAULT_HEADING_DEVIATION 0.02	//[rad]
+#define EKF_GATE_CHI2 13.82					//99.9 % of chi square with 2 degrees of freedom
+
+// Extended Kalman filter over the pose (x, y, phi) of a differential drive. The prediction
+// uses the wheel distances measured by the encoders in one step, the same midpoint motion
+// as Odometry, with a variance of each wheel distance proportional to the distance. The
+// correction fuses range and bearing to landmarks at known positions. All matrices have
+// compile time sizes, one predict and one update touch nothing but this object.
+class PoseEkf {
+public:
+	PoseEkf(double wheelbase, double wheelVariance = EKF_DEFAULT_WHEEL_VARIANCE) {
+		inverseWheelbase = 1 / wheelbase;
+		wheelVariancePerMeter = wheelVariance;
+		reset(0, 0, 0);
+	}
+
+	void reset(double x, double y, double phi, double positionDeviation = EKF_DEFAULT_POSITION_DEVIATION,
+		double headingDeviation = EKF_DEFAULT_HEADING_DEVIATION) {
+		state(0, 0) = x;
+		state(1, 0) = y;
+		state(2, 0) = phi;
+		covariance = Matrix<3, 3>::zero();
+		covariance(0, 0) = positionDeviation * positionDeviation;
+		covariance(1, 1) = positionDeviation * positionDeviation;
+		covariance(2, 2) = headingDeviation * headingDeviation;
+	}
+
+	// Motion of one step from the measured wheel distances [m]
+	void predict(double distanceLeft, double distanceRight) {
+		if (distanceLeft == 0 && distanceRight == 0)
+			return;
+		double distance = (distanceLeft + distanceRight) * 0.5;
+		double rotation = (distanceRight - distanceLeft) * inverseWheelbase;
+		double sinPhi, cosPhi;
+		fastSinCos(state(2, 0) + rotation * 0.5, sinPhi, cosPhi);
+		state(0, 0) += distance * cosPhi;
+		state(1, 0) += distance * sinPhi;
+		state(2, 0) += rotation;
+
+		// The pose Jacobian is the identity plus the heading column (a, b, 0), F P F^T
+		// written out touches only the upper triangle
+		double a = -distance * sinPhi, b = distance * cosPhi;
+		Matrix<3, 3>& p = covariance;
+		double p02 = p(0, 2), p12 = p(1, 2), p22 = p(2, 2);
+		p(0, 0) += a * (2 * p02 + a * p22);
+		p(0, 1) += a * p12 + b * (p02 + a * p22);
+		p(1, 1) += b * (2 * p12 + b * p22);
+		p(0, 2) = p02 + a * p22;
+		p(1, 2) = p12 + b * p22;
+
+		// Independent wheel distances, W diag(qLeft, qRight) W^T with the wheel Jacobian W
+		double halfTurn = distance * 0.5 * inverseWheelbase;
+		double qLeft = wheelVariancePerMeter * std::fabs(distanceLeft);
+		double qRight = wheelVariancePerMeter * std::fabs(distanceRight);
+		double xLeft = 0.5 * cosPhi + halfTurn * sinPhi, xRight = 0.5 * cosPhi - halfTurn * sinPhi;
+		double yLeft = 0.5 * sinPhi - halfTurn * cosPhi, yRight = 0.5 * sinPhi + halfTurn * cosPhi;
+		p(0, 0) += qLeft * xLeft * xLeft + qRight * xRight * xRight;
+		p(0, 1) += qLeft * xLeft * yLeft + qRight * xRight * yRight;
+		p(1, 1) += qLeft * yLeft * yLeft + qRight * yRight * yRight;
+		p(0, 2) += (qRight * xRight - qLeft * xLeft) * inverseWheelbase;
+		p(1, 2) += (qRight * yRight - qLeft * yLeft) * inverseWheelbase;
+		p(2, 2) += (qLeft + qRight) * inverseWheelbase * inverseWheelbase;
+		p(1, 0) = p(0, 1);
+		p(2, 0) = p(0, 2);
+		p(2, 1) = p(1, 2);
+	}
+
+	// Range [m] and bearing relative to the heading [rad] of the landmark at (landmarkX,
+	// landmarkY). False when the innovation fails the chi square gate, then nothing changes.
+	bool updateLandmark(double range, double bearing, double landmarkX, double landmarkY, double rangeVariance, double bearingVariance) {
+		double dx = landmarkX - state(0, 0);
+		double dy = landmarkY - state(1, 0);
+		double squared = dx * dx + dy * dy;
+		if (!(squared > 1e-12))
+			return false;
+		double expectedRange = std::sqrt(squared);
+
+		Matrix<2, 1> innovation;
+		innovation(0, 0) = range - expectedRange;
+		innovation(1, 0) = wrapAngle(bearing - (std::atan2(dy, dx) - state(2, 0)));
+		Matrix<2, 3> observation;
+		observation(0, 0) = -dx / expectedRange;
+		observation(0, 1) = -dy / expectedRange;
+		observation(0, 2) = 0;
+		observation(1, 0) = dy / squared;
+		observation(1, 1) = -dx / squared;
+		observation(1, 2) = -1;
+		Matrix<2, 2> noise = Matrix<2, 2>::zero();
+		noise(0, 0) = rangeVariance;
+		noise(1, 1) = bearingVariance;
+
+		Matrix<3, 2> crossCovariance = covariance * observation.transposed();
+		Matrix<2, 2> innovationCovariance = observation * crossCovariance + noise;
+		Matrix<2, 2> inverse;
+		if (!invert(innovationCovariance, inverse))
+			return false;
+		double distance = (innovation.transposed() * inverse * innovation)(0, 0);
+		if (!(distance <= EKF_GATE_CHI2))
+			return false;
+
+		// P - K S K^T = P - K (P H^T)^T, symmetric up to rounding
+		Matrix<3, 2> gain = crossCovariance * inverse;
+		state = state + gain * innovation;
+		state(2, 0) = wrapAngle(state(2, 0));
+		covariance = covariance - gain * crossCovariance.transposed();
+		covariance.symmetrize();
+		return true;
+	}
+
+	double getX() const {
+		return this->state(0, 0);
+	}
+
+	double getY() const {
+		return this->state(1, 0);
+	}
+
+	double getPhi() const {
+		return this->state(2, 0);
+	}
+
+	const Matrix<3, 3>& getCovariance() const {
+		return this->covariance;
+	}
+
+	// Squared Mahalanobis distance of the true pose from the estimate, averages 3 over many
+	// runs when the covariance matches the actual error
+	double getNormalizedError(double trueX, double trueY, double truePhi) const {
+		Matrix<3, 1> error;
+		error(0, 0) = state(0, 0) - trueX;
+		error(1, 0) = state(1, 0) - trueY;
+		error(2, 0) = wrapAngle(state(2, 0) - truePhi);
+		Matrix<3, 3> inverse;
+		if (!invert(covariance, inverse))
+			return INFINITY;
+		return (error.transposed() * inverse * error)(0, 0);
+	}
+
+	// Axes [m] and orientation [rad] of the one sigma ellipse of the position
+	void getPositionEllipse(double& major, double& minor, double& angle) const {
+		Matrix<2, 2> position;
+		position(0, 0) = covariance(0, 0);
+		position(0, 1) = covariance(0, 1);
+		position(1, 0) = covariance(1, 0);
+		position(1, 1) = covariance(1, 1);
+		getCovarianceEllipse(position, major, minor, angle);
+	}
+
+private:
+	Matrix<3, 1> state;
+	Matrix<3, 3> covariance;
+	double inverseWheelbase;
+	double wheelVariancePerMeter;	//[m^2 per m]
+
+	// To <-pi, pi>, std::remainder is exact but several times slower
+	static double wrapAngle(double angle) {
+		double turns = angle * (0.5 / M_PI);
+		long long whole = static_cast<long long>(turns + (turns < 0 ? -0.5 : 0.5));
+		return angle - whole * (2 * M_PI);
+	}
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "Constants.h"
+
+#define RANDOM_GAMMA 0x9E3779B97F4A7C15ULL	// 2^64 / golden ratio, odd
+#define ZIGGURAT_LAYERS 128
+#define ZIGGURAT_R 3.442619855899				// start of the tail
+#define ZIGGURAT_V 9.91256303526217e-3			// area of every layer
+
+// Layer edges of the normal distribution ziggurat (Marsaglia and Tsang, layout of Doornik's
+// ZIGNOR), computed once at startup
+struct ZigguratTables {
+	double x[ZIGGURAT_LAYERS + 1];
+	double ratio[ZIGGURAT_LAYERS];
+
+	ZigguratTables() {
+		double f = std::exp(-0.5 * ZIGGURAT_R * ZIGGURAT_R);
+		x[0] = ZIGGURAT_V / f;
+		x[1] = ZIGGURAT_R;
+		x[ZIGGURAT_LAYERS] = 0;
+		for (int i = 2; i < ZIGGURAT_LAYERS; i++) {
+			x[i] = std::sqrt(-2 * std::log(ZIGGURAT_V / x[i - 1] + f));
+			f = std::exp(-0.5 * x[i] * x[i]);
+		}
+		for (int i = 0; i < ZIGGURAT_LAYERS; i++) {
+			ratio[i] = x[i + 1] / x[i];
+		}
+	}
+};
+
+inline const ZigguratTables zigguratTables;
+
+// Counter based random numbers: value n of a stream is the SplitMix64 finalizer of
+// key + n * RANDOM_GAMMA, the key mixes the seed with the stream number. Every vehicle
+// gets its own stream, so results do not depend on how many vehicles run or in which
+// order they are stepped, and any value follows from (seed, stream, n) alone.
+class RandomStream {
+public:
+	RandomStream(std::uint64_t seed = 0, std::uint64_t stream = 0) {
+		key = mix(mix(seed) + stream * RANDOM_GAMMA);
+		counter = 0;
+	}
+
+	std::uint64_t next() {
+		counter++;
+		return mix(key + counter * RANDOM_GAMMA);
+	}
+
+	// Uniform in (0, 1]
+	double uniform() {
+		return ((next() >> 11) + 1) * (1.0 / 9007199254740992.0);
+	}
+
+	// Standard normal value (ziggurat); one draw and a comparison in 99 % of the calls,
+	// Box-Muller with its logarithm, root and sine costs several times more
+	double gaussian() {
+		while (true) {
+			std::uint64_t bits = next();
+			int layer = static_cast<int>(bits & (ZIGGURAT_LAYERS - 1));
+			double u = static_cast<double>(static_cast<std::int64_t>(bits) >> 11) * (1.0 / 4503599627370496.0);	// (-1, 1)
+			if (std::fabs(u) < zigguratTables.ratio[layer])
+				return u * zigguratTables.x[layer];
+			if (layer == 0)
+				return gaussianTail(u < 0);
+
+			double x = u * zigguratTables.x[layer];
+			double f0 = std::exp(-0.5 * (zigguratTables.x[layer] * zigguratTables.x[layer] - x * x));
+			double f1 = std::exp(-0.5 * (zigguratTables.x[layer + 1] * zigguratTables.x[layer + 1] - x * x));
+			if (f1 + uniform() * (f0 - f1) < 1.0)
+				return x;
+		}
+	}
+
+	// Values drawn so far, setCounter continues the stream from any position
+	std::uint64_t getCounter() const {
+		return this->counter;
+	}
+
+	void setCounter(std::uint64_t position) {
+		this->counter = position;
+	}
+
+private:
+	std::uint64_t key;
+	std::uint64_t counter;
+
+	// Beyond ZIGGURAT_R (Marsaglia's tail method)
+	double gaussianTail(bool negative) {
+		double x, y;
+		do {
+			x = std::log(uniform()) / ZIGGURAT_R;
+			y = std::log(uniform());
+		} while (-2 * y < x * x);
+		return negative ? x - ZIGGURAT_R : ZIGGURAT_R - x;
+	}
+
+	static std::uint64_t mix(std::uint64_t z) {
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+};
@@ -0,0 +1,51 @@
+#include "RunStatistics.h"
+
+#include <cstdio>
+
+void RunStatistics::closeSegment() {
+	if (segmentSteps > 0) {
+		double duration = segmentTime.get();
+		steps += segmentSteps;
+		time.add(duration);
+		pathLength.add(std::fabs(segmentV) * duration);
+		totalRotation.add(std::fabs(segmentOmega) * duration);
+		netRotation.add(segmentOmega * duration);
+		leftTravel.add(std::fabs(segmentLeft) * duration);
+		rightTravel.add(std::fabs(segmentRight) * duration);
+		speed.add(segmentV, duration);
+		maxSpeed = std::fmax(maxSpeed, std::fabs(segmentV));
+		maxAngularSpeed = std::fmax(maxAngularSpeed, std::fabs(segmentOmega));
+	}
+	segmentSteps = 0;
+	segmentTime = KahanSum();
+}
+
+StatisticsSample RunStatistics::getSample(double x, double y, double phi) const {
+	// The open segment is added to a copy, the running segment goes on
+	RunStatistics closed = *this;
+	closed.closeSegment();
+
+	StatisticsSample sample;
+	sample.steps = closed.steps;
+	sample.time = closed.time.get();
+	sample.pathLength = closed.pathLength.get();
+	sample.totalRotation = closed.totalRotation.get();
+	sample.netRotation = closed.netRotation.get();
+	sample.maxSpeed = closed.maxSpeed;
+	sample.meanSpeed = closed.speed.getMean();
+	sample.speedDeviation = closed.speed.getDeviation();
+	sample.maxAngularSpeed = closed.maxAngularSpeed;
+	sample.leftTravel = closed.leftTravel.get();
+	sample.rightTravel = closed.rightTravel.get();
+	sample.closureError = std::hypot(x - startX, y - startY);
+	sample.closureHeading = std::remainder(phi - startPhi, 2 * M_PI);
+	return sample;
+}
+
+void printStatistics(const StatisticsSample& sample) {
+	printf("Run statistics: %lld steps, %.3f [s]\n", static_cast<long long>(sample.steps), sample.time);
+	printf("  path length = %.6f [m] | wheel travel L = %.6f [m] | R = %.6f [m]\n", sample.pathLength, sample.leftTravel, sample.rightTravel);
+	printf("  rotation total = %.6f [rad] | net = %.6f [rad] | max omega = %.3f [rad/s]\n", sample.totalRotation, sample.netRotation, sample.maxAngularSpeed);
+	printf("  speed max = %.3f [m/s] | mean = %.3f [m/s] | std. dev. = %.3f [m/s]\n", sample.maxSpeed, sample.meanSpeed, sample.speedDeviation);
+	printf("  closure to start = %.3e [m] | heading %.3e [rad]\n", sample.closureError, sample.closureHeading);
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "Snapshot.h"
+
+// Compensated (Kahan) sum, millions of small increments stay accurate to a few ulp
+class KahanSum {
+public:
+	KahanSum() {
+		sum = 0;
+		compensation = 0;
+	}
+
+	void add(double value) {
+		double corrected = value - compensation;
+		double next = sum + corrected;
+		compensation = (next - sum) - corrected;
+		sum = next;
+	}
+
+	double get() const {
+		return this->sum;
+	}
+
+private:
+	double sum;
+	double compensation;
+};
+
+// Running mean and variance (Welford, weighted after West), a value held for a weight such
+// as a duration is added at once; no catastrophic cancellation on long runs
+class RunningMoments {
+public:
+	RunningMoments() {
+		totalWeight = 0;
+		mean = 0;
+		m2 = 0;
+	}
+
+	void add(double value, double weight = 1) {
+		if (!(weight > 0))
+			return;
+		totalWeight += weight;
+		double delta = value - mean;
+		mean += delta * weight / totalWeight;
+		m2 += weight * delta * (value - mean);
+	}
+
+	double getMean() const {
+		return this->mean;
+	}
+
+	// Weighted (population) standard deviation
+	double getDeviation() const {
+		return (totalWeight > 0) ? std::sqrt(m2 / totalWeight) : 0;
+	}
+
+private:
+	double totalWeight;
+	double mean;
+	double m2;
+};
+
+// Fixed layout aggregates of a run. Telemetry datagrams carry it as is (little endian,
+// no padding), so the layout must stay stable between versions.
+struct StatisticsSample {
+	std::int64_t steps;
+	double time;				//[s]
+	double pathLength;			//[m] distance driven along the path
+	double totalRotation;		//[rad] sum of absolute heading changes
+	double netRotation;			//[rad]
+	double maxSpeed;			//[m/s] absolute
+	double meanSpeed;			//[m/s] over time, steps of game mode differ in length
+	double speedDeviation;		//[m/s] over time
+	double maxAngularSpeed;		//[rad/s] absolute
+	double leftTravel;			//[m] distance rolled by the left wheel
+	double rightTravel;			//[m]
+	double closureError;		//[m] distance from the start pose
+	double closureHeading;		//[rad] heading difference to the start pose, <-pi, pi>
+};
+static_assert(sizeof(StatisticsSample) == 104, "StatisticsSample layout changed");
+
+// Aggregates of a run updated once per physics step in O(1), so path length, rotation or
+// the closure error of a rectangle do not need a log to be post-processed. Wheel speeds are
+// constant over long stretches, so a step only extends the current segment; the distances
+// and moments of a segment are added when the speeds change.
+class RunStatistics {
+public:
+	RunStatistics() {
+		reset(0, 0, 0);
+	}
+
+	// Clears the aggregates, closure is measured against the given start pose
+	void reset(double x, double y, double phi) {
+		*this = RunStatistics(x, y, phi);
+	}
+
+	void addStep(double deltaTime, double v, double omega, double vLeft, double vRight) {
+		if (vLeft != segmentLeft || vRight != segmentRight) {
+			closeSegment();
+			segmentLeft = vLeft;
+			segmentRight = vRight;
+			segmentV = v;
+			segmentOmega = omega;
+		}
+		segmentSteps++;
+		segmentTime.add(deltaTime);
+	}
+
+	// Aggregates with the closure against the current pose
+	StatisticsSample getSample(double x, double y, double phi) const;
+
+	void saveState(SnapshotWriter& writer) {
+		writer.write(*this);
+	}
+
+	bool loadState(SnapshotReader& reader) {
+		return reader.read(*this);
+	}
+
+private:
+	std::int64_t steps;
+	KahanSum time;
+	KahanSum pathLength;
+	KahanSum totalRotation;
+	KahanSum netRotation;
+	KahanSum leftTravel;
+	KahanSum rightTravel;
+	RunningMoments speed;
+	double maxSpeed;
+	double maxAngularSpeed;
+
+	// Steps since the wheel speeds last changed
+	std::int64_t segmentSteps;
+	KahanSum segmentTime;
+	double segmentLeft;
+	double segmentRight;
+	double segmentV;
+	double segmentOmega;
+
+	double startX;
+	double startY;
+	double startPhi;
+
+	RunStatistics(double x, double y, double phi) {
+		steps = 0;
+		maxSpeed = 0;
+		maxAngularSpeed = 0;
+		segmentSteps = 0;
+		segmentLeft = 0;
+		segmentRight = 0;
+		segmentV = 0;
+		segmentOmega = 0;
+		startX = x;
+		startY = y;
+		startPhi = phi;
+	}
+
+	// Adds the current segment to the aggregates and starts a new one
+	void closeSegment();
+};
+
+// Multi-line summary for the headless commands
+void printStatistics(const StatisticsSample& sample);
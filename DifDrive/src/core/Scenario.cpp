@@ -0,0 +1,58 @@
+#include "Scenario.h"
+
+#include <algorithm>
+
+std::vector<ScenarioResult> runScenarios(const std::vector<ScenarioSpec>& specs, JobSystem& jobs) {
+	std::vector<ScenarioResult> results(specs.size());
+	std::vector<SimulationData> schedules(specs.size());
+	std::vector<long> stepCounts(specs.size(), -1);
+
+	// Only schedules are kept between the passes, vehicles live just while running
+	for (size_t i = 0; i < specs.size(); i++) {
+		jobs.submit([&, i] {
+			results[i].name = specs[i].name;
+			if (ScenarioRun::buildSchedule(specs[i], schedules[i]))
+				stepCounts[i] = ScenarioRun::getStepCount(schedules[i]);
+		});
+	}
+	jobs.wait();
+
+	std::vector<size_t> order;
+	for (size_t i = 0; i < specs.size(); i++) {
+		if (stepCounts[i] >= 0)
+			order.push_back(i);
+	}
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		return stepCounts[a] > stepCounts[b];
+	});
+
+	for (size_t i : order) {
+		jobs.submit([&, i] {
+			ScenarioRun run(specs[i], std::move(schedules[i]));
+			if (run.prepare())
+				results[i] = run.run();
+		});
+	}
+	jobs.wait();
+	return results;
+}
+
+std::vector<ScenarioSpec> makeManeuverSweep(long count) {
+	std::vector<ScenarioSpec> specs;
+	for (long i = 0; i < count; i++) {
+		ScenarioSpec spec;
+		spec.name = "sweep_" + std::to_string(i);
+		if (i % 2 == 0) {
+			spec.mode = SimulationMode::RECTANGLE;
+			spec.parameters[0] = 0.5 + (i % 10) * 0.1;
+		}
+		else {
+			spec.mode = SimulationMode::CURVE;
+			spec.parameters[0] = 0.5 + (i % 7) * 0.1;
+			spec.parameters[1] = 1;
+			spec.parameters[2] = 0.5 + (i % 5) * 0.1;
+		}
+		specs.push_back(spec);
+	}
+	return specs;
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Constants.h"
+#include "FileHandler.h"
+#include "JobSystem.h"
+#include "OccupancyGrid.h"
+#include "SimulationData.h"
+#include "Snapshot.h"
+#include "StopConditions.h"
+#include "TelemetryRing.h"
+#include "Vehicle.h"
+
+enum class SimulationMode {
+	VECTOR,
+	RECTANGLE,
+	CURVE,
+	GAME
+};
+
+// Description of one headless simulation, everything needed to rebuild it anywhere
+struct ScenarioSpec {
+	std::string name;
+	SimulationMode mode = SimulationMode::RECTANGLE;
+	double parameters[3] = { 1, 0, 0 };	// RECTANGLE: side, CURVE: R1, L1, R2
+	std::string scenarioFile;			// VECTOR
+	bool logEnabled = false;
+	StopConditions stop;
+};
+
+struct ScenarioResult {
+	std::string name;
+	bool valid = false;
+	long steps = 0;
+	double time = 0;
+	double x = 0;
+	double y = 0;
+	double phi = 0;
+	double wallTime = 0;
+	StopReason stopReason = StopReason::NONE;
+	StatisticsSample statistics = StatisticsSample();
+};
+
+// Vehicle + SimulationData + logger pipeline stepped with the fixed simulation step,
+// the same way as SIMULATION_MODE of the window application
+class ScenarioRun {
+public:
+	ScenarioRun(const ScenarioSpec& scenario) : vehicle(DEFAULT_WHEELBASE) {
+		spec = scenario;
+		scheduleReady = false;
+		stepCounter = 0;
+		totalSteps = 0;
+	}
+
+	// Run with schedule already built by buildSchedule()
+	ScenarioRun(const ScenarioSpec& scenario, SimulationData&& preparedData) : vehicle(DEFAULT_WHEELBASE), data(std::move(preparedData)) {
+		spec = scenario;
+		scheduleReady = true;
+		stepCounter = 0;
+		totalSteps = 0;
+	}
+
+	static bool buildSchedule(const ScenarioSpec& spec, SimulationData& data) {
+		switch (spec.mode) {
+		case SimulationMode::VECTOR:
+			return data.getSchedule().loadFromFile(spec.scenarioFile);
+		case SimulationMode::RECTANGLE:
+			data.setRectangleData(spec.parameters[0]);
+			return true;
+		case SimulationMode::CURVE:
+			data.setCurveData(spec.parameters[0], spec.parameters[1], spec.parameters[2]);
+			return true;
+		default:
+			std::cout << "Error: Scenario " << spec.name << " has no speed schedule" << std::endl;
+			return false;
+		}
+	}
+
+	// Run until the last speed change (usually the stop) has been applied
+	static long getStepCount(SimulationData& data) {
+		return static_cast<long>(ceil(data.getSchedule().getEndTime() * SIMULATION_SECOND_STEP_AMOUNT)) + 1;
+	}
+
+	bool prepare() {
+		if (!spec.stop.isBounded()) {
+			std::cout << "Error: Scenario " << spec.name << " has neither the schedule end nor a time limit as stop condition" << std::endl;
+			return false;
+		}
+		if (!scheduleReady && !buildSchedule(spec, data))
+			return false;
+		scheduleReady = true;
+		stopMonitor = StopMonitor(spec.stop);
+
+		totalSteps = getStepCount(data);
+		if (spec.logEnabled)
+			log = std::make_unique<FileHandler>(spec.name);
+		return true;
+	}
+
+	long getTotalSteps() {
+		return this->totalSteps;
+	}
+
+	long getStep() {
+		return this->stepCounter;
+	}
+
+	Vehicle& getVehicle() {
+		return this->vehicle;
+	}
+
+	SimulationData& getData() {
+		return this->data;
+	}
+
+	// Step counter, vehicle with wheels and trails, the schedule cursor and the progress of
+	// the stop conditions as one blob. Listeners, the telemetry ring and the log are not part
+	// of the state. Step counts are written as 64 bit, long is 32 bit on Windows.
+	void saveSnapshot(std::vector<char>& blob) {
+		blob.clear();
+		SnapshotWriter writer(blob);
+		writer.write(static_cast<std::uint32_t>(SNAPSHOT_MAGIC));
+		writer.write(static_cast<std::uint32_t>(SNAPSHOT_VERSION));
+		writer.write(static_cast<std::int64_t>(stepCounter));
+		writer.write(static_cast<std::int64_t>(totalSteps));
+		vehicle.saveState(writer);
+		data.getSchedule().saveState(writer);
+		stopMonitor.saveState(writer);
+	}
+
+	// Restores a snapshot taken from a run with the same schedule
+	bool restoreSnapshot(const std::vector<char>& blob) {
+		SnapshotReader reader(blob);
+		std::uint32_t magic = 0, version = 0;
+		std::int64_t savedStep = 0, savedTotal = 0;
+		size_t savedCursor = 0;
+		Vehicle savedVehicle = Vehicle(DEFAULT_WHEELBASE);
+		StopMonitor savedMonitor = stopMonitor;
+		VelocitySchedule& schedule = data.getSchedule();
+
+		if (!reader.read(magic) || magic != SNAPSHOT_MAGIC || !reader.read(version) || version != SNAPSHOT_VERSION) {
+			std::cout << "Error: Not a snapshot of version " << SNAPSHOT_VERSION << std::endl;
+			return false;
+		}
+		if (!reader.read(savedStep) || !reader.read(savedTotal) || !savedVehicle.loadState(reader)
+			|| !schedule.readState(reader, savedCursor) || !savedMonitor.loadState(reader) || !reader.isFinished()) {
+			std::cout << "Error: Snapshot of scenario " << spec.name << " is damaged or belongs to another schedule" << std::endl;
+			return false;
+		}
+		// Nothing changes unless the whole snapshot is valid
+		vehicle = std::move(savedVehicle);
+		schedule.setCursor(savedCursor);
+		stepCounter = static_cast<long>(savedStep);
+		totalSteps = static_cast<long>(savedTotal);
+		stopMonitor = savedMonitor;
+		return true;
+	}
+
+	// Independent copy continuing from the current step, e.g. to try variants of the rest
+	// of the schedule in parallel. The copy has no log and no listeners.
+	std::unique_ptr<ScenarioRun> fork() {
+		auto copy = std::make_unique<ScenarioRun>(spec, SimulationData(data));
+		copy->spec.logEnabled = false;
+		copy->vehicle = vehicle;
+		copy->stepCounter = stepCounter;
+		copy->totalSteps = totalSteps;
+		copy->stopMonitor = stopMonitor;
+		copy->world = world;
+		return copy;
+	}
+
+	void setTotalSteps(long steps) {
+		this->totalSteps = steps;
+	}
+
+	// Called with the state after every step, e.g. to publish telemetry
+	void setSampleListener(std::function<void(const VehicleSample&)> listener) {
+		this->sampleListener = listener;
+	}
+
+	void setTelemetryRing(TelemetryRing* ring) {
+		this->telemetryRing = ring;
+	}
+
+	// Map the footprint is checked against after every step, ends the run on a collision
+	void setWorld(const OccupancyGrid* occupancy) {
+		this->world = occupancy;
+	}
+
+	void step() {
+		data.setVehicleSpeed(getStepTime(stepCounter), vehicle);
+		vehicle.recalculate(SIMULATION_FIXED_STEP);
+		stepCounter++;
+		if (log)
+			log->writeVehicleState(getStepTime(stepCounter), stepCounter, vehicle);
+		if (sampleListener)
+			sampleListener(vehicle.getSample(getStepTime(stepCounter), stepCounter));
+		if (telemetryRing)
+			telemetryRing->write(vehicle.getSample(getStepTime(stepCounter), stepCounter));
+	}
+
+	// Stop conditions after the last step, totalSteps is the schedule end
+	StopReason checkStop() {
+		StopReason reason = stopMonitor.check(getStepTime(stepCounter), vehicle.getX(), vehicle.getY(),
+			vehicle.lWheel.getTangencialVel(), vehicle.rWheel.getTangencialVel(), stepCounter >= totalSteps);
+		if (reason == StopReason::NONE && world && world->collidesCircle(vehicle.getX(), vehicle.getY(), vehicle.getWheelbase() / 2))
+			reason = StopReason::COLLISION;
+		return reason;
+	}
+
+	// Steps until a stop condition triggers, the log is flushed before returning. Conditions
+	// on the pose and speeds are evaluated after a step, so a target at the start pose is
+	// reached when the vehicle comes back; schedule end and time limit also before the first.
+	ScenarioResult run() {
+		auto start = std::chrono::high_resolution_clock::now();
+		StopReason reason = stopMonitor.checkLimits(getStepTime(stepCounter), stepCounter >= totalSteps);
+		while (reason == StopReason::NONE) {
+			step();
+			reason = checkStop();
+		}
+		if (log)
+			log->flush();
+
+		ScenarioResult result;
+		result.name = spec.name;
+		result.valid = true;
+		result.steps = stepCounter;
+		result.time = getStepTime(stepCounter);
+		result.x = vehicle.getX();
+		result.y = vehicle.getY();
+		result.phi = vehicle.getPhi();
+		result.stopReason = reason;
+		result.statistics = vehicle.getStatistics();
+		result.wallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() * TIME_uS;
+		return result;
+	}
+
+private:
+	ScenarioSpec spec;
+	Vehicle vehicle;
+	SimulationData data;
+	std::unique_ptr<FileHandler> log;
+	std::function<void(const VehicleSample&)> sampleListener;
+	TelemetryRing* telemetryRing = nullptr;
+	const OccupancyGrid* world = nullptr;
+	StopMonitor stopMonitor;
+	bool scheduleReady;
+	long stepCounter;
+	long totalSteps;
+};
+
+// Runs independent scenarios on the job system. Longest scenarios are started first,
+// so the short ones fill the remaining cores instead of leaving a long tail at the end.
+std::vector<ScenarioResult> runScenarios(const std::vector<ScenarioSpec>& specs, JobSystem& jobs);
+
+// Rectangles and curves of different sizes, used by benchmarks and sweeps
+std::vector<ScenarioSpec> makeManeuverSweep(long count);
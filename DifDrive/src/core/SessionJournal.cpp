@@ -0,0 +1,194 @@
+#include "SessionJournal.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+bool SessionJournal::open(const std::string& path, Vehicle& vehicle) {
+	close();
+	file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cout << "Error: Could not open journal " << path << std::endl;
+		return false;
+	}
+
+	JournalHeader header = JournalHeader();
+	header.magic = JOURNAL_MAGIC;
+	header.version = JOURNAL_VERSION;
+	header.wheelbase = vehicle.getWheelbase();
+	header.integration = static_cast<std::uint32_t>(vehicle.getIntegrationMethod());
+	header.checkInterval = JOURNAL_CHECK_INTERVAL;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	this->vehicle = &vehicle;
+	enabled = true;
+	steps = 0;
+	hasDelta = false;
+	repeats = 0;
+	lastLeft = vehicle.lWheel.getTangencialVel();
+	lastRight = vehicle.rWheel.getTangencialVel();
+	writeTag(JOURNAL_WHEELS);
+	writeValue(lastLeft);
+	writeValue(lastRight);
+	writePose(JOURNAL_CHECK, vehicle);
+	std::cout << "Recording session to " << path << std::endl;
+	return true;
+}
+
+void SessionJournal::close() {
+	if (!enabled)
+		return;
+	flushRepeats();
+	writePose(JOURNAL_END, *vehicle);
+	file.close();
+	enabled = false;
+	vehicle = nullptr;
+}
+
+void SessionJournal::record(Vehicle& vehicle, double deltaTime) {
+	double left = vehicle.lWheel.getTangencialVel();
+	double right = vehicle.rWheel.getTangencialVel();
+	if (std::memcmp(&left, &lastLeft, sizeof(double)) != 0 || std::memcmp(&right, &lastRight, sizeof(double)) != 0) {
+		flushRepeats();
+		writeTag(JOURNAL_WHEELS);
+		writeValue(left);
+		writeValue(right);
+		lastLeft = left;
+		lastRight = right;
+	}
+
+	if (hasDelta && std::memcmp(&deltaTime, &lastDelta, sizeof(double)) == 0 && repeats < UINT32_MAX) {
+		repeats++;
+		return;
+	}
+	flushRepeats();
+	writeTag(JOURNAL_STEP);
+	writeValue(deltaTime);
+	lastDelta = deltaTime;
+	hasDelta = true;
+}
+
+void SessionJournal::flushRepeats() {
+	if (repeats == 0)
+		return;
+	writeTag(JOURNAL_REPEAT);
+	writeValue(repeats);
+	repeats = 0;
+}
+
+void SessionJournal::writePose(JournalTag tag, Vehicle& vehicle) {
+	flushRepeats();
+	writeTag(tag);
+	writeValue(steps);
+	writeValue(vehicle.getX());
+	writeValue(vehicle.getY());
+	writeValue(vehicle.getPhi());
+	// Keeps what led up to a crash on disk
+	file.flush();
+}
+
+namespace {
+	template <typename T>
+	bool readValue(const std::vector<char>& data, size_t& offset, T& value) {
+		if (offset + sizeof(T) > data.size())
+			return false;
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+}
+
+bool replaySessionJournal(const std::string& path, ReplayResult& result, FileHandler* trace) {
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		std::cout << "Error: Could not open journal " << path << std::endl;
+		return false;
+	}
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	size_t offset = 0;
+	JournalHeader header;
+	if (!readValue(data, offset, header) || header.magic != JOURNAL_MAGIC) {
+		std::cout << "Error: " << path << " is not a session journal" << std::endl;
+		return false;
+	}
+	if (header.version != JOURNAL_VERSION) {
+		std::cout << "Error: Journal version " << header.version << " is not supported" << std::endl;
+		return false;
+	}
+
+	result = ReplayResult();
+	Vehicle vehicle(header.wheelbase);
+	vehicle.setIntegrationMethod(static_cast<IntegrationMethod>(header.integration));
+	double deltaTime = 0;
+
+	auto step = [&]() {
+		vehicle.recalculate(deltaTime);
+		result.steps++;
+		result.simulatedTime += deltaTime;
+		if (trace != nullptr)
+			trace->writeVehicleState(result.simulatedTime, static_cast<long>(result.steps), vehicle);
+	};
+
+	while (offset < data.size()) {
+		std::uint8_t tag = static_cast<std::uint8_t>(data[offset++]);
+		bool valid = true;
+		switch (tag) {
+		case JOURNAL_STEP:
+			valid = readValue(data, offset, deltaTime);
+			if (valid)
+				step();
+			break;
+		case JOURNAL_REPEAT: {
+			std::uint32_t count = 0;
+			valid = readValue(data, offset, count);
+			for (std::uint32_t i = 0; valid && i < count; i++) {
+				step();
+			}
+			break;
+		}
+		case JOURNAL_WHEELS: {
+			double left = 0, right = 0;
+			valid = readValue(data, offset, left) && readValue(data, offset, right);
+			vehicle.lWheel.setTangencialVel(left);
+			vehicle.rWheel.setTangencialVel(right);
+			break;
+		}
+		case JOURNAL_RESET:
+			vehicle.resetPosition();
+			break;
+		case JOURNAL_CHECK:
+		case JOURNAL_END: {
+			std::int64_t recordedStep = 0;
+			double x = 0, y = 0, phi = 0;
+			valid = readValue(data, offset, recordedStep) && readValue(data, offset, x) && readValue(data, offset, y) && readValue(data, offset, phi);
+			if (!valid)
+				break;
+			double replayX = vehicle.getX(), replayY = vehicle.getY(), replayPhi = vehicle.getPhi();
+			bool match = recordedStep == result.steps && std::memcmp(&x, &replayX, sizeof(double)) == 0
+				&& std::memcmp(&y, &replayY, sizeof(double)) == 0 && std::memcmp(&phi, &replayPhi, sizeof(double)) == 0;
+			result.checks++;
+			if (!match) {
+				result.mismatches++;
+				if (result.firstMismatchStep < 0)
+					result.firstMismatchStep = recordedStep;
+				result.maxPositionError = std::max(result.maxPositionError, hypot(x - replayX, y - replayY));
+			}
+			if (tag == JOURNAL_END)
+				result.complete = true;
+			break;
+		}
+		default:
+			std::cout << "Error: Unknown journal record " << static_cast<int>(tag) << " at byte " << offset - 1 << std::endl;
+			return false;
+		}
+		// A session that crashed ends without its end record, everything before is still valid
+		if (!valid) {
+			std::cout << "Journal truncated at byte " << data.size() << ", replayed up to step " << result.steps << std::endl;
+			break;
+		}
+	}
+	result.statistics = vehicle.getStatistics();
+	return true;
+}
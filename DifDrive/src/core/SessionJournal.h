@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "FileHandler.h"
+#include "Vehicle.h"
+
+#define JOURNAL_MAGIC 0x4A524444			// "DDRJ" little endian
+#define JOURNAL_VERSION 1
+#define JOURNAL_CHECK_INTERVAL 256			//steps between recorded poses
+#define JOURNAL_DEFAULT_FILE "logData/session.ddj"
+
+// Binary journal of everything that moves a vehicle: the wheel speeds in effect for a step,
+// the step's delta time and position resets. The pose is recorded every few steps, so a
+// replay can check that it reproduces the session bit for bit. Records are a one byte tag
+// and a native endian payload; runs of steps with the same delta time are stored as a count.
+struct JournalHeader {
+	std::uint32_t magic;
+	std::uint32_t version;
+	double wheelbase;
+	std::uint32_t integration;
+	std::uint32_t checkInterval;
+};
+
+enum JournalTag : std::uint8_t {
+	JOURNAL_STEP = 'S',			// double dt
+	JOURNAL_REPEAT = 'R',		// uint32 count of further steps with the last dt
+	JOURNAL_WHEELS = 'W',		// double vL, double vR
+	JOURNAL_RESET = 'P',		// Vehicle::resetPosition
+	JOURNAL_CHECK = 'C',		// int64 step, double x, y, phi after the step
+	JOURNAL_END = 'E',			// int64 step, double x, y, phi at the end of the session
+};
+
+// Records a session when opened, otherwise only forwards the calls to the vehicle, so the
+// window application steps the vehicle through it either way
+class SessionJournal {
+public:
+	~SessionJournal() {
+		close();
+	}
+
+	// The vehicle has to stay alive until close, its final pose ends the journal
+	bool open(const std::string& path, Vehicle& vehicle);
+	void close();
+
+	bool isEnabled() {
+		return this->enabled;
+	}
+
+	void step(Vehicle& vehicle, double deltaTime) {
+		if (enabled)
+			record(vehicle, deltaTime);
+		vehicle.recalculate(deltaTime);
+		if (enabled && ++steps % JOURNAL_CHECK_INTERVAL == 0)
+			writePose(JOURNAL_CHECK, vehicle);
+	}
+
+	void resetPosition(Vehicle& vehicle) {
+		vehicle.resetPosition();
+		if (enabled) {
+			flushRepeats();
+			writeTag(JOURNAL_RESET);
+			lastLeft = vehicle.lWheel.getTangencialVel();
+			lastRight = vehicle.rWheel.getTangencialVel();
+		}
+	}
+
+private:
+	std::ofstream file;
+	bool enabled = false;
+	std::int64_t steps = 0;
+	double lastLeft = 0;
+	double lastRight = 0;
+	double lastDelta = 0;
+	bool hasDelta = false;
+	std::uint32_t repeats = 0;
+	Vehicle* vehicle = nullptr;
+
+	void record(Vehicle& vehicle, double deltaTime);
+	void flushRepeats();
+	void writePose(JournalTag tag, Vehicle& vehicle);
+
+	void writeTag(JournalTag tag) {
+		file.put(static_cast<char>(tag));
+	}
+
+	template <typename T>
+	void writeValue(T value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+};
+
+struct ReplayResult {
+	std::int64_t steps = 0;
+	std::int64_t checks = 0;
+	std::int64_t mismatches = 0;
+	std::int64_t firstMismatchStep = -1;
+	double simulatedTime = 0;
+	double maxPositionError = 0;
+	bool complete = false;			// journal ended with its end record
+	StatisticsSample statistics = StatisticsSample();	// since the last position reset
+};
+
+// Re-executes a journal headless and compares every recorded pose bitwise. The optional
+// trace receives the state after every step in the usual log format.
+bool replaySessionJournal(const std::string& path, ReplayResult& result, FileHandler* trace = nullptr);
@@ -0,0 +1,105 @@
+#include "SharedMemory.h"
+
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+SharedMemory::SharedMemory() {
+	data = nullptr;
+	size = 0;
+	owner = false;
+#ifdef _WIN32
+	mappingHandle = NULL;
+#else
+	fileDescriptor = -1;
+#endif
+}
+
+bool SharedMemory::create(const std::string& memoryName, size_t memorySize) {
+	close();
+	name = memoryName;
+	size = memorySize;
+	owner = true;
+#ifdef _WIN32
+	mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32), static_cast<DWORD>(size), ("Local\\" + name).c_str());
+	if (mappingHandle == NULL)
+		return failed("create");
+	data = MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#else
+	shm_unlink(("/" + name).c_str());
+	fileDescriptor = shm_open(("/" + name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fileDescriptor < 0 || ftruncate(fileDescriptor, size) != 0)
+		return failed("create");
+	data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+	if (data == MAP_FAILED)
+		data = nullptr;
+#endif
+	if (data == nullptr)
+		return failed("map");
+	memset(data, 0, size);
+	return true;
+}
+
+bool SharedMemory::open(const std::string& memoryName) {
+	close();
+	name = memoryName;
+	owner = false;
+#ifdef _WIN32
+	mappingHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, ("Local\\" + name).c_str());
+	if (mappingHandle == NULL)
+		return failed("open");
+	data = MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	MEMORY_BASIC_INFORMATION info;
+	if (data != nullptr && VirtualQuery(data, &info, sizeof(info)) != 0)
+		size = info.RegionSize;
+#else
+	fileDescriptor = shm_open(("/" + name).c_str(), O_RDWR, 0600);
+	struct stat info;
+	if (fileDescriptor < 0 || fstat(fileDescriptor, &info) != 0)
+		return failed("open");
+	size = static_cast<size_t>(info.st_size);
+	data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+	if (data == MAP_FAILED)
+		data = nullptr;
+#endif
+	if (data == nullptr)
+		return failed("map");
+	return true;
+}
+
+void SharedMemory::close() {
+#ifdef _WIN32
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mappingHandle != NULL)
+		CloseHandle(mappingHandle);
+	mappingHandle = NULL;
+#else
+	if (data != nullptr)
+		munmap(data, size);
+	if (fileDescriptor >= 0)
+		::close(fileDescriptor);
+	if (fileDescriptor >= 0 && owner)
+		shm_unlink(("/" + name).c_str());
+	fileDescriptor = -1;
+#endif
+	data = nullptr;
+	size = 0;
+}
+
+bool SharedMemory::failed(const std::string& action) {
+	std::cout << "Error: Could not " << action << " shared memory " << name << std::endl;
+	close();
+	return false;
+}
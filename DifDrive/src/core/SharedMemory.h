@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// Named memory block shared between processes (POSIX shm_open or Windows file mapping)
+class SharedMemory {
+public:
+	SharedMemory();
+
+	~SharedMemory() {
+		close();
+	}
+
+	SharedMemory(const SharedMemory&) = delete;
+	SharedMemory& operator=(const SharedMemory&) = delete;
+
+	bool create(const std::string& memoryName, size_t memorySize);
+	bool open(const std::string& memoryName);
+	void close();
+
+	void* getData() {
+		return this->data;
+	}
+
+	size_t getSize() {
+		return this->size;
+	}
+
+private:
+	std::string name;
+	void* data;
+	size_t size;
+	bool owner;
+
+#ifdef _WIN32
+	void* mappingHandle;	// HANDLE
+#else
+	int fileDescriptor;
+#endif
+
+	bool failed(const std::string& action);
+};
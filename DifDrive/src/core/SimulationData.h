@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Constants.h"
+#include "VelocitySchedule.h"
+#include "Vehicle.h"
+
+// Wheel speed schedules of the built-in scenarios
+class SimulationData {
+public:
+	SimulationData() {
+		schedule = VelocitySchedule();
+
+		rectangleSide = 0;
+
+		r1 = 0; l = 0; r2 = 0;
+
+		wheelbase = DEFAULT_WHEELBASE;
+	}
+
+	// Wheelbase of the vehicle the built-in schedules are generated for, set it before them
+	void setWheelbase(double vehicleWheelbase) {
+		this->wheelbase = vehicleWheelbase;
+	}
+
+	void setRectangleData(double side) {
+		this->rectangleSide = side;
+		calculateRectangleData();
+	}
+
+	void setCurveData(double radius1, double distance, double radius2) {
+		this->r1 = radius1;
+		this->l = distance;
+		this->r2 = radius2;
+		calculateCurvaData();
+	}
+
+	void setFixedVectorData() {
+		schedule.clear();
+		schedule.addBreakpoint(0, 2, 2);
+		schedule.addBreakpoint(5, -1, 1);
+		schedule.addBreakpoint(10, 0, 0);
+		schedule.addBreakpoint(15, 2, -2);
+		schedule.addBreakpoint(20, 1, 1);
+	}
+	void calculateRectangleData() {
+		schedule.clear();
+
+		double calcTime = 1; // [s]
+		double omegaT = degToRad(-90) / (calcTime);
+		double time = 0;
+
+		for (int i = 0; i < 4; i++) {
+			schedule.addBreakpoint(time, this->rectangleSide / (calcTime), this->rectangleSide / (calcTime));
+			time += calcTime;
+
+			schedule.addBreakpoint(time, +(this->wheelbase * omegaT) / 2, -(this->wheelbase * omegaT) / 2);
+			time += calcTime;
+		}
+		schedule.addBreakpoint(time, 0, 0);
+	}
+
+	void calculateCurvaData() {
+		schedule.clear();
+
+		double calcTime = 1; // [s]
+		double omegaT, vT;
+		double time = 0;
+
+		omegaT = degToRad(90) / (calcTime);
+		vT = (degToRad(90) * r1) / (calcTime);
+		schedule.addBreakpoint(time, ((2 * vT) + (this->wheelbase * omegaT)) / 2, ((2 * vT) - (this->wheelbase * omegaT)) / 2);
+		time += calcTime;
+
+		schedule.addBreakpoint(time, this->l / (calcTime), this->l / (calcTime));
+		time += calcTime;
+
+		omegaT = degToRad(-90) / (calcTime);
+		vT = (degToRad(90) * r2) / (calcTime);
+		schedule.addBreakpoint(time, ((2 * vT) + (this->wheelbase * omegaT)) / 2, ((2 * vT) - (this->wheelbase * omegaT)) / 2);
+		time += calcTime;
+
+		schedule.addBreakpoint(time, 0, 0);
+	}
+
+	template <typename Geometry, typename Real>
+	void setVehicleSpeed(double time, BasicVehicle<Geometry, Real>& vehicle) {
+		double speedL, speedR;
+		if (schedule.getSpeeds(time, speedL, speedR)) { // last speed change with time < current time
+			vehicle.lWheel.setTangencialVel(speedL);
+			vehicle.rWheel.setTangencialVel(speedR);
+		}
+	}
+
+	VelocitySchedule& getSchedule() {
+		return this->schedule;
+	}
+
+private:
+	VelocitySchedule schedule;
+	double rectangleSide;
+	double r1;
+	double l;
+	double r2;
+	double wheelbase;
+};
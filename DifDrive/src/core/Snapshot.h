@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <type_traits>
+#include <vector>
+
+#define SNAPSHOT_MAGIC 0x53534444		// "DDSS" little endian
+#define SNAPSHOT_VERSION 7
+
+// Appends plain values to a snapshot blob, native endian like the other binary formats
+class SnapshotWriter {
+public:
+	SnapshotWriter(std::vector<char>& target) : blob(target) {
+	}
+
+	template <typename T>
+	void write(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "snapshot values are copied bytewise");
+		size_t offset = blob.size();
+		blob.resize(offset + sizeof(T));
+		std::memcpy(blob.data() + offset, &value, sizeof(T));
+	}
+
+	template <typename T>
+	void write(const std::deque<T>& values) {
+		write(static_cast<std::uint64_t>(values.size()));
+		size_t offset = blob.size();
+		blob.resize(offset + values.size() * sizeof(T));
+		char* target = blob.data() + offset;
+		for (const T& value : values) {
+			std::memcpy(target, &value, sizeof(T));
+			target += sizeof(T);
+		}
+	}
+
+private:
+	std::vector<char>& blob;
+};
+
+// Reads a blob written by SnapshotWriter; after the first failed read every read fails
+class SnapshotReader {
+public:
+	SnapshotReader(const std::vector<char>& source) : blob(source) {
+		offset = 0;
+		failed = false;
+	}
+
+	template <typename T>
+	bool read(T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "snapshot values are copied bytewise");
+		if (failed || offset + sizeof(T) > blob.size()) {
+			failed = true;
+			return false;
+		}
+		std::memcpy(&value, blob.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	template <typename T>
+	bool read(std::deque<T>& values) {
+		std::uint64_t count = 0;
+		if (!read(count) || count > (blob.size() - offset) / sizeof(T)) {
+			failed = true;
+			return false;
+		}
+		const char* source = blob.data() + offset;
+		values.resize(count);
+		for (T& value : values) {
+			std::memcpy(&value, source, sizeof(T));
+			source += sizeof(T);
+		}
+		offset += count * sizeof(T);
+		return true;
+	}
+
+	bool isFinished() {
+		return !failed && offset == blob.size();
+	}
+
+private:
+	const std::vector<char>& blob;
+	size_t offset;
+	bool failed;
+};
@@ -0,0 +1,96 @@
+#include "StopConditions.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+const char* getStopReasonName(StopReason reason) {
+	switch (reason) {
+	case StopReason::SCHEDULE_END:
+		return "schedule_end";
+	case StopReason::TIME_LIMIT:
+		return "time_limit";
+	case StopReason::POSE_REACHED:
+		return "pose_reached";
+	case StopReason::LEFT_BOUNDS:
+		return "left_bounds";
+	case StopReason::STANDSTILL:
+		return "standstill";
+	case StopReason::COLLISION:
+		return "collision";
+	default:
+		return "none";
+	}
+}
+
+// Numbers separated by ':', false unless exactly count of them parse completely
+static bool parseValues(const std::string& text, size_t count, std::vector<double>& values) {
+	values.clear();
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ':')) {
+		size_t used = 0;
+		try {
+			values.push_back(std::stod(item, &used));
+		}
+		catch (const std::exception&) {
+			return false;
+		}
+		if (used != item.size())
+			return false;
+	}
+	return values.size() == count;
+}
+
+bool parseStopConditions(const std::string& text, StopConditions& conditions) {
+	StopConditions parsed;
+	std::stringstream stream(text);
+	std::string entry;
+	while (std::getline(stream, entry, ',')) {
+		if (entry.empty())
+			continue;
+		size_t separator = entry.find('=');
+		std::string key = entry.substr(0, separator);
+		std::string value = (separator == std::string::npos) ? "" : entry.substr(separator + 1);
+		std::vector<double> values;
+
+		bool valid = true;
+		if (key == "schedule" && parseValues(value, 1, values)) {
+			parsed.scheduleEnd = values[0] != 0;
+		}
+		else if (key == "time" && parseValues(value, 1, values) && values[0] > 0) {
+			parsed.timeLimit = values[0];
+		}
+		else if (key == "pose" && parseValues(value, 3, values) && values[2] >= 0) {
+			parsed.poseTarget = true;
+			parsed.targetX = values[0];
+			parsed.targetY = values[1];
+			parsed.targetTolerance = values[2];
+		}
+		else if (key == "box" && parseValues(value, 4, values) && values[0] < values[2] && values[1] < values[3]) {
+			parsed.bounds = true;
+			parsed.minX = values[0];
+			parsed.minY = values[1];
+			parsed.maxX = values[2];
+			parsed.maxY = values[3];
+		}
+		else if (key == "still" && parseValues(value, 2, values) && values[0] > 0 && values[1] >= 0) {
+			parsed.standstillSpeed = values[0];
+			parsed.standstillTime = values[1];
+		}
+		else {
+			valid = false;
+		}
+
+		if (!valid) {
+			std::cout << "Error: Invalid stop condition \"" << entry << "\"" << std::endl;
+			return false;
+		}
+	}
+	if (!parsed.isBounded()) {
+		std::cout << "Error: Stop conditions need the schedule end or a time limit" << std::endl;
+		return false;
+	}
+	conditions = parsed;
+	return true;
+}
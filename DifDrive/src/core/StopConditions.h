@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+#include "Snapshot.h"
+
+enum class StopReason {
+	NONE,
+	SCHEDULE_END,	// last speed change of the schedule applied
+	TIME_LIMIT,
+	POSE_REACHED,	// within tolerance of the target position
+	LEFT_BOUNDS,	// outside the bounding box
+	STANDSTILL,		// both wheels slower than the threshold for long enough
+	COLLISION		// footprint touches an occupied cell of the world map
+};
+
+const char* getStopReasonName(StopReason reason);
+
+// Declarative end of a headless run, disabled conditions never trigger
+struct StopConditions {
+	bool scheduleEnd = true;
+	double timeLimit = 0;			//[s], 0 = none
+
+	bool poseTarget = false;
+	double targetX = 0;				//[m]
+	double targetY = 0;				//[m]
+	double targetTolerance = 0;		//[m]
+
+	bool bounds = false;
+	double minX = 0;				//[m]
+	double minY = 0;				//[m]
+	double maxX = 0;				//[m]
+	double maxY = 0;				//[m]
+
+	double standstillSpeed = 0;		//[m/s] of both wheels, 0 = none
+	double standstillTime = 0;		//[s]
+
+	// Schedule end or time limit, without one of them a run may never end
+	bool isBounded() const {
+		return scheduleEnd || timeLimit > 0;
+	}
+};
+
+// Comma separated list, e.g. "time=30,pose=1:0:0.01,box=-5:-5:5:5,still=0.001:2,schedule=0"
+//   schedule=0/1                  stop after the last speed change (default 1)
+//   time=<s>                      time limit
+//   pose=<x>:<y>:<tolerance>      target position reached [m] after it was left once, so
+//                                 the start position is a return to start target
+//   box=<minX>:<minY>:<maxX>:<maxY> bounding box left [m]
+//   still=<speed>:<s>             both wheels below speed [m/s] for the time, after they
+//                                 were faster once (a vehicle waiting to start is not stopped)
+bool parseStopConditions(const std::string& text, StopConditions& conditions);
+
+// Evaluates the conditions after every step with a few comparisons
+class StopMonitor {
+public:
+	StopMonitor(const StopConditions& stopConditions = StopConditions()) {
+		conditions = stopConditions;
+		toleranceSquared = conditions.targetTolerance * conditions.targetTolerance;
+		standstillSince = -1;
+		moved = false;
+		departed = false;
+	}
+
+	void reset() {
+		this->standstillSince = -1;
+		this->moved = false;
+		this->departed = false;
+	}
+
+	const StopConditions& getConditions() {
+		return this->conditions;
+	}
+
+	// Progress of the pose and standstill conditions, the conditions belong to the scenario
+	void saveState(SnapshotWriter& writer) const {
+		writer.write(standstillSince);
+		writer.write(moved);
+		writer.write(departed);
+	}
+
+	bool loadState(SnapshotReader& reader) {
+		return reader.read(standstillSince) && reader.read(moved) && reader.read(departed);
+	}
+
+	// Schedule end and time limit only, the conditions that hold before the first step
+	StopReason checkLimits(double time, bool scheduleDone) const {
+		if (conditions.scheduleEnd && scheduleDone)
+			return StopReason::SCHEDULE_END;
+		if (conditions.timeLimit > 0 && time >= conditions.timeLimit)
+			return StopReason::TIME_LIMIT;
+		return StopReason::NONE;
+	}
+
+	StopReason check(double time, double x, double y, double vLeft, double vRight, bool scheduleDone) {
+		StopReason limit = checkLimits(time, scheduleDone);
+		if (limit != StopReason::NONE)
+			return limit;
+		if (conditions.poseTarget) {
+			double dx = x - conditions.targetX, dy = y - conditions.targetY;
+			if (dx * dx + dy * dy > toleranceSquared)
+				departed = true;
+			else if (departed)
+				return StopReason::POSE_REACHED;
+		}
+		if (conditions.bounds && (x < conditions.minX || x > conditions.maxX || y < conditions.minY || y > conditions.maxY))
+			return StopReason::LEFT_BOUNDS;
+		if (conditions.standstillSpeed > 0) {
+			if (std::fabs(vLeft) < conditions.standstillSpeed && std::fabs(vRight) < conditions.standstillSpeed) {
+				if (moved && standstillSince < 0)
+					standstillSince = time;
+				if (moved && time - standstillSince >= conditions.standstillTime)
+					return StopReason::STANDSTILL;
+			}
+			else {
+				standstillSince = -1;
+				moved = true;
+			}
+		}
+		return StopReason::NONE;
+	}
+
+private:
+	StopConditions conditions;
+	double toleranceSquared;
+	double standstillSince;		//[s], -1 while moving
+	bool moved;					// wheels were faster than the standstill speed once
+	bool departed;				// outside the target tolerance once
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "SharedMemory.h"
+#include "Vehicle.h"
+
+#define RING_MAGIC 0x52534444			// "DDSR"
+#define RING_VERSION 1
+#define RING_DEFAULT_NAME "DifDriveTelemetry"
+#define RING_DEFAULT_CAPACITY 65536		//records, power of two
+
+// Shared memory ring of VehicleSample records with one writer and any number of readers,
+// each keeping its own cursor. Every slot carries a seqlock sequence, odd while the writer
+// copies the record in and even when complete, so readers detect torn and overwritten
+// records without any lock or syscall on either side.
+struct TelemetryRingHeader {
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t capacity;
+	std::uint32_t recordSize;
+	alignas(64) std::atomic<std::uint64_t> writeIndex;	// number of completed records
+};
+
+struct TelemetryRingSlot {
+	std::atomic<std::uint64_t> sequence;	// 2 * record + 1 while writing, 2 * record + 2 when complete
+	VehicleSample sample;
+};
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared memory ring needs lock free 64 bit atomics");
+static_assert(sizeof(TelemetryRingSlot) == 128, "TelemetryRingSlot layout changed");
+
+class TelemetryRing {
+public:
+	TelemetryRing() {
+		header = nullptr;
+		slots = nullptr;
+		mask = 0;
+		writeIndex = 0;
+	}
+
+	bool create(const std::string& name, std::uint32_t capacity) {
+		if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+			std::cout << "Error: Ring capacity must be a power of two" << std::endl;
+			return false;
+		}
+		if (!memory.create(name, sizeof(TelemetryRingHeader) + static_cast<size_t>(capacity) * sizeof(TelemetryRingSlot)))
+			return false;
+
+		header = new (memory.getData()) TelemetryRingHeader();
+		header->magic = RING_MAGIC;
+		header->version = RING_VERSION;
+		header->capacity = capacity;
+		header->recordSize = sizeof(VehicleSample);
+		header->writeIndex.store(0, std::memory_order_release);
+		slots = reinterpret_cast<TelemetryRingSlot*>(static_cast<char*>(memory.getData()) + sizeof(TelemetryRingHeader));
+		mask = capacity - 1;
+		writeIndex = 0;
+		std::cout << "Telemetry ring " << name << ", " << capacity << " records" << std::endl;
+		return true;
+	}
+
+	bool isEnabled() {
+		return this->header != nullptr;
+	}
+
+	void write(const VehicleSample& sample) {
+		TelemetryRingSlot& slot = slots[writeIndex & mask];
+		slot.sequence.store(2 * writeIndex + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&slot.sample, &sample, sizeof(VehicleSample));
+		slot.sequence.store(2 * writeIndex + 2, std::memory_order_release);
+		writeIndex++;
+		header->writeIndex.store(writeIndex, std::memory_order_release);
+	}
+
+private:
+	SharedMemory memory;
+	TelemetryRingHeader* header;
+	TelemetryRingSlot* slots;
+	std::uint64_t mask;
+	std::uint64_t writeIndex;
+};
+
+// Reader side of TelemetryRing, usable from any process that knows the ring name
+class TelemetryRingReader {
+public:
+	TelemetryRingReader() {
+		header = nullptr;
+		slots = nullptr;
+		mask = 0;
+		cursor = 0;
+		lostRecords = 0;
+		tornReads = 0;
+	}
+
+	// Starts at the newest record, so only records written from now on are read
+	bool open(const std::string& name) {
+		if (!memory.open(name))
+			return false;
+		header = static_cast<TelemetryRingHeader*>(memory.getData());
+		if (memory.getSize() < sizeof(TelemetryRingHeader) || header->magic != RING_MAGIC || header->version != RING_VERSION || header->recordSize != sizeof(VehicleSample)) {
+			std::cout << "Error: " << name << " is not a compatible telemetry ring" << std::endl;
+			memory.close();
+			header = nullptr;
+			return false;
+		}
+		slots = reinterpret_cast<TelemetryRingSlot*>(static_cast<char*>(memory.getData()) + sizeof(TelemetryRingHeader));
+		mask = header->capacity - 1;
+		cursor = header->writeIndex.load(std::memory_order_acquire);
+		return true;
+	}
+
+	// Copies the next record, returns false when the reader caught up with the writer
+	bool read(VehicleSample& sample) {
+		while (true) {
+			std::uint64_t written = header->writeIndex.load(std::memory_order_acquire);
+			if (cursor >= written)
+				return false;
+			if (written - cursor > header->capacity) {
+				lostRecords += written - header->capacity - cursor;
+				cursor = written - header->capacity;
+			}
+
+			TelemetryRingSlot& slot = slots[cursor & mask];
+			std::uint64_t expected = 2 * cursor + 2;
+			if (slot.sequence.load(std::memory_order_acquire) == expected) {
+				memcpy(&sample, &slot.sample, sizeof(VehicleSample));
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+					cursor++;
+					return true;
+				}
+				tornReads++;
+			}
+			// Writer already reused the slot, the record is gone
+			lostRecords++;
+			cursor++;
+		}
+	}
+
+	std::uint64_t getLostRecords() {
+		return this->lostRecords;
+	}
+
+	std::uint64_t getTornReads() {
+		return this->tornReads;
+	}
+
+private:
+	SharedMemory memory;
+	TelemetryRingHeader* header;
+	TelemetryRingSlot* slots;
+	std::uint64_t mask;
+	std::uint64_t cursor;
+	std::uint64_t lostRecords;
+	std::uint64_t tornReads;
+};
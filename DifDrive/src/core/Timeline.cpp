@@ -0,0 +1,49 @@
+#include "Timeline.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include "Constants.h"
+
+long Timeline::seek(long step, Vehicle& vehicle, SimulationData& data) {
+	if (keyframes.empty()) {
+		std::cout << "Error: Timeline has no keyframes" << std::endl;
+		return -1;
+	}
+	step = std::clamp(step, keyframes.front().step, lastStep);
+
+	auto keyframe = std::upper_bound(keyframes.begin(), keyframes.end(), step, [](long value, const Keyframe& frame) {
+		return value < frame.step;
+	}) - 1;
+	SnapshotReader reader(keyframe->state);
+	size_t keyframeCursor = 0;
+	if (!keyframeVehicle.loadState(reader) || !data.getSchedule().readState(reader, keyframeCursor)) {
+		std::cout << "Error: Keyframe of step " << keyframe->step << " does not match the schedule" << std::endl;
+		return -1;
+	}
+	// Vehicle and schedule stay untouched unless the whole keyframe is valid
+	std::swap(vehicle, keyframeVehicle);
+	data.getSchedule().setCursor(keyframeCursor);
+
+	// Same step as the window application and ScenarioRun
+	for (long current = keyframe->step; current < step; current++) {
+		data.setVehicleSpeed(getStepTime(current), vehicle);
+		vehicle.recalculate(SIMULATION_FIXED_STEP);
+	}
+	return step - keyframe->step;
+}
+
+void Timeline::thin() {
+	interval *= 2;
+	std::vector<Keyframe> kept;
+	kept.reserve(keyframes.size() / 2 + 1);
+	memoryUsage = 0;
+	for (Keyframe& keyframe : keyframes) {
+		if (keyframe.step % interval == 0 || &keyframe == &keyframes.front()) {
+			memoryUsage += sizeof(Keyframe) + keyframe.state.capacity();
+			kept.push_back(std::move(keyframe));
+		}
+	}
+	keyframes = std::move(kept);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "SimulationData.h"
+#include "Snapshot.h"
+#include "Vehicle.h"
+#include "VelocitySchedule.h"
+
+#define TIMELINE_DEFAULT_INTERVAL 200					//steps between keyframes
+#define TIMELINE_DEFAULT_BUDGET (64 * 1024 * 1024)		//bytes of keyframes
+
+// Keyframes of a fixed step, schedule driven run for seeking to any past step. A seek
+// restores the nearest earlier keyframe and simulates forward, so it costs at most one
+// keyframe interval of steps. When the keyframes outgrow the memory budget every other
+// one is dropped and the interval doubles.
+class Timeline {
+public:
+	Timeline(long keyframeInterval = TIMELINE_DEFAULT_INTERVAL, size_t memoryBudget = TIMELINE_DEFAULT_BUDGET) : keyframeVehicle(DEFAULT_WHEELBASE) {
+		interval = std::max(1L, keyframeInterval);
+		budget = memoryBudget;
+		memoryUsage = 0;
+		lastStep = -1;
+	}
+
+	void clear() {
+		keyframes.clear();
+		memoryUsage = 0;
+		lastStep = -1;
+	}
+
+	bool empty() {
+		return this->keyframes.empty();
+	}
+
+	// Called with the state the run starts from and then with the state after every step
+	void record(long step, Vehicle& vehicle, VelocitySchedule& schedule) {
+		lastStep = step;
+		if (!keyframes.empty() && (step % interval != 0 || keyframes.back().step >= step))
+			return;
+
+		keyframes.push_back(Keyframe());
+		keyframes.back().step = step;
+		SnapshotWriter writer(keyframes.back().state);
+		vehicle.saveState(writer);
+		schedule.saveState(writer);
+		keyframes.back().state.shrink_to_fit();
+		memoryUsage += sizeof(Keyframe) + keyframes.back().state.capacity();
+
+		while (memoryUsage > budget && keyframes.size() > 1) {
+			thin();
+		}
+	}
+
+	long getFirstStep() {
+		return keyframes.empty() ? -1 : keyframes.front().step;
+	}
+
+	long getLastStep() {
+		return this->lastStep;
+	}
+
+	long getInterval() {
+		return this->interval;
+	}
+
+	size_t getKeyframeCount() {
+		return this->keyframes.size();
+	}
+
+	size_t getMemoryUsage() {
+		return this->memoryUsage;
+	}
+
+	// Puts the vehicle and the schedule cursor of data into the state after the given step,
+	// clamped to the recorded range. Returns the number of re-simulated steps, -1 on error.
+	long seek(long step, Vehicle& vehicle, SimulationData& data);
+
+private:
+	struct Keyframe {
+		long step;
+		std::vector<char> state;
+	};
+
+	std::vector<Keyframe> keyframes;
+	long interval;
+	size_t budget;
+	size_t memoryUsage;
+	long lastStep;
+	Vehicle keyframeVehicle;	// a keyframe is loaded here first, swapped in once it is valid
+
+	void thin();
+};
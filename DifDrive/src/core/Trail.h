@@ -0,0 +1,83 @@
+#pragma once
+
+#include <deque>
+#include <cstddef>
+
+#include "Constants.h"
+#include "Snapshot.h"
+
+// Last positions of a point, every (spacing + 1)-th position is kept
+template <typename Real>
+class BasicTrail {
+public:
+	BasicTrail() {
+		oldX = std::deque<Real>();
+		oldY = std::deque<Real>();
+
+		changeTrailSettings(DEFAULT_TRAIL_LEN, 1);
+	}
+
+	// Fixed length and spacing (points skipped between two trail points)
+	void changeTrailSettings(int length, int spacing) {
+		trailLength = length;
+		trailSpacing = spacing;
+		trailCounter = 0;
+	}
+
+	void addTrailPoint(Real x, Real y) {
+		if (trailCounter >= trailSpacing) {
+			oldX.push_front(x);
+			oldY.push_front(y);
+			if (oldX.size() > trailLength) {
+				oldX.pop_back();
+				oldY.pop_back();
+			}
+			trailCounter = 0;
+		}
+		else {
+			trailCounter++;
+		}
+	}
+
+	void deleteTrail() {
+		oldX.clear();
+		oldY.clear();
+		trailCounter = 0;
+	}
+
+	// Newest point has index 0
+	size_t getSize() {
+		return this->oldX.size();
+	}
+
+	Real getX(size_t index) {
+		return this->oldX[index];
+	}
+
+	Real getY(size_t index) {
+		return this->oldY[index];
+	}
+
+	void saveState(SnapshotWriter& writer) {
+		writer.write(trailSpacing);
+		writer.write(trailLength);
+		writer.write(trailCounter);
+		writer.write(oldX);
+		writer.write(oldY);
+	}
+
+	bool loadState(SnapshotReader& reader) {
+		return reader.read(trailSpacing) && reader.read(trailLength) && reader.read(trailCounter)
+			&& reader.read(oldX) && reader.read(oldY) && oldX.size() == oldY.size();
+	}
+
+private:
+	int trailSpacing;
+	int trailLength;
+	int trailCounter;
+
+	std::deque<Real> oldX;
+	std::deque<Real> oldY;
+};
+
+using Trail = BasicTrail<double>;
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+
+#include "Constants.h"
+#include "Integration.h"
+#include "Kinematics.h"
+#include "RunStatistics.h"
+#include "Trail.h"
+#include "Wheel.h"
+
+// Fixed layout state after one physics step. Telemetry datagrams carry it as is
+// (little endian, no padding), so the layout must stay stable between versions.
+struct VehicleSample {
+	double time;		//[s]
+	std::int64_t step;
+	double x;			//[m]
+	double y;			//[m]
+	double phi;			//[rad]
+	double vT;			//[m/s]
+	double omegaT;		//[rad/s]
+	double vL;			//[m/s]
+	double omegaL;		//[rad/s]
+	double xL;			//[m]
+	double yL;			//[m]
+	double vR;			//[m/s]
+	double omegaR;		//[rad/s]
+	double xR;			//[m]
+	double yR;			//[m]
+};
+static_assert(sizeof(VehicleSample) == 120, "VehicleSample layout changed");
+
+// Vehicle on any geometry policy of Kinematics.h with its state and integration in Real,
+// Vehicle takes its dimensions at run time and computes in double
+template <typename Geometry, typename Real = double>
+class BasicVehicle {
+public:
+	BasicWheel<Geometry, Real> lWheel;
+	BasicWheel<Geometry, Real> rWheel;
+
+	explicit BasicVehicle(const Geometry& vehicleGeometry = Geometry())
+		: lWheel(vehicleGeometry), rWheel(vehicleGeometry) {
+		geometry = vehicleGeometry;
+		omegaT = 0;
+		vT = 0;
+
+		phiT = 0;
+		d_x = 0;
+		d_y = 0;
+		x = 0;
+		y = 0;
+
+		integration = IntegrationMethod::EULER;
+
+		trail = BasicTrail<Real>();
+	}
+
+	// Runtime geometry with the default wheel radius
+	BasicVehicle(double wheelbase) : BasicVehicle(Geometry(wheelbase)) {
+	}
+
+	IntegrationMethod getIntegrationMethod() {
+		return this->integration;
+	}
+
+	void setIntegrationMethod(IntegrationMethod method) {
+		this->integration = method;
+	}
+
+	double getWheelbase() {
+		return geometry.getWheelbase();
+	}
+
+	const Geometry& getGeometry() {
+		return this->geometry;
+	}
+
+	Real getX() {
+		return this->x;
+	}
+
+	Real getY() {
+		return this->y;
+	}
+
+	Real getPhi() {
+		return this->phiT;
+	}
+
+	void resetPosition() {
+		this->setAngularVel(0);
+		this->setTangencialVel(0);
+		this->x = 0;
+		this->y = 0;
+		this->phiT = 0;
+		statistics.reset(0, 0, 0);
+	}
+
+	Real getAngularVel() {
+		return this->omegaT;
+	}
+
+	void setAngularVel(Real omega) {
+		this->omegaT = omega;
+		this->setWheelVelocities();
+	}
+
+	Real getTangencialVel() {
+		return this->vT;
+	}
+
+	void setTangencialVel(Real velocity) {
+		this->vT = velocity;
+		this->setWheelVelocities();
+	}
+
+	void recalculate(double deltaTime) {
+		Real dt = static_cast<Real>(deltaTime);
+		trail.addTrailPoint(x, y);
+
+		getBodyVelocity(geometry, lWheel.getTangencialVel(), rWheel.getTangencialVel(), vT, omegaT);
+		getStepDisplacement(integration, phiT, vT, omegaT, dt, d_x, d_y);
+		this->phiT += this->omegaT * dt;
+
+		x += d_x;
+		y += d_y;
+
+		statistics.addStep(deltaTime, static_cast<double>(vT), static_cast<double>(omegaT),
+			static_cast<double>(lWheel.getTangencialVel()), static_cast<double>(rWheel.getTangencialVel()));
+	}
+
+	// Aggregates since construction or the last resetPosition
+	StatisticsSample getStatistics() {
+		return statistics.getSample(static_cast<double>(x), static_cast<double>(y), static_cast<double>(phiT));
+	}
+
+	// Wheel contact points, computed from the body pose when a renderer or logger asks; the
+	// left wheel is mounted at -pi/2 from the heading, the right one at +pi/2
+	WheelPositions<Real> getWheelPositions() {
+		Real sinPhi, cosPhi;
+		getSinCos(phiT, sinPhi, cosPhi);
+		return computeWheelPositions(geometry, x, y, sinPhi, cosPhi);
+	}
+
+	// Adds the current wheel positions to the wheel trails, called at the observer's rate
+	// (once per rendered frame) rather than every physics step
+	void sampleWheelTrails() {
+		WheelPositions<Real> wheels = getWheelPositions();
+		lWheel.trail.addTrailPoint(wheels.leftX, wheels.leftY);
+		rWheel.trail.addTrailPoint(wheels.rightX, wheels.rightY);
+	}
+
+	VehicleSample getSample(double time, long step) {
+		VehicleSample sample;
+		sample.time = time;
+		sample.step = step;
+		sample.x = this->x;
+		sample.y = this->y;
+		sample.phi = this->phiT;
+		sample.vT = this->vT;
+		sample.omegaT = this->omegaT;
+		WheelPositions<Real> wheels = getWheelPositions();
+		sample.vL = lWheel.getTangencialVel();
+		sample.omegaL = lWheel.getAngularVel();
+		sample.xL = wheels.leftX;
+		sample.yL = wheels.leftY;
+		sample.vR = rWheel.getTangencialVel();
+		sample.omegaR = rWheel.getAngularVel();
+		sample.xR = wheels.rightX;
+		sample.yR = wheels.rightY;
+		return sample;
+	}
+
+	void printData(double timeDelta, double time) {
+		printf("dt = %f | t = %3.4f | x = %f | dx = %f | y = %f | Δy = %f | L_v = %f | R_v = %f | T_v = %f | om_T = %f\n", timeDelta, time, this->x, this->d_x, this->y, this->d_y, this->lWheel.getTangencialVel(), this->rWheel.getTangencialVel(), this->vT, this->omegaT);
+	}
+
+	BasicTrail<Real>& getTrail() {
+		return this->trail;
+	}
+
+	// Same settings for the vehicle and both wheel trails
+	void setTrailSettings(int length, int spacing) {
+		trail.changeTrailSettings(length, spacing);
+		lWheel.trail.changeTrailSettings(length, spacing);
+		rWheel.trail.changeTrailSettings(length, spacing);
+	}
+
+	void deleteTrail() {
+		trail.deleteTrail();
+		lWheel.deleteTrail();
+		rWheel.deleteTrail();
+	}
+
+	// Complete state including the trails, restored bit for bit by loadState
+	void saveState(SnapshotWriter& writer) {
+		geometry.saveState(writer);
+		writer.write(omegaT);
+		writer.write(vT);
+		writer.write(phiT);
+		writer.write(d_x);
+		writer.write(d_y);
+		writer.write(x);
+		writer.write(y);
+		writer.write(integration);
+		trail.saveState(writer);
+		lWheel.saveState(writer);
+		rWheel.saveState(writer);
+		statistics.saveState(writer);
+	}
+
+	bool loadState(SnapshotReader& reader) {
+		if (!geometry.loadState(reader))
+			return false;
+		lWheel.setDimensions(geometry);
+		rWheel.setDimensions(geometry);
+		return reader.read(omegaT) && reader.read(vT) && reader.read(phiT) && reader.read(d_x)
+			&& reader.read(d_y) && reader.read(x) && reader.read(y) && reader.read(integration)
+			&& trail.loadState(reader) && lWheel.loadState(reader) && rWheel.loadState(reader) && statistics.loadState(reader);
+	}
+
+private:
+	Geometry geometry;
+	Real omegaT;
+	Real vT;
+
+	Real phiT;
+	Real d_x;
+	Real d_y;
+	Real x;
+	Real y;
+
+	IntegrationMethod integration;
+
+	BasicTrail<Real> trail;
+	RunStatistics statistics;
+
+	void setWheelVelocities() {
+		Real vLeft, vRight;
+		getWheelVelocities(geometry, vT, omegaT, vLeft, vRight);
+		this->lWheel.setTangencialVel(vLeft);
+		this->rWheel.setTangencialVel(vRight);
+	}
+};
+
+using Vehicle = BasicVehicle<RuntimeGeometry>;
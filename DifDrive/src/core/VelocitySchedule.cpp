@@ -0,0 +1,95 @@
+#include "VelocitySchedule.h"
+
+#include <charconv>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+
+#include "MappedFile.h"
+
+bool VelocitySchedule::loadFromFile(const std::string& path) {
+	clear();
+
+	MappedFile file;
+	if (!file.open(path)) {
+		std::cout << "Error: Could not open scenario file " << path << std::endl;
+		return false;
+	}
+
+	const char* begin = file.getData();
+	const char* end = begin + file.getSize();
+	if (end - begin >= 3 && memcmp(begin, "\xEF\xBB\xBF", 3) == 0)
+		begin += 3;
+
+	size_t lineCount = 1;
+	for (const char* p = begin; p < end && (p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr; p++) {
+		lineCount++;
+	}
+	reserve(lineCount);
+
+	size_t lineNumber = 0;
+	const char* line = begin;
+	while (line < end) {
+		const char* lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+		if (lineEnd == nullptr)
+			lineEnd = end;
+		lineNumber++;
+
+		const char* p = skipBlank(line, lineEnd);
+		if (p != lineEnd && *p != '#') {
+			double values[3];
+			const char* error = parseRow(p, lineEnd, values);
+
+			if (error != nullptr && !(lineNumber == 1 && time.empty() && !isNumberStart(*p))) {
+				std::cout << "Error: " << path << ":" << lineNumber << ": " << error << std::endl;
+				clear();
+				return false;
+			}
+			if (error == nullptr && !addBreakpoint(values[0], values[1], values[2])) {
+				std::cout << "Error: " << path << ":" << lineNumber << ": time " << values[0] << " [s] is lower than previous time " << time.back() << " [s]" << std::endl;
+				clear();
+				return false;
+			}
+		}
+		line = lineEnd + 1;
+	}
+	cursor = 0;
+	return true;
+}
+
+bool VelocitySchedule::isNumberStart(char c) {
+	return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+}
+
+const char* VelocitySchedule::skipBlank(const char* p, const char* end) {
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+		p++;
+	}
+	return p;
+}
+
+const char* VelocitySchedule::parseRow(const char* p, const char* end, double values[3]) {
+	for (int i = 0; i < 3; i++) {
+		p = skipBlank(p, end);
+		if (p < end && *p == '+')
+			p++;
+
+		std::from_chars_result result = std::from_chars(p, end, values[i]);
+		if (result.ec != std::errc() || !std::isfinite(values[i]))
+			return "expected row in format time;vL;vR";
+
+		p = skipBlank(result.ptr, end);
+		if (i < 2) {
+			if (p == end || *p != SCENARIO_SEPARATOR)
+				return "expected row in format time;vL;vR";
+			p++;
+		}
+	}
+	// Trailing separator is allowed, so rows written by FileHandler style tools load as well
+	if (p < end && *p == SCENARIO_SEPARATOR)
+		p = skipBlank(p + 1, end);
+	if (p != end)
+		return "unexpected data after vR column";
+	return nullptr;
+}
+
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "Snapshot.h"
+
+#define SCENARIO_SEPARATOR ';'
+
+// Wheel speed breakpoints stored as contiguous columns (time; vL; vR).
+// Speeds of a breakpoint apply after its time, until the next breakpoint.
+class VelocitySchedule {
+public:
+	VelocitySchedule() {
+		cursor = 0;
+	}
+
+	void clear() {
+		time.clear();
+		vL.clear();
+		vR.clear();
+		cursor = 0;
+	}
+
+	void reserve(size_t count) {
+		time.reserve(count);
+		vL.reserve(count);
+		vR.reserve(count);
+	}
+
+	// Breakpoint with the same time as the last one overrides it, earlier time is rejected
+	bool addBreakpoint(double t, double speedL, double speedR) {
+		if (!time.empty() && t < time.back())
+			return false;
+
+		if (!time.empty() && t == time.back()) {
+			vL.back() = speedL;
+			vR.back() = speedR;
+			return true;
+		}
+		time.push_back(t);
+		vL.push_back(speedL);
+		vR.push_back(speedR);
+		return true;
+	}
+
+	size_t size() {
+		return this->time.size();
+	}
+
+	bool empty() {
+		return this->time.empty();
+	}
+
+	double getEndTime() {
+		return time.empty() ? 0 : time.back();
+	}
+
+	double getTime(size_t index) {
+		return this->time[index];
+	}
+
+	double getLeftSpeed(size_t index) {
+		return this->vL[index];
+	}
+
+	double getRightSpeed(size_t index) {
+		return this->vR[index];
+	}
+
+	// Finds the last breakpoint with time lower than requested one. Forward queries
+	// only move the cursor, so stepping through the whole schedule is O(n) in total.
+	bool getSpeeds(double t, double& speedL, double& speedR) {
+		if (cursor > time.size() || (cursor > 0 && time[cursor - 1] >= t)) {
+			cursor = std::lower_bound(time.begin(), time.end(), t) - time.begin();
+		}
+		// Short forward steps are the common case, longer jumps (seek) use binary search
+		if (cursor + 8 < time.size() && time[cursor + 8] < t) {
+			cursor = std::lower_bound(time.begin() + cursor + 8, time.end(), t) - time.begin();
+		}
+		while (cursor < time.size() && time[cursor] < t) {
+			cursor++;
+		}
+
+		if (cursor == 0)
+			return false;
+
+		speedL = vL[cursor - 1];
+		speedR = vR[cursor - 1];
+		return true;
+	}
+
+	void resetCursor() {
+		this->cursor = 0;
+	}
+
+	// Moves all breakpoints from index first on by offset, fails when that would move
+	// one of them before its predecessor
+	bool shiftBreakpoints(size_t first, double offset) {
+		if (first >= time.size())
+			return false;
+		if (first > 0 && time[first] + offset < time[first - 1])
+			return false;
+		for (size_t i = first; i < time.size(); i++) {
+			time[i] += offset;
+		}
+		cursor = std::min(cursor, first);
+		return true;
+	}
+
+	// Breakpoints come from the scenario, the snapshot only carries the cursor and the
+	// breakpoint count to check the snapshot belongs to the same schedule
+	void saveState(SnapshotWriter& writer) {
+		writer.write(static_cast<std::uint64_t>(time.size()));
+		writer.write(static_cast<std::uint64_t>(cursor));
+	}
+
+	bool loadState(SnapshotReader& reader) {
+		size_t savedCursor = 0;
+		if (!readState(reader, savedCursor))
+			return false;
+		cursor = savedCursor;
+		return true;
+	}
+
+	// Cursor of a snapshot checked against this schedule, not applied yet
+	bool readState(SnapshotReader& reader, size_t& savedCursor) const {
+		std::uint64_t count = 0, position = 0;
+		if (!reader.read(count) || !reader.read(position) || count != time.size() || position > count)
+			return false;
+		savedCursor = static_cast<size_t>(position);
+		return true;
+	}
+
+	size_t getCursor() const {
+		return this->cursor;
+	}
+
+	// Position from readState
+	void setCursor(size_t position) {
+		this->cursor = std::min(position, time.size());
+	}
+
+	// Scenario file: one "time;vL;vR" row per line, '#' starts a comment line and
+	// a non numeric first line is treated as header. Rows are parsed in place from
+	// the mapped file, the only allocation is the single reserve for all rows.
+	bool loadFromFile(const std::string& path);
+
+private:
+	std::vector<double> time;
+	std::vector<double> vL;
+	std::vector<double> vR;
+	size_t cursor;
+
+	static bool isNumberStart(char c);
+	static const char* skipBlank(const char* p, const char* end);
+	// Returns nullptr on success, otherwise description of the problem
+	static const char* parseRow(const char* p, const char* end, double values[3]);
+};
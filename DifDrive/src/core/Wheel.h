@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cmath>
+
+#include "Constants.h"
+#include "Kinematics.h"
+#include "Trail.h"
+
+// Wheel speeds; the position follows from the body pose, see BasicVehicle::getWheelPositions.
+// The trail is filled by the observer, not by the physics step. Only the radius of the
+// vehicle geometry is kept, the vehicle owns and serializes the geometry.
+template <typename Geometry, typename Real = double>
+class BasicWheel {
+public:
+	BasicTrail<Real> trail;
+
+	explicit BasicWheel(const Geometry& vehicleGeometry) {
+		setDimensions(vehicleGeometry);
+		omegaR = 0;
+		vR = 0;
+
+		trail = BasicTrail<Real>();
+	}
+
+	Real getAngularVel() {
+		return this->omegaR;
+	}
+
+	void setAngularVel(Real omega) {
+		this->omegaR = omega;
+		this->calcTangencialVel();
+	}
+
+	Real getTangencialVel() {
+		return this->vR;
+	}
+
+	void setTangencialVel(Real velocity) {
+		this->vR = velocity;
+		this->calcAngularVel();
+	}
+
+	// Radius of the vehicle geometry, speeds are kept
+	void setDimensions(const Geometry& vehicleGeometry) {
+		this->radius = vehicleGeometry.getWheelRadius();
+		this->inverseRadius = vehicleGeometry.getInverseWheelRadius();
+	}
+
+	void deleteTrail() {
+		trail.deleteTrail();
+	}
+
+	void saveState(SnapshotWriter& writer) {
+		writer.write(omegaR);
+		writer.write(vR);
+		trail.saveState(writer);
+	}
+
+	bool loadState(SnapshotReader& reader) {
+		return reader.read(omegaR) && reader.read(vR) && trail.loadState(reader);
+	}
+
+private:
+	double radius;			//[m]
+	double inverseRadius;	//[1/m]
+	Real omegaR;
+	Real vR;
+
+	void calcAngularVel() {
+		this->omegaR = this->vR * static_cast<Real>(inverseRadius);
+	}
+
+	void calcTangencialVel() {
+		this->vR = this->omegaR * static_cast<Real>(radius);
+	}
+};
+
+using Wheel = BasicWheel<RuntimeGeometry>;
@@ -1,4 +1,5 @@
 ﻿#include <SFML/Graphics.hpp>
+#include <SFML/Network.hpp>
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -11,29 +12,161 @@
 #include <iomanip>
 #include <fstream>
 #include <filesystem>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <random>
+#include <cfloat>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "core/Constants.h"
+#include "core/Benchmark.h"
+#include "core/CoverageMap.h"
+#include "core/DifDriveApi.h"
+#include "core/FastMath.h"
+#include "core/FileHandler.h"
+#include "core/Integration.h"
+#include "core/JobSystem.h"
+#include "core/Odometry.h"
+#include "core/Lidar.h"
+#include "core/MonteCarlo.h"
+#include "core/LandmarkSensor.h"
+#include "core/PoseEkf.h"
+#include "core/OccupancyGrid.h"
+#include "core/Scenario.h"
+#include "core/SessionJournal.h"
+#include "core/SimulationData.h"
+#include "core/TelemetryRing.h"
+#include "core/Timeline.h"
+#include "core/Vehicle.h"
 
-#define DEFAULT_WHEEL_RADIUS 0.05f					//0.05[m] -> 0.5[dm] -> 5 [cm] -> 50 [mm]
-#define DEFAULT_WHEELDIST 0.1f						//0.10[m] -> 1.0[dm] -> 10[cm] -> 100[mm]
-#define DEFAULT_WHEELBASE (DEFAULT_WHEELDIST * 2)	//0.20[m] -> 2.0[dm] -> 20[cm] -> 200[mm]
-#define DEFAULT_TRAIL_LEN 100
 #define DEFAULT_SCALE 100.f							//[cm]
 #define GRID_SPACING 10.f							//[dm] (najmensi dielik)
 
-#define TIME_mS 0.001f
-#define TIME_uS (TIME_mS * TIME_mS)
-
-#define SIMULATION_FIXED_STEP 0.005f
-#define SIMULATION_SECOND_STEP_AMOUNT 200.f
-
 #define DEFAULT_ZOOM 1.f				//?
 #define UIPANEL_SIZE 160.f				//pixels
 #define BUTTON_PADDING 5.f				//pixels
 #define BUTTON_SIZE (UIPANEL_SIZE*0.5f)	//pixels
+#define SLIDER_HEIGHT 30.f				//pixels
+#define SLIDER_HANDLE_WIDTH 12.f		//pixels
 
 #define CLI_COMPLEX_SEP "==========================================================="
 #define CLI_SIMPLE_SEP  "-----------------------------------------------------------"
 
-#define M_PI 3.14159265358979323846
+#define SCENARIO_BENCH_FILE "logData/bench_scenario.csv"
+#define SCENARIO_BENCH_SIZE_MB 100
+#define SCENARIO_BENCH_REPETITIONS 5
+
+#define JOB_BENCH_PROFILE_HOURS 8.f
+#define JOB_BENCH_PROFILE_FILE "logData/bench_profile.csv"
+
+#define SWEEP_BATCH_SIZE 64
+#define SWEEP_BATCHES_IN_FLIGHT 2
+#define SWEEP_TIMEOUT 30.f				//[s] without any progress
+#define SWEEP_BATCH_TIMEOUT 10.f		//[s] a worker may spend on one batch before it is dropped
+#define SWEEP_LOCAL_BATCH_TIMEOUT 2.f	//[s] same for the local test, its batches take milliseconds
+#define SWEEP_CONNECT_RETRIES 50
+#define SWEEP_DEFAULT_RUNS 2000
+#define SWEEP_RESULTS_FILE "logData/sweep_results.csv"
+
+#define TELEMETRY_MAGIC 0x4C544444		// "DDTL" little endian
+#define TELEMETRY_VERSION 2
+#define TELEMETRY_DEFAULT_PORT 5005
+#define TELEMETRY_DEFAULT_RATE 100.f	//[Hz] of simulation time, 0 = every step
+#define TELEMETRY_DEFAULT_BATCH 4		//samples per datagram
+#define TELEMETRY_DEADLINE_TOLERANCE 0.01	//of the interval, sample times are float
+#define TELEMETRY_SEQUENCE_WINDOW 1024		//recent sequences a late datagram is matched against, divides 2^32
+
+#define LIDAR_SCAN_MAGIC 0x534C4444		// "DDLS" little endian
+#define LIDAR_SCAN_VERSION 1
+
+#define REMOTE_COMMAND_MAGIC 0x43524444	// "DDRC" little endian
+#define REMOTE_COMMAND_VERSION 1
+#define REMOTE_COMMAND_DEFAULT_PORT 5006
+#define REMOTE_COMMAND_WATCHDOG 250.f	//[ms] without command until the vehicle is stopped
+#define REMOTE_COMMAND_DEFAULT_RATE 50.f	//[Hz]
+
+#define RING_BENCH_RECORDS 20000000
+
+#define MICROBENCH_WARMUP 3
+#define MICROBENCH_REPETITIONS 31
+#define MICROBENCH_RESULTS_FILE "logData/microbench.csv"
+
+#define INTEGRATOR_REPETITIONS 5
+#define INTEGRATOR_DEFAULT_TOLERANCE 0.01	//[m]
+#define INTEGRATOR_RESULTS_FILE "logData/integrator_accuracy.csv"
+
+#define API_BENCH_MAX_BATCH 1000000
+#define API_BENCH_VEHICLE_STEPS 4000000	//vehicle steps per repetition
+#define API_BENCH_REPETITIONS 11
+#define API_BENCH_RESULTS_FILE "logData/bench_capi.csv"
+
+#define SNAPSHOT_BENCH_REPETITIONS 101
+#define SNAPSHOT_VARIANT_SHIFT 0.1f		//[s] earlier per variant
+
+#define TIMELINE_BENCH_MINUTES 60
+#define TIMELINE_BENCH_SEEKS 2000
+
+#define GEOMETRY_RESULTS_FILE "logData/bench_geometry.csv"
+
+#define PRECISION_DEFAULT_LAPS 10000
+#define PRECISION_DEFAULT_TOLERANCE 0.001	//[m]
+#define PRECISION_RESULTS_FILE "logData/precision_drift.csv"
+#define PRECISION_BENCH_FILE "logData/bench_precision.csv"
+
+#define SINCOS_DEFAULT_LAPS 10000
+#define SINCOS_DEFAULT_SAMPLES 1000000
+#define SINCOS_BATCH 1024
+#define SINCOS_RESULTS_FILE "logData/bench_sincos.csv"
+
+#define WORLD_DEFAULT_RESOLUTION 0.05		//[m] per pixel
+#define WORLD_OCCUPIED_LEVEL 128		//pixels darker than this (and not transparent) are obstacles
+#define WORLD_BENCH_DEFAULT_CELLS 10000	//per side
+#define WORLD_BENCH_DEFAULT_QUERIES 2000000
+#define WORLD_BENCH_RESOLUTION 0.01		//[m] per cell
+#define WORLD_BENCH_FILE "logData/bench_world.csv"
+
+#define LIDAR_BENCH_DEFAULT_VEHICLES 64
+#define LIDAR_BENCH_MAP_CELLS 10000		//per side
+#define LIDAR_BENCH_FILE "logData/bench_lidar.csv"
+
+#define ODOMETRY_DEFAULT_SEED 47
+#define ODOMETRY_BENCH_VEHICLES 1024
+#define ODOMETRY_BENCH_SECONDS 600.f		//[s] of simulation time
+#define ODOMETRY_DRIFT_FILE "logData/odometry_drift.csv"
+#define ODOMETRY_BENCH_FILE "logData/bench_odometry.csv"
+
+#define EKF_LANDMARK_EXTENT 100.0			//[m] around the origin covered by landmarks without a world map
+#define EKF_ELLIPSE_SIGMA 2.0				//drawn covariance ellipse
+#define EKF_ELLIPSE_POINTS 48
+#define EKF_BENCH_VEHICLES 256
+#define EKF_BENCH_SECONDS 120.f			//[s] of simulation time
+#define EKF_ACCURACY_FILE "logData/ekf_accuracy.csv"
+#define EKF_BENCH_FILE "logData/bench_ekf.csv"
+
+#define MONTE_CARLO_DEFAULT_SEED 49
+#define MONTE_CARLO_GUI_SAMPLES 20000
+#define MONTE_CARLO_DRAWN_SAMPLES 2000
+#define MONTE_CARLO_CHECK_SAMPLES 65536		//rerun on one worker to check the streams
+#define MONTE_CARLO_EXPORT_SAMPLES 10000
+#define MONTE_CARLO_ELLIPSE_POINTS 64
+
+#define COVERAGE_DEFAULT_RESOLUTION 0.05	//[m] per cell
+#define COVERAGE_GUI_EXTENT 50.0			//[m] around the origin counted without a world map
+#define COVERAGE_REPAINT_INTERVAL 250		//[ms] between repaints of the live heatmap
+#define COVERAGE_DEFAULT_FILE "logData/coverage.bin"
+#define COVERAGE_DEFAULT_SEED 50
+#define COVERAGE_BENCH_RUNS 4096
+#define COVERAGE_BENCH_EXTENT 10.0		//[m] around the origin
+#define COVERAGE_START_SPREAD 8.0			//[m] start positions within +- of the origin
 
 enum class ApplicationMode {
 	GAME_MODE,
@@ -41,13 +174,6 @@ enum class ApplicationMode {
 	NONE
 };
 
-enum class SimulationMode {
-	VECTOR,
-	RECTANGLE,
-	CURVE,
-	GAME
-};
-
 class AppConfig {
 public:
 	static AppConfig& getInstance() {
@@ -84,6 +210,8 @@ public:
 	}
 
 	sf::Font getAppFont() {
+		if (!this->fontLoaded)
+			this->loadDefFont();
 		return this->font;
 	}
 	void loadDefFont() {
@@ -121,6 +249,7 @@ public:
 						// Font loaded successfully
 						sf::Font::Info fontInfo = font.getInfo();
 						std::cout << "Loaded font: " << fontInfo.family << std::endl;
+						fontLoaded = true;
 						return;
 					}
 				}
@@ -198,9 +327,17 @@ public:
 		this->simMode = SimulationMode::GAME;
 	}
 
+	std::string getExecutablePath() {
+		return this->executablePath;
+	}
+	void setExecutablePath(std::string path) {
+		this->executablePath = path;
+	}
+
 private:
+	// Font is loaded on first use, so headless runs work without any font installed
 	AppConfig() {
-		this->loadDefFont();
+		this->fontLoaded = false;
 		this->setDarkMode();
 		this->setZoomLevel(DEFAULT_ZOOM);
 		this->setGameMode();
@@ -216,6 +353,7 @@ private:
 	bool loadData;
 
 	sf::Font font;
+	bool fontLoaded;
 
 	sf::Color colBackground;
 	sf::Color colPrimary;
@@ -228,10 +366,93 @@ private:
 	ApplicationMode appMode;
 
 	SimulationMode simMode;
+
+	std::string executablePath;
+};
+
+// Occupancy map from a bitmap, dark pixels are obstacles. The image is placed with its lower
+// left corner at the origin; without an origin it is centered on the start pose.
+bool loadWorldImage(const std::string& path, double metersPerPixel, OccupancyGrid& world, const double* origin = nullptr) {
+	sf::Image image;
+	if (!image.loadFromFile(path)) {
+		std::cout << "Error: Cannot load world map " << path << std::endl;
+		return false;
+	}
+	long width = image.getSize().x, height = image.getSize().y;
+	double originX = origin ? origin[0] : -width * metersPerPixel / 2;
+	double originY = origin ? origin[1] : -height * metersPerPixel / 2;
+	if (!world.create(width, height, metersPerPixel, originX, originY))
+		return false;
+
+	// Image rows go down, grid rows go up along +y
+	const sf::Uint8* pixels = image.getPixelsPtr();
+	long occupied = 0;
+	for (long y = 0; y < height; y++) {
+		const sf::Uint8* pixel = pixels + static_cast<size_t>(y) * width * 4;
+		for (long x = 0; x < width; x++, pixel += 4) {
+			int level = (pixel[0] * 299 + pixel[1] * 587 + pixel[2] * 114) / 1000;
+			if (level < WORLD_OCCUPIED_LEVEL && pixel[3] >= 128) {
+				world.setOccupied(x, height - 1 - y);
+				occupied++;
+			}
+		}
+	}
+	printf("World map %s: %ld x %ld cells of %.3f [m], %ld occupied, %.1f MB\n", path.c_str(), width, height, metersPerPixel,
+		occupied, world.getMemoryBytes() / 1048576.0);
+	return true;
+}
+
+// Command line value that does not parse completely or lies outside its range
+class ArgumentError : public std::runtime_error {
+public:
+	using std::runtime_error::runtime_error;
 };
 
-double degToRad(double degrees) {
-	return degrees * (M_PI / 180.0);
+// Number from a command line value, the whole text has to parse and lie within [min, max].
+// Throws ArgumentError, the command then prints its usage
+template <typename T>
+T parseArgument(const std::string& text, T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max()) {
+	size_t used = 0;
+	bool valid = false;
+	T value = 0;
+	try {
+		if constexpr (std::is_floating_point_v<T>) {
+			double parsed = std::stod(text, &used);
+			valid = parsed >= min && parsed <= max;
+			value = static_cast<T>(parsed);
+		}
+		else if constexpr (std::is_signed_v<T>) {
+			long long parsed = std::stoll(text, &used);
+			valid = parsed >= min && parsed <= max;
+			value = static_cast<T>(parsed);
+		}
+		else {
+			// stoull negates a leading minus instead of failing
+			unsigned long long parsed = std::stoull(text, &used);
+			valid = text.find('-') == std::string::npos && parsed >= min && parsed <= max;
+			value = static_cast<T>(parsed);
+		}
+	}
+	catch (const std::exception&) {
+		valid = false;
+	}
+	if (!valid || used != text.size())
+		throw ArgumentError("Invalid or out of range value '" + text + "'");
+	return value;
+}
+
+// World map from the option values <image> [meters per pixel] [origin x] [origin y]
+bool loadWorldOption(const std::vector<std::string>& values, OccupancyGrid& world) {
+	if (values.empty()) {
+		std::cout << "Error: World map needs an image file" << std::endl;
+		return false;
+	}
+	double origin[2] = { 0, 0 };
+	if (values.size() > 3) {
+		origin[0] = parseArgument<double>(values[2]);
+		origin[1] = parseArgument<double>(values[3]);
+	}
+	return loadWorldImage(values[0], (values.size() > 1) ? parseArgument<double>(values[1], DBL_MIN) : WORLD_DEFAULT_RESOLUTION, world, (values.size() > 3) ? origin : nullptr);
 }
 
 class Grid {
@@ -243,6 +464,98 @@ private:
 	int gridSpacing = GRID_SPACING;
 	sf::Font gridFont;
 	sf::Color color;
+	const OccupancyGrid* world = nullptr;
+	sf::Texture worldTexture;
+	sf::Sprite worldSprite;
+	const CoverageMap* coverage = nullptr;
+	sf::Texture coverageTexture;
+	sf::Sprite coverageSprite;
+
+	// Obstacles in the primary color under the grid lines
+	void paintWorld() {
+		if (!world || world->empty())
+			return;
+		long maximum = sf::Texture::getMaximumSize();
+		if (world->getColumns() > maximum || world->getRows() > maximum) {
+			std::cout << "World map larger than the maximum texture size " << maximum << ", collisions only" << std::endl;
+			world = nullptr;
+			return;
+		}
+		sf::Color obstacle = config.getColPrimary();
+		obstacle.a = 255 * 0.6;
+		sf::Image image;
+		image.create(world->getColumns(), world->getRows(), sf::Color::Transparent);
+		for (long row = 0; row < world->getRows(); row++) {
+			for (long column = 0; column < world->getColumns(); column++) {
+				if (world->isOccupied(column, row))
+					image.setPixel(column, world->getRows() - 1 - row, obstacle);
+			}
+		}
+		worldTexture.loadFromImage(image);
+		worldSprite.setTexture(worldTexture, true);
+		float scale = world->getResolution() * DEFAULT_SCALE;
+		worldSprite.setScale(scale, scale);
+		worldSprite.setPosition(world->getOriginX() * DEFAULT_SCALE, -(world->getOriginY() + world->getRows() * world->getResolution()) * DEFAULT_SCALE);
+	}
+
+	// Blue over cyan and yellow to red, t in [0, 1]
+	static sf::Color getHeatColor(double t) {
+		const double stops[4][3] = { { 40, 60, 200 }, { 0, 200, 220 }, { 250, 220, 0 }, { 230, 20, 20 } };
+		double position = std::clamp(t, 0.0, 1.0) * 3;
+		int stop = std::min(static_cast<int>(position), 2);
+		double f = position - stop;
+		return sf::Color(static_cast<sf::Uint8>(stops[stop][0] + f * (stops[stop + 1][0] - stops[stop][0])),
+			static_cast<sf::Uint8>(stops[stop][1] + f * (stops[stop + 1][1] - stops[stop][1])),
+			static_cast<sf::Uint8>(stops[stop][2] + f * (stops[stop + 1][2] - stops[stop][2])), 255 * 0.6);
+	}
+
+	// Visit counts on a logarithmic heat scale, full clears the texture first; only tiles
+	// with visits are uploaded
+	void paintCoverage(bool full) {
+		if (!coverage || coverage->empty())
+			return;
+		if (full) {
+			long maximum = sf::Texture::getMaximumSize();
+			if (coverage->getColumns() > maximum || coverage->getRows() > maximum) {
+				std::cout << "Coverage map larger than the maximum texture size " << maximum << ", not drawn" << std::endl;
+				coverage = nullptr;
+				return;
+			}
+			sf::Image image;
+			image.create(coverage->getColumns(), coverage->getRows(), sf::Color::Transparent);
+			coverageTexture.loadFromImage(image);
+			coverageSprite.setTexture(coverageTexture, true);
+			float scale = coverage->getResolution() * DEFAULT_SCALE;
+			coverageSprite.setScale(scale, scale);
+			coverageSprite.setPosition(coverage->getOriginX() * DEFAULT_SCALE, -(coverage->getOriginY() + coverage->getRows() * coverage->getResolution()) * DEFAULT_SCALE);
+		}
+		std::uint32_t maxCount = coverage->getMaxCount();
+		if (maxCount == 0)
+			return;
+		double logScale = 1 / std::log1p(static_cast<double>(maxCount));
+		const long tileSize = 1L << COVERAGE_TILE_SHIFT;
+		std::vector<sf::Uint8> pixels(tileSize * tileSize * 4);
+		for (size_t tile = 0; tile < coverage->getTileCount(); tile++) {
+			if (!coverage->isTileAllocated(tile))
+				continue;
+			long firstColumn, firstRow;
+			coverage->getTileOrigin(tile, firstColumn, firstRow);
+			long width = std::min(tileSize, coverage->getColumns() - firstColumn);
+			long height = std::min(tileSize, coverage->getRows() - firstRow);
+			for (long row = 0; row < height; row++) {
+				for (long column = 0; column < width; column++) {
+					std::uint32_t count = coverage->getCount(firstColumn + column, firstRow + row);
+					sf::Color color = (count > 0) ? getHeatColor(std::log1p(static_cast<double>(count)) * logScale) : sf::Color::Transparent;
+					sf::Uint8* pixel = &pixels[((height - 1 - row) * width + column) * 4];
+					pixel[0] = color.r;
+					pixel[1] = color.g;
+					pixel[2] = color.b;
+					pixel[3] = color.a;
+				}
+			}
+			coverageTexture.update(pixels.data(), width, height, firstColumn, coverage->getRows() - firstRow - height);
+		}
+	}
 
 public:
 	Grid(sf::Font font) {
@@ -299,9 +612,32 @@ public:
 	
 	void recolor() {
 		this->color = config.getColPrimary();
+		paintWorld();
+	}
+
+	// Map drawn under the grid, it must outlive the grid
+	void setWorld(const OccupancyGrid* occupancy) {
+		this->world = occupancy;
+		paintWorld();
+	}
+
+	// Heatmap drawn under the world map, it must outlive the grid; also after the map was
+	// cleared
+	void setCoverage(const CoverageMap* map) {
+		this->coverage = map;
+		paintCoverage(true);
+	}
+
+	// Shows visits counted since the last paint
+	void refreshCoverage() {
+		paintCoverage(false);
 	}
 
 	void draw(sf::RenderWindow& window)	{
+		if (coverage)
+			window.draw(coverageSprite);
+		if (world)
+			window.draw(worldSprite);
 		for (sf::VertexArray& line : grid) {
 			window.draw(line);
 		}
@@ -628,6 +964,94 @@ private:
 	sf::Color labelText;
 };
 
+// Horizontal slider with a value from 0 to 1, dragged with the left mouse button
+class Slider {
+public:
+	Slider(sf::Vector2f position, sf::Vector2f size, ApplicationMode sliderEnabledEnviroment, std::function<void(double)> callback) {
+		this->sliderEnabled = sliderEnabledEnviroment;
+		this->value = 1;
+		this->isDragged = false;
+
+		track.setSize(sf::Vector2f(size.x - 2 * BUTTON_PADDING, size.y - 2 * BUTTON_PADDING));
+		track.setPosition(sf::Vector2f(position.x + BUTTON_PADDING, position.y + BUTTON_PADDING));
+		track.setOutlineThickness(2);
+		handle.setSize(sf::Vector2f(SLIDER_HANDLE_WIDTH, track.getSize().y));
+
+		this->recolor();
+		this->setValue(1);
+		callback_fcn = callback;
+	}
+
+	double getValue() {
+		return this->value;
+	}
+
+	// Moves the handle without calling the callback
+	void setValue(double newValue) {
+		this->value = std::clamp(newValue, 0.0, 1.0);
+		float travel = track.getSize().x - handle.getSize().x;
+		handle.setPosition(track.getPosition() + sf::Vector2f(static_cast<float>(travel * value), 0));
+	}
+
+	void handleEvent(sf::Event event, sf::RenderWindow&) {
+		AppConfig& config = AppConfig::getInstance();
+		switch (event.type) {
+		case sf::Event::MouseButtonPressed:
+			if (event.mouseButton.button == sf::Mouse::Left && track.getGlobalBounds().contains(event.mouseButton.x, event.mouseButton.y)
+				&& config.isEnabled(this->sliderEnabled)) {
+				isDragged = true;
+				dragTo(event.mouseButton.x);
+			}
+			break;
+		case sf::Event::MouseMoved:
+			if (isDragged)
+				dragTo(event.mouseMove.x);
+			break;
+		case sf::Event::MouseButtonReleased:
+			if (event.mouseButton.button == sf::Mouse::Left)
+				isDragged = false;
+			break;
+		default:
+			break;
+		}
+	}
+
+	void recolor() {
+		AppConfig& config = AppConfig::getInstance();
+		this->sliderOutline = config.getColPrimary();
+		this->sliderHandle = config.getColButtonHigh();
+
+		track.setFillColor(sf::Color::Transparent);
+		track.setOutlineColor(this->sliderOutline);
+		handle.setFillColor(this->sliderHandle);
+	}
+
+	void draw(sf::RenderWindow& window) {
+		window.draw(track);
+		window.draw(handle);
+	}
+
+private:
+	sf::RectangleShape track;
+	sf::RectangleShape handle;
+
+	sf::Color sliderOutline;
+	sf::Color sliderHandle;
+
+	ApplicationMode sliderEnabled;
+
+	std::function<void(double)> callback_fcn;
+	double value;
+	bool isDragged;
+
+	void dragTo(int mouseX) {
+		float travel = track.getSize().x - handle.getSize().x;
+		setValue((mouseX - track.getPosition().x - handle.getSize().x * 0.5f) / travel);
+		if (callback_fcn)
+			callback_fcn(this->value);
+	}
+};
+
 class UIPanel {
 public:
 	UIPanel(sf::Vector2f position, sf::Vector2f size) {
@@ -661,6 +1085,17 @@ public:
 		labels.push_back(label);
 	}
 
+	// Position relative to the panel, a negative y places the slider above it
+	void addSlider(sf::Vector2f position, sf::Vector2f size, ApplicationMode sliderEnabledEnviroment, std::function<void(double)> callback) {
+		Slider slider(panel.getPosition() + position, size, sliderEnabledEnviroment, callback);
+		sliders.push_back(slider);
+	}
+
+	void setSliderValue(size_t index, double value) {
+		if (index < sliders.size())
+			sliders[index].setValue(value);
+	}
+
 	void updateLabels(std::vector<double> data) {
 		if (labels.size() == data.size())
 			for (int i = 0; i < labels.size(); i++) {
@@ -687,6 +1122,9 @@ public:
 		for (Label& label : labels) {
 			label.recolor();
 		}
+		for (Slider& slider : sliders) {
+			slider.recolor();
+		}
 	}
 
 	void draw(sf::RenderWindow& window) {
@@ -700,6 +1138,9 @@ public:
 		for (Label& label : labels) {
 			label.draw(window);
 		}
+		for (Slider& slider : sliders) {
+			slider.draw(window);
+		}
 	}
 
 	void handleEvent(sf::Event event, sf::RenderWindow& window) {
@@ -709,6 +1150,9 @@ public:
 		for (Indicator& indicator : indicators) {
 			indicator.handleEvent(event, window);
 		}
+		for (Slider& slider : sliders) {
+			slider.handleEvent(event, window);
+		}
 	}
 
 private:
@@ -716,6 +1160,7 @@ private:
 	std::vector<Button> buttons = std::vector<Button>();
 	std::vector<Indicator> indicators = std::vector<Indicator>();
 	std::vector<Label> labels = std::vector<Label>();
+	std::vector<Slider> sliders = std::vector<Slider>();
 
 	sf::Color panelOutline;
 	sf::Color panelBackground;
@@ -761,673 +1206,3675 @@ sf::VideoMode resolutionPicker() {
 	return modes[selection - 1];
 }
 
-class Trail {
-public:
-	Trail() {
-		oldX = std::deque<double>();
-		oldY = std::deque<double>();
-
-		changeTrailSettings();
+// Trail length and spacing of the selected simulation mode, applied after clearing the trails
+void resetTrails(Vehicle& vehicle, Odometry* odometry = nullptr) {
+	AppConfig& config = AppConfig::getInstance();
+	vehicle.deleteTrail();
+	int length = (config.getSimMode() == SimulationMode::GAME) ? DEFAULT_TRAIL_LEN : DEFAULT_TRAIL_LEN * 10;
+	int spacing = (config.getSimMode() == SimulationMode::GAME) ? 1 : 3;
+	vehicle.setTrailSettings(length, spacing);
+	if (odometry) {
+		odometry->getTrail().deleteTrail();
+		odometry->getTrail().changeTrailSettings(length, spacing);
 	}
+}
 
-	void changeTrailSettings() {
-		AppConfig& config = AppConfig::getInstance();
-		if (config.getSimMode() == SimulationMode::GAME) {
-			trailLength = DEFAULT_TRAIL_LEN;
-			trailRadius = 0.75f;
-			trailSpacing = 1;
-			trailCounter = 0;
-			trailFade = true;
-		}
-		else {
-			trailLength = DEFAULT_TRAIL_LEN * 10;
-			trailRadius = 1.f;
-			trailSpacing = 3;
-			trailCounter = 0;
-			trailFade = false;
-		}
-	}
+void drawTrail(sf::RenderTarget& target, Trail& trail, sf::Color color) {
+	AppConfig& config = AppConfig::getInstance();
+	bool trailFade = (config.getSimMode() == SimulationMode::GAME);
+	sf::CircleShape point = sf::CircleShape(trailFade ? 0.75f : 1.f);
 
-	void addTrailPoint(double x, double y) {
-		if (trailCounter >= trailSpacing) {
-			oldX.push_front(x);
-			oldY.push_front(y);
-			if (oldX.size() > trailLength) {
-				oldX.pop_back();
-				oldY.pop_back();
-			}
-			trailCounter = 0;
-		}
-		else {
-			trailCounter++;
-		}
-	}
+	point.setOrigin(sf::Vector2f(point.getRadius(), point.getRadius()));
+	double decrement;
 
-	void deleteTrail() {
-		oldX.clear();
-		oldY.clear();
-		changeTrailSettings();
+	if (trailFade && trail.getSize() > 0) {
+		decrement = color.a / trail.getSize();
+	} else {
+		decrement = 0;
 	}
 
-	void draw(sf::RenderWindow& window, sf::Color color) {
-		sf::CircleShape point = sf::CircleShape(trailRadius);
-		
-		point.setOrigin(sf::Vector2f(point.getRadius(), point.getRadius()));
-		double decrement;
-
-		if (trailFade && oldX.size() > 0) {
-			decrement = color.a  / oldX.size();
-		} else {
-			decrement = 0;
-		}
-
-		for (int i = 0; i < oldX.size(); i++) {
-			point.setPosition(oldX[i] * DEFAULT_SCALE, -oldY[i] * DEFAULT_SCALE);
-			point.setFillColor(color);
-			color.a -= decrement;
-			window.draw(point);
-		}
+	for (int i = 0; i < trail.getSize(); i++) {
+		point.setPosition(trail.getX(i) * DEFAULT_SCALE, -trail.getY(i) * DEFAULT_SCALE);
+		point.setFillColor(color);
+		color.a -= decrement;
+		target.draw(point);
 	}
+}
 
-private:
-	int trailSpacing;
-	int trailLength;
-	int trailCounter;
+void drawPoint(sf::RenderTarget& target, double x, double y, sf::Color color) {
+	sf::CircleShape point = sf::CircleShape(1.f);
+	point.setOrigin(sf::Vector2f(point.getRadius(), point.getRadius()));
+	point.setPosition(x * DEFAULT_SCALE, -y * DEFAULT_SCALE);
+	point.setFillColor(color);
+	target.draw(point);
+}
+
+void drawVehicle(sf::RenderTarget& target, Vehicle& vehicle) {
+	AppConfig& config = AppConfig::getInstance();
+	drawTrail(target, vehicle.getTrail(), config.getColPrimary());
+	drawPoint(target, vehicle.getX(), vehicle.getY(), config.getColPrimary());
 
-	float trailRadius;
+	drawTrail(target, vehicle.lWheel.trail, sf::Color::Red);
+	drawTrail(target, vehicle.rWheel.trail, sf::Color::Green);
 
-	bool trailFade;
+	WheelPositions<double> wheels = vehicle.getWheelPositions();
+	drawPoint(target, wheels.leftX, wheels.leftY, sf::Color::Red);
+	drawPoint(target, wheels.rightX, wheels.rightY, sf::Color::Green);
+}
 
-	std::deque<double> oldX;
-	std::deque<double> oldY;
-};
+// Disc the collision queries check against the world map, red while it touches an obstacle
+void drawFootprint(sf::RenderTarget& target, Vehicle& vehicle, bool colliding) {
+	AppConfig& config = AppConfig::getInstance();
+	sf::CircleShape footprint = sf::CircleShape(vehicle.getWheelbase() / 2 * DEFAULT_SCALE);
+	footprint.setOrigin(sf::Vector2f(footprint.getRadius(), footprint.getRadius()));
+	footprint.setPosition(vehicle.getX() * DEFAULT_SCALE, -vehicle.getY() * DEFAULT_SCALE);
+	footprint.setFillColor(sf::Color::Transparent);
+	footprint.setOutlineThickness(1.f);
+	footprint.setOutlineColor(colliding ? sf::Color::Red : config.getColPrimary());
+	target.draw(footprint);
+}
 
-class Wheel {
-public:
-	Trail trail;
+// Beams of the last scan from the pose it was taken at, hits brighter than free beams
+void drawScan(sf::RenderTarget& target, double x, double y, double phi, const Lidar& lidar, const std::vector<float>& ranges) {
+	AppConfig& config = AppConfig::getInstance();
+	sf::Color hit = sf::Color::Red;
+	hit.a = 255 * 0.5;
+	sf::Color miss = config.getColPrimary();
+	miss.a = 255 * 0.1;
+	sf::VertexArray beams(sf::Lines, ranges.size() * 2);
+	sf::Vector2f origin(x * DEFAULT_SCALE, -y * DEFAULT_SCALE);
+	for (size_t beam = 0; beam < ranges.size(); beam++) {
+		double angle = phi + lidar.getAngleMin() + beam * lidar.getAngleIncrement();
+		sf::Color color = (ranges[beam] < lidar.getSettings().maxRange) ? hit : miss;
+		beams[beam * 2] = sf::Vertex(origin, color);
+		beams[beam * 2 + 1] = sf::Vertex(sf::Vector2f((x + ranges[beam] * cos(angle)) * DEFAULT_SCALE, -(y + ranges[beam] * sin(angle)) * DEFAULT_SCALE), color);
+	}
+	target.draw(beams);
+}
 
-	Wheel (float wheelRadius, double phi) {
-		r = wheelRadius;
-		omegaR = 0;
-		vR = 0;
+// Estimated trail and position of the dead reckoning
+void drawOdometry(sf::RenderTarget& target, Odometry& odometry) {
+	drawTrail(target, odometry.getTrail(), sf::Color::Magenta);
+	drawPoint(target, odometry.getX(), odometry.getY(), sf::Color::Magenta);
+}
 
-		phiOffset = phi;
-		x = DEFAULT_WHEELBASE * 0.5f * cos(phiOffset);
-		y = DEFAULT_WHEELBASE * 0.5f * sin(phiOffset);
+// Point at parameter t of an ellipse with the given center, semi axes and major axis angle
+void getEllipsePoint(double centerX, double centerY, double major, double minor, double angle, double t, double& x, double& y) {
+	double u = major * cos(t), v = minor * sin(t);
+	x = centerX + u * cos(angle) - v * sin(angle);
+	y = centerY + u * sin(angle) + v * cos(angle);
+}
 
-		trail = Trail();
+void drawEllipse(sf::RenderTarget& target, double centerX, double centerY, double major, double minor, double angle, sf::Color color) {
+	sf::VertexArray ellipse(sf::LineStrip, EKF_ELLIPSE_POINTS + 1);
+	for (int i = 0; i <= EKF_ELLIPSE_POINTS; i++) {
+		double x, y;
+		getEllipsePoint(centerX, centerY, major, minor, angle, 2 * M_PI * i / EKF_ELLIPSE_POINTS, x, y);
+		ellipse[i] = sf::Vertex(sf::Vector2f(x * DEFAULT_SCALE, -y * DEFAULT_SCALE), color);
 	}
+	target.draw(ellipse);
+}
 
-	double getX() {
-		return this->x;
+// Landmarks, the rays to the last observed ones from the pose they were seen from, and the
+// filter estimate with its position covariance ellipse
+void drawLocalization(sf::RenderTarget& target, const PoseEkf& ekf, const LandmarkMap& landmarkMap,
+	const std::vector<LandmarkObservation>& observations, double observedX, double observedY) {
+	const std::vector<Landmark>& landmarks = landmarkMap.getLandmarks();
+	sf::Color landmarkColor = sf::Color::Cyan;
+	landmarkColor.a = 255 * 0.6;
+	sf::VertexArray markers(sf::Quads, landmarks.size() * 4);
+	for (size_t i = 0; i < landmarks.size(); i++) {
+		float x = landmarks[i].x * DEFAULT_SCALE, y = -landmarks[i].y * DEFAULT_SCALE;
+		markers[i * 4] = sf::Vertex(sf::Vector2f(x - 1.5f, y - 1.5f), landmarkColor);
+		markers[i * 4 + 1] = sf::Vertex(sf::Vector2f(x + 1.5f, y - 1.5f), landmarkColor);
+		markers[i * 4 + 2] = sf::Vertex(sf::Vector2f(x + 1.5f, y + 1.5f), landmarkColor);
+		markers[i * 4 + 3] = sf::Vertex(sf::Vector2f(x - 1.5f, y + 1.5f), landmarkColor);
 	}
-
-	double getY() {
-		return this->y;
+	target.draw(markers);
+
+	sf::Color rayColor = sf::Color::Cyan;
+	rayColor.a = 255 * 0.25;
+	sf::VertexArray rays(sf::Lines, observations.size() * 2);
+	for (size_t i = 0; i < observations.size(); i++) {
+		const Landmark& landmark = landmarks[observations[i].landmark];
+		rays[i * 2] = sf::Vertex(sf::Vector2f(observedX * DEFAULT_SCALE, -observedY * DEFAULT_SCALE), rayColor);
+		rays[i * 2 + 1] = sf::Vertex(sf::Vector2f(landmark.x * DEFAULT_SCALE, -landmark.y * DEFAULT_SCALE), rayColor);
 	}
+	target.draw(rays);
 
-	double getAngularVel() {
-		return this->omegaR;
-	}
+	double major, minor, angle;
+	ekf.getPositionEllipse(major, minor, angle);
+	drawEllipse(target, ekf.getX(), ekf.getY(), EKF_ELLIPSE_SIGMA * major, EKF_ELLIPSE_SIGMA * minor, angle, sf::Color::Cyan);
+	drawPoint(target, ekf.getX(), ekf.getY(), sf::Color::Cyan);
+}
 
-	void setAngularVel(double omega) {
-		this->omegaR = omega;
-		this->calcTangencialVel();
+// End poses of the first Monte Carlo samples and their 95 % confidence ellipse
+void drawMonteCarlo(sf::RenderTarget& target, const PoseDistribution& distribution, const std::vector<double>& x, const std::vector<double>& y) {
+	sf::Color sampleColor = sf::Color::Yellow;
+	sampleColor.a = 255 * 0.4;
+	size_t drawn = std::min(x.size(), static_cast<size_t>(MONTE_CARLO_DRAWN_SAMPLES));
+	sf::VertexArray points(sf::Points, drawn);
+	for (size_t i = 0; i < drawn; i++) {
+		points[i] = sf::Vertex(sf::Vector2f(x[i] * DEFAULT_SCALE, -y[i] * DEFAULT_SCALE), sampleColor);
 	}
+	target.draw(points);
+	drawEllipse(target, distribution.mean(0, 0), distribution.mean(1, 0), distribution.ellipseMajor, distribution.ellipseMinor,
+		distribution.ellipseAngle, sf::Color::Yellow);
+}
 
-	double getTangencialVel() {
-		return this->vR;
-	}
+// Log name suffix describing the application and simulation mode
+std::string getLogSuffix() {
+	AppConfig& config = AppConfig::getInstance();
+	std::string suffix;
 
-	void setTangencialVel(double velocity) {
-		this->vR = velocity;
-		this->calcAngularVel();
+	if (config.getAppMode() == ApplicationMode::GAME_MODE) {
+		suffix += "-VAR_DELTA-GAME_MODE";
 	}
-
-	void recalcWheelPos(double xCenter, double yCenter, double phi) {
-		trail.addTrailPoint(x, y);
-		
-		x = xCenter + DEFAULT_WHEELBASE * 0.5f * cos(phi + this->phiOffset);
-		y = yCenter + DEFAULT_WHEELBASE * 0.5f * sin(phi + this->phiOffset);
+	else {
+		suffix += "-FIX_DELTA-SIMULATION";
 	}
 
-	void draw(sf::RenderWindow& window, sf::Color color) {
-		sf::CircleShape point = sf::CircleShape(1.f);
-		point.setOrigin(sf::Vector2f(point.getRadius(), point.getRadius()));
-		point.setPosition(x * DEFAULT_SCALE, -y * DEFAULT_SCALE);
-		point.setFillColor(color);
-		window.draw(point);
+	switch (config.getSimMode()) {
+	case SimulationMode::VECTOR:
+		suffix += "-VECTOR";
+		break;
+	case SimulationMode::RECTANGLE:
+		suffix += "-RECTANGLE";
+		break;
+	case SimulationMode::CURVE:
+		suffix += "-CURVE";
+		break;
+	case SimulationMode::GAME:
+		suffix += "-GAME";
+		break;
+	default:
+		break;
 	}
+	return suffix;
+}
 
-	void deleteTrail() {
-		trail.deleteTrail();
+bool getScenarioFileData(VelocitySchedule& schedule) {
+	char answer;
+	while (true) {
+		std::cout << "Load speed changes from scenario file? (y/n): ";
+		std::cin >> answer;
+		if (std::cin.fail() || (answer != 'y' && answer != 'n')) {
+			std::cin.clear();
+			std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			std::cout << "Invalid input. Please enter y or n.\n";
+			continue;
+		}
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+		break;
 	}
-
-private:
-	double r;
-	double omegaR;
-	double vR;
-
-	double phiOffset;
-	double x;
-	double y;
-
-	sf::CircleShape point;
-
-	void calcAngularVel() {
-		this->omegaR = this->vR / this->r;
+	if (answer == 'n')
+		return false;
+
+	std::string path;
+	std::cout << "Scenario file path (rows time;vL;vR): ";
+	std::cin >> path;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	if (!schedule.loadFromFile(path)) {
+		std::cout << "Falling back to manual input." << std::endl;
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+		return false;
 	}
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+	std::cout << "Loaded " << schedule.size() << " speed changes in " << duration.count() * TIME_mS << " [ms]" << std::endl;
+	return true;
+}
 
-	void calcTangencialVel() {
-		this->vR = this->omegaR * this->r;
+void getVectorData(VelocitySchedule& schedule) {
+	schedule.clear();
+	int n;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	if (getScenarioFileData(schedule)) {
+		std::cout << CLI_COMPLEX_SEP << std::endl;
+		return;
+	}
+	std::cout << "Enter the amount of speed changes during simulation: ";
+	while (true) {
+		std::cin >> n;
+		if (std::cin.fail()) {
+			std::cin.clear();
+			std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			std::cout << "Invalid input. Please enter a number.\n";
+			continue;
+		}
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+		break;
 	}
-};
-
-class Vehicle {
-public:
-	Wheel lWheel = Wheel(DEFAULT_WHEEL_RADIUS, (-3.1415 / 2));
-	Wheel rWheel = Wheel(DEFAULT_WHEEL_RADIUS, (3.1415 / 2));
-
-	Vehicle(double wheelbase) {
-		l = wheelbase;
-		omegaT = 0;
-		vT = 0;
 
-		phiT = 0;
-		d_x = 0;
-		d_y = 0;
-		x = 0;
-		y = 0;
+	double prevTime = 0;
+	double time;
+	double speedL, speedR;
 
-		trail = Trail();
-		this->recolor();
-	}
+	for (int i = 0; i < n; i++) {
+		while (true) {
+			std::cout << i + 1 << ". Time [s]: ";
+			std::cin >> time;
+			if (std::cin.fail()) {
+				std::cin.clear();
+				std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+				std::cout << "Invalid input. Please enter a number.\n";
+				continue;
+			}
+			if (time < prevTime) {
+				std::cout << "Next time must be higher than previous one.\n";
+				continue;
+			}
+			break;
+		}
+		prevTime = time;
 
-	double getX() {
-		return this->x;
+		while (true) {
+			std::cout << i + 1 << ". Tangencial speed vT of Left wheel [m/s]: ";
+			std::cin >> speedL;
+			if (std::cin.fail()) {
+				std::cin.clear();
+				std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+				std::cout << "Invalid input. Please enter a number.\n";
+				continue;
+			}
+			break;
+		}
+		while (true) {
+			std::cout << i + 1 << ". Tangencial speed vT of Right wheel [m/s]: ";
+			std::cin >> speedR;
+			if (std::cin.fail()) {
+				std::cin.clear();
+				std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+				std::cout << "Invalid input. Please enter a number.\n";
+				continue;
+			}
+			break;
+		}
+		schedule.addBreakpoint(time, speedL, speedR);
+		std::cout << CLI_SIMPLE_SEP << std::endl;
 	}
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+}
 
-	double getY() {
-		return this->y;
+double getRectangleData() {
+	double rectangleSide = 0;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	while (true) {
+		std::cout << "Enter size of rectangle side to draw [m]: ";
+		std::cin >> rectangleSide;
+		if (std::cin.fail()) {
+			std::cin.clear();
+			std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			std::cout << "Invalid input. Please enter a number.\n";
+			continue;
+		}
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+		break;
 	}
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return rectangleSide;
+}
 
-	double getPhi() {
-		return this->phiT;
+void getCurveData(double& r1, double& l, double& r2) {
+	r1 = 0; l = 0; r2 = 0;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	while (true) {
+		std::cout << "Enter radius of the 1. curve  - R1 [m]: ";
+		std::cin >> r1;
+		if (std::cin.fail()) {
+			std::cin.clear();
+			std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			std::cout << "Invalid input. Please enter a number.\n";
+			continue;
+		}
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+		break;
 	}
 
-	void resetPosition() {
-		this->setAngularVel(0);
-		this->setTangencialVel(0);
-		this->x = 0;
-		this->y = 0;
-		this->phiT = 0;
-		lWheel.recalcWheelPos(x, y, phiT);
-		rWheel.recalcWheelPos(x, y, phiT);
+	while (true) {
+		std::cout << "Enter distance betwewn curves - L1 [m]: ";
+		std::cin >> l;
+		if (std::cin.fail()) {
+			std::cin.clear();
+			std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			std::cout << "Invalid input. Please enter a number.\n";
+			continue;
+		}
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+		break;
 	}
 
-	double getAngularVel() {
-		return this->omegaT;
+	while (true) {
+		std::cout << "Enter radius of the 2. curve  - R2 [m]: ";
+		std::cin >> r2;
+		if (std::cin.fail()) {
+			std::cin.clear();
+			std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			std::cout << "Invalid input. Please enter a number.\n";
+			continue;
+		}
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+		break;
 	}
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+}
 
-	void setAngularVel(double omega) {
-		this->omegaT = omega;
-		this->rWheel.setTangencialVel(((2 * this->vT) + (this->l * this->omegaT)) / 2);
-		this->lWheel.setTangencialVel(((2 * this->vT) - (this->l * this->omegaT)) / 2);
+// Console prompts for the speed schedule of the selected simulation mode
+void getInputData(SimulationData& data) {
+	AppConfig& config = AppConfig::getInstance();
+	if (config.getSimMode() == SimulationMode::VECTOR) {
+		getVectorData(data.getSchedule());
 	}
-
-	double getTangencialVel() {
-		return this->vT;
+	if (config.getSimMode() == SimulationMode::RECTANGLE) {
+		data.setRectangleData(getRectangleData());
 	}
-
-	void setTangencialVel(double velocity) {
-		this->vT = velocity;
-		this->rWheel.setTangencialVel(((2 * this->vT) + (l * this->omegaT)) / 2);
-		this->lWheel.setTangencialVel(((2 * this->vT) - (l * this->omegaT)) / 2);
+	if (config.getSimMode() == SimulationMode::CURVE) {
+		double r1, l, r2;
+		getCurveData(r1, l, r2);
+		data.setCurveData(r1, l, r2);
 	}
+	config.setDataStatus(false);
+}
 
-	void recalculate(double deltaTime) {
-		trail.addTrailPoint(x, y);
-
-		this->omegaT = (rWheel.getTangencialVel() - lWheel.getTangencialVel()) / this->l;
-		this->phiT += this->omegaT * deltaTime;
+// Monotonic clock shared by all processes of the machine, used for latency measurements
+std::int64_t getSteadyTimeNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-		this->vT = (rWheel.getTangencialVel() + lWheel.getTangencialVel()) / 2.0;
-		double vX = vT * cos(phiT);
-		double vY = vT * sin(phiT);
-		d_x = vX * deltaTime;
-		d_y = vY * deltaTime;
+// Datagram = TelemetryHeader followed by sampleCount VehicleSample records and the
+// StatisticsSample of the newest one
+struct TelemetryHeader {
+	std::uint32_t magic;
+	std::uint16_t version;
+	std::uint16_t sampleCount;
+	std::uint32_t sequence;		// per datagram, gaps mean lost datagrams
+	std::uint32_t reserved;
+	std::int64_t sendTime;		// getSteadyTimeNs() of the sender
+};
+static_assert(sizeof(TelemetryHeader) == 24, "TelemetryHeader layout changed");
+
+// Scan datagram = LidarScanHeader followed by beamCount float ranges [m], sent on the
+// telemetry socket at the rate of the lidar
+struct LidarScanHeader {
+	std::uint32_t magic;
+	std::uint16_t version;
+	std::uint16_t reserved;
+	std::uint32_t sequence;		// per scan
+	std::uint32_t beamCount;
+	std::int64_t sendTime;		// getSteadyTimeNs() of the sender
+	double time;				//[s] simulation time of the scan
+	double x;					//[m] scanner pose
+	double y;					//[m]
+	double phi;					//[rad]
+	double angleMin;			//[rad] of beam 0 relative to phi
+	double angleIncrement;		//[rad]
+	double maxRange;			//[m] range of beams without a hit
+};
+static_assert(sizeof(LidarScanHeader) == 80, "LidarScanHeader layout changed");
 
-		x += d_x;
-		y += d_y;
+#define TELEMETRY_MAX_BATCH ((sf::UdpSocket::MaxDatagramSize - sizeof(TelemetryHeader) - sizeof(StatisticsSample)) / sizeof(VehicleSample))
 
-		lWheel.recalcWheelPos(x, y, phiT);
-		rWheel.recalcWheelPos(x, y, phiT);
+class TelemetryPublisher {
+public:
+	TelemetryPublisher() {
+		enabled = false;
+		port = TELEMETRY_DEFAULT_PORT;
+		interval = 0;
+		batchSize = 1;
+		sequence = 0;
+		nextSampleTime = 0;
+		pendingSamples = 0;
+		statistics = StatisticsSample();
 	}
 
-	void printData(double timeDelta, double time) {
-		printf("dt = %f | t = %3.4f | x = %f | dx = %f | y = %f | Δy = %f | L_v = %f | R_v = %f | T_v = %f | om_T = %f\n", timeDelta, time, this->x, this->d_x, this->y, this->d_y, this->lWheel.getTangencialVel(), this->rWheel.getTangencialVel(), this->vT, this->omegaT);
+	// rate is in [Hz] of sample time (0 = every sample), batch is samples per datagram
+	bool open(const std::string& host, unsigned short destinationPort, double rate, int batch) {
+		address = sf::IpAddress(host);
+		if (address == sf::IpAddress::None) {
+			std::cout << "Error: Unknown telemetry host " << host << std::endl;
+			return false;
+		}
+		port = destinationPort;
+		interval = (rate > 0) ? 1.0 / rate : 0;
+		batchSize = std::max(1, std::min(batch, static_cast<int>(TELEMETRY_MAX_BATCH)));
+		buffer.assign(sizeof(TelemetryHeader) + batchSize * sizeof(VehicleSample) + sizeof(StatisticsSample), 0);
+		pendingSamples = 0;
+		nextSampleTime = -std::numeric_limits<double>::infinity();
+		enabled = true;
+		std::cout << "Telemetry to " << host << ":" << port << ", " << rate << " [Hz], " << batchSize << " samples per datagram" << std::endl;
+		return true;
 	}
 
-	void recolor() {
-		AppConfig& config = AppConfig::getInstance();
-		this->color = config.getColPrimary();
+	bool isEnabled() {
+		return this->enabled;
 	}
 
-	void draw(sf::RenderWindow& window) {
-		this->trail.draw(window, this->color);
-
-		sf::CircleShape point = sf::CircleShape(1.f);
-		point.setOrigin(sf::Vector2f(point.getRadius(), point.getRadius()));
-		point.setPosition(x * DEFAULT_SCALE, -y * DEFAULT_SCALE);
-		point.setFillColor(this->color);
-		window.draw(point);
+	void publish(const VehicleSample& sample, const StatisticsSample& runStatistics) {
+		if (!enabled || sample.time < nextSampleTime - interval * TELEMETRY_DEADLINE_TOLERANCE)
+			return;
+		// Deadlines stay on the rate grid, sample times on the step grid only decide which
+		// sample goes out; resynced after a pause or slow frames
+		nextSampleTime += interval;
+		if (nextSampleTime <= sample.time - interval)
+			nextSampleTime = sample.time + interval;
+		statistics = runStatistics;
+
+		memcpy(buffer.data() + sizeof(TelemetryHeader) + pendingSamples * sizeof(VehicleSample), &sample, sizeof(VehicleSample));
+		pendingSamples++;
+		if (pendingSamples >= batchSize)
+			flush();
+	}
 
-		this->lWheel.trail.draw(window, sf::Color::Red);
-		this->rWheel.trail.draw(window, sf::Color::Green);
+	void flush() {
+		if (!enabled || pendingSamples == 0)
+			return;
+
+		TelemetryHeader header;
+		header.magic = TELEMETRY_MAGIC;
+		header.version = TELEMETRY_VERSION;
+		header.sampleCount = static_cast<std::uint16_t>(pendingSamples);
+		header.sequence = sequence++;
+		header.reserved = 0;
+		header.sendTime = getSteadyTimeNs();
+		memcpy(buffer.data(), &header, sizeof(TelemetryHeader));
+		size_t samplesEnd = sizeof(TelemetryHeader) + pendingSamples * sizeof(VehicleSample);
+		memcpy(buffer.data() + samplesEnd, &statistics, sizeof(StatisticsSample));
+
+		socket.send(buffer.data(), samplesEnd + sizeof(StatisticsSample), address, port);
+		pendingSamples = 0;
+	}
 
-		lWheel.draw(window, sf::Color::Red);
-		rWheel.draw(window, sf::Color::Green);
+	void resetSampleTime() {
+		this->nextSampleTime = -std::numeric_limits<double>::infinity();
 	}
 
-	void deleteTrail() {
-		trail.deleteTrail();
-		lWheel.deleteTrail();
-		rWheel.deleteTrail();
+	// One datagram per scan, the sample batching does not apply
+	void publishScan(double time, double x, double y, double phi, const Lidar& lidar, const std::vector<float>& ranges) {
+		if (!enabled)
+			return;
+		LidarScanHeader header;
+		header.magic = LIDAR_SCAN_MAGIC;
+		header.version = LIDAR_SCAN_VERSION;
+		header.reserved = 0;
+		header.sequence = scanSequence++;
+		header.beamCount = static_cast<std::uint32_t>(ranges.size());
+		header.sendTime = getSteadyTimeNs();
+		header.time = time;
+		header.x = x;
+		header.y = y;
+		header.phi = phi;
+		header.angleMin = lidar.getAngleMin();
+		header.angleIncrement = lidar.getAngleIncrement();
+		header.maxRange = lidar.getSettings().maxRange;
+
+		size_t size = sizeof(LidarScanHeader) + ranges.size() * sizeof(float);
+		if (size > sf::UdpSocket::MaxDatagramSize)
+			return;
+		scanBuffer.resize(size);
+		memcpy(scanBuffer.data(), &header, sizeof(LidarScanHeader));
+		memcpy(scanBuffer.data() + sizeof(LidarScanHeader), ranges.data(), ranges.size() * sizeof(float));
+		socket.send(scanBuffer.data(), size, address, port);
 	}
 
 private:
-	double l;
-	double omegaT;
-	double vT;
-
-	double phiT;
-	double d_x;
-	double d_y;
-	double x;
-	double y;
+	bool enabled;
+	sf::UdpSocket socket;
+	sf::IpAddress address;
+	unsigned short port;
+
+	double interval;
+	double nextSampleTime;
+	int batchSize;
+	int pendingSamples;
+	std::uint32_t sequence;
+	std::uint32_t scanSequence = 0;
+	std::vector<char> buffer;
+	std::vector<char> scanBuffer;
+	StatisticsSample statistics;
+};
 
-	Trail trail;
+enum class RemoteCommandMode {
+	BODY_VELOCITY,	// a = v [m/s], b = omega [rad/s]
+	WHEEL_VELOCITY	// a = vL [m/s], b = vR [m/s]
+};
 
-	sf::Color color;
+// Velocity command datagram, little endian, no padding
+struct RemoteCommand {
+	std::uint32_t magic;
+	std::uint16_t version;
+	std::uint16_t mode;			// RemoteCommandMode
+	std::uint32_t sequence;		// older or repeated sequence numbers of the same sender are dropped
+	std::uint32_t reserved;
+	std::int64_t sendTime;		// getSteadyTimeNs() of the sender
+	double a;
+	double b;
 };
+static_assert(sizeof(RemoteCommand) == 40, "RemoteCommand layout changed");
 
-class SimulationData {
+// Commands are received on a background thread and stamped with their arrival time.
+// advance() splits the physics interval at the arrival times, so each command takes
+// effect from the moment it arrived instead of from the next frame.
+class RemoteCommandReceiver {
 public:
-	SimulationData() {
-		vT_L = std::map<double, double>();
-		vT_R = std::map<double, double>();
-
-		rectangleSide = 0;
+	RemoteCommandReceiver() {
+		enabled = false;
+		running = false;
+		watchdogTimeout = 0;
+		lastSequence = 0;
+		hasSequence = false;
+		sequencePort = 0;
+		lastCommandTime = 0;
+		commandActive = false;
+		droppedCommands = 0;
+		invalidCommands = 0;
+		watchdogStops = 0;
+		journal = nullptr;
+	}
 
-		r1 = 0; l = 0; r2 = 0;
+	~RemoteCommandReceiver() {
+		close();
 	}
 
-	void getInputData() {
-		if (config.getSimMode() == SimulationMode::VECTOR) {
-			getVectorData();
-		}
-		if (config.getSimMode() == SimulationMode::RECTANGLE) {
-			getRectangleData();
-			calculateRectangleData();
+	bool open(unsigned short port, double watchdogMs) {
+		if (socket.bind(port) != sf::Socket::Done) {
+			std::cout << "Error: Could not bind remote control port " << port << std::endl;
+			return false;
 		}
-		if (config.getSimMode() == SimulationMode::CURVE) {
-			getCurveData();
-			calculateCurvaData();
+		watchdogTimeout = static_cast<std::int64_t>(watchdogMs * 1e6);
+		enabled = true;
+		running = true;
+		receiveThread = std::thread(&RemoteCommandReceiver::receiveLoop, this);
+		std::cout << "Remote control on UDP port " << port << ", watchdog " << watchdogMs << " [ms]" << std::endl;
+		return true;
+	}
+
+	void close() {
+		running = false;
+		if (receiveThread.joinable())
+			receiveThread.join();
+		socket.unbind();
+	}
+
+	bool isEnabled() {
+		return this->enabled;
+	}
+
+	// Steps between commands go through the journal, so a recorded session replays exactly
+	void setJournal(SessionJournal* sessionJournal) {
+		this->journal = sessionJournal;
+	}
+
+	// Integrates the vehicle over the last deltaTime seconds of wall time
+	void advance(Vehicle& vehicle, double deltaTime) {
+		std::int64_t now = getSteadyTimeNs();
+		std::int64_t cursor = now - static_cast<std::int64_t>(deltaTime * 1e9);
+
+		std::deque<ReceivedCommand> commands = takeCommands();
+		for (ReceivedCommand& command : commands) {
+			std::int64_t effective = std::max(cursor, std::min(command.arrivalTime, now));
+			checkWatchdog(vehicle, cursor, effective);
+			if (effective > cursor) {
+				step(vehicle, (effective - cursor) * 1e-9);
+				cursor = effective;
+			}
+			applyCommand(vehicle, command);
 		}
-		config.setDataStatus(false);
+		checkWatchdog(vehicle, cursor, now);
+		if (now > cursor)
+			step(vehicle, (now - cursor) * 1e-9);
 	}
 
-	void setFixedVectorData() {
-		vT_L.clear();
-		vT_R.clear();
-		vT_L = { {0,2},{5,-1},{10,0},{15, 2},{20,1} };
-		vT_R = { {0,2},{5, 1},{10,0},{15,-2},{20,1} };
+	// Fixed step simulation: commands received since the last step apply to the next one
+	void applyPending(Vehicle& vehicle) {
+		std::int64_t now = getSteadyTimeNs();
+		std::deque<ReceivedCommand> commands = takeCommands();
+		for (ReceivedCommand& command : commands) {
+			applyCommand(vehicle, command);
+		}
+		std::int64_t cursor = now;
+		checkWatchdog(vehicle, cursor, now);
 	}
-	void getVectorData() {
-		vT_L.clear();
-		vT_R.clear();
-		int n;
-		std::cout << CLI_COMPLEX_SEP << std::endl;
-		std::cout << "Enter the amount of speed changes during simulation: ";
+
+	// Stops the receive thread first, the counters are written by it
+	void printLatencyStats() {
+		if (!enabled)
+			return;
+		close();
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+		std::cout << "Remote commands: " << latencies.size() << " applied, " << droppedCommands << " dropped as out of order, " << invalidCommands << " invalid, " << watchdogStops << " watchdog stops" << std::endl;
+		if (!latencies.empty()) {
+			std::vector<double> sorted = latencies;
+			std::sort(sorted.begin(), sorted.end());
+			// Nearest rank, below a hundred samples p99 is the maximum
+			size_t p99 = static_cast<size_t>(std::ceil(sorted.size() * 0.99)) - 1;
+			printf("Command to applied latency [us]: min = %.1f | median = %.1f | p99 = %.1f | max = %.1f\n", sorted.front(), sorted[sorted.size() / 2], sorted[p99], sorted.back());
+		}
+	}
+
+private:
+	struct ReceivedCommand {
+		RemoteCommand command;
+		std::int64_t arrivalTime;
+	};
+
+	bool enabled;
+	std::atomic<bool> running;
+	sf::UdpSocket socket;
+	std::thread receiveThread;
+
+	std::mutex queueLock;
+	std::deque<ReceivedCommand> queue;
+	std::uint32_t lastSequence;
+	bool hasSequence;
+	sf::IpAddress sequenceSender;	// sequence numbers are counted per sender
+	unsigned short sequencePort;
+	long droppedCommands;
+	long invalidCommands;
+
+	std::int64_t watchdogTimeout;
+	std::int64_t lastCommandTime;
+	bool commandActive;
+	long watchdogStops;
+	std::vector<double> latencies;
+	SessionJournal* journal;
+
+	void receiveLoop() {
+		sf::SocketSelector selector;
+		selector.add(socket);
+		RemoteCommand command;
+		while (running) {
+			if (!selector.wait(sf::milliseconds(50)))
+				continue;
+
+			std::size_t size = 0;
+			sf::IpAddress sender;
+			unsigned short senderPort;
+			if (socket.receive(&command, sizeof(RemoteCommand), size, sender, senderPort) != sf::Socket::Done)
+				continue;
+			std::int64_t arrival = getSteadyTimeNs();
+			if (size != sizeof(RemoteCommand) || command.magic != REMOTE_COMMAND_MAGIC || command.version != REMOTE_COMMAND_VERSION)
+				continue;
+
+			std::lock_guard<std::mutex> lock(queueLock);
+			bool known = command.mode == static_cast<std::uint16_t>(RemoteCommandMode::BODY_VELOCITY) || command.mode == static_cast<std::uint16_t>(RemoteCommandMode::WHEEL_VELOCITY);
+			if (!known || !std::isfinite(command.a) || !std::isfinite(command.b)) {
+				invalidCommands++;
+				continue;
+			}
+			// A new sender, or a restarted one on another port, starts its own sequence
+			if (!hasSequence || sender != sequenceSender || senderPort != sequencePort) {
+				hasSequence = false;
+				sequenceSender = sender;
+				sequencePort = senderPort;
+			}
+			// Signed difference, the sequence wraps around
+			if (hasSequence && static_cast<std::int32_t>(command.sequence - lastSequence) <= 0) {
+				droppedCommands++;
+				continue;
+			}
+			hasSequence = true;
+			lastSequence = command.sequence;
+			queue.push_back(ReceivedCommand{ command, arrival });
+		}
+	}
+
+	std::deque<ReceivedCommand> takeCommands() {
+		std::deque<ReceivedCommand> commands;
+		std::lock_guard<std::mutex> lock(queueLock);
+		commands.swap(queue);
+		return commands;
+	}
+
+	void applyCommand(Vehicle& vehicle, ReceivedCommand& received) {
+		if (received.command.mode == static_cast<std::uint16_t>(RemoteCommandMode::WHEEL_VELOCITY)) {
+			vehicle.lWheel.setTangencialVel(received.command.a);
+			vehicle.rWheel.setTangencialVel(received.command.b);
+		}
+		else {
+			// BODY_VELOCITY, other modes are rejected by the receive thread
+			vehicle.setTangencialVel(received.command.a);
+			vehicle.setAngularVel(received.command.b);
+		}
+		lastCommandTime = received.arrivalTime;
+		commandActive = true;
+		latencies.push_back((getSteadyTimeNs() - received.command.sendTime) * 1e-3);
+	}
+
+	// Stops the vehicle at the watchdog deadline, if it falls before the given time
+	void checkWatchdog(Vehicle& vehicle, std::int64_t& cursor, std::int64_t time) {
+		if (!commandActive || watchdogTimeout <= 0)
+			return;
+		std::int64_t deadline = lastCommandTime + watchdogTimeout;
+		if (deadline > time)
+			return;
+
+		if (deadline > cursor) {
+			step(vehicle, (deadline - cursor) * 1e-9);
+			cursor = deadline;
+		}
+		vehicle.setTangencialVel(0);
+		vehicle.setAngularVel(0);
+		commandActive = false;
+		watchdogStops++;
+		{
+			// The sender may have restarted, the next command starts a new sequence
+			std::lock_guard<std::mutex> lock(queueLock);
+			hasSequence = false;
+		}
+		std::cout << "Remote control watchdog: no command for " << watchdogTimeout * 1e-6 << " [ms], vehicle stopped" << std::endl;
+	}
+
+	void step(Vehicle& vehicle, double deltaTime) {
+		if (journal != nullptr)
+			journal->step(vehicle, deltaTime);
+		else
+			vehicle.recalculate(deltaTime);
+	}
+};
+
+// ==================================================================================================
+// Distributed sweep - coordinator hands out scenario batches to worker processes over TCP
+// ==================================================================================================
+
+enum class SweepMessage {
+	HELLO,		// worker -> coordinator: worker thread count
+	BATCH,		// coordinator -> worker: batch id, scenario count, scenarios
+	RESULTS,	// worker -> coordinator: batch id, result count, results in batch order
+	DONE		// coordinator -> worker: no more work
+};
+
+sf::Packet& operator<<(sf::Packet& packet, const StopConditions& stop) {
+	return packet << stop.scheduleEnd << stop.timeLimit << stop.poseTarget << stop.targetX << stop.targetY << stop.targetTolerance
+		<< stop.bounds << stop.minX << stop.minY << stop.maxX << stop.maxY << stop.standstillSpeed << stop.standstillTime;
+}
+
+sf::Packet& operator>>(sf::Packet& packet, StopConditions& stop) {
+	return packet >> stop.scheduleEnd >> stop.timeLimit >> stop.poseTarget >> stop.targetX >> stop.targetY >> stop.targetTolerance
+		>> stop.bounds >> stop.minX >> stop.minY >> stop.maxX >> stop.maxY >> stop.standstillSpeed >> stop.standstillTime;
+}
+
+sf::Packet& operator<<(sf::Packet& packet, const ScenarioSpec& spec) {
+	return packet << spec.name << static_cast<sf::Uint8>(spec.mode) << spec.parameters[0] << spec.parameters[1] << spec.parameters[2] << spec.scenarioFile << spec.logEnabled << spec.stop;
+}
+
+sf::Packet& operator>>(sf::Packet& packet, ScenarioSpec& spec) {
+	sf::Uint8 mode = 0;
+	packet >> spec.name >> mode >> spec.parameters[0] >> spec.parameters[1] >> spec.parameters[2] >> spec.scenarioFile >> spec.logEnabled >> spec.stop;
+	spec.mode = static_cast<SimulationMode>(mode);
+	return packet;
+}
+
+// Names are not sent back, results are matched to scenarios by batch order
+sf::Packet& operator<<(sf::Packet& packet, const StatisticsSample& sample) {
+	return packet << static_cast<sf::Int64>(sample.steps) << sample.time << sample.pathLength << sample.totalRotation << sample.netRotation
+		<< sample.maxSpeed << sample.meanSpeed << sample.speedDeviation << sample.maxAngularSpeed << sample.leftTravel << sample.rightTravel
+		<< sample.closureError << sample.closureHeading;
+}
+
+sf::Packet& operator>>(sf::Packet& packet, StatisticsSample& sample) {
+	sf::Int64 steps = 0;
+	packet >> steps >> sample.time >> sample.pathLength >> sample.totalRotation >> sample.netRotation
+		>> sample.maxSpeed >> sample.meanSpeed >> sample.speedDeviation >> sample.maxAngularSpeed >> sample.leftTravel >> sample.rightTravel
+		>> sample.closureError >> sample.closureHeading;
+	sample.steps = steps;
+	return packet;
+}
+
+sf::Packet& operator<<(sf::Packet& packet, const ScenarioResult& result) {
+	return packet << result.valid << static_cast<sf::Int64>(result.steps) << result.x << result.y << result.phi << result.wallTime << static_cast<sf::Uint8>(result.stopReason) << result.statistics;
+}
+
+sf::Packet& operator>>(sf::Packet& packet, ScenarioResult& result) {
+	sf::Int64 steps = 0;
+	sf::Uint8 reason = 0;
+	packet >> result.valid >> steps >> result.x >> result.y >> result.phi >> result.wallTime >> reason >> result.statistics;
+	result.stopReason = static_cast<StopReason>(reason);
+	result.steps = static_cast<long>(steps);
+	result.time = getStepTime(result.steps);
+	return packet;
+}
+
+class SweepCoordinator {
+public:
+	SweepCoordinator() {
+		reassignedBatches = 0;
+		droppedWorkers = 0;
+		batchTimeout = SWEEP_BATCH_TIMEOUT;
+	}
+
+	bool listen(unsigned short port) {
+		if (listener.listen(port) != sf::Socket::Done) {
+			std::cout << "Error: Could not listen on port " << port << std::endl;
+			return false;
+		}
+		selector.add(listener);
+		return true;
+	}
+
+	unsigned short getPort() {
+		return this->listener.getLocalPort();
+	}
+
+	size_t getReassignedBatches() {
+		return this->reassignedBatches;
+	}
+
+	// Workers dropped for missing a batch deadline
+	size_t getDroppedWorkers() {
+		return this->droppedWorkers;
+	}
+
+	void setBatchTimeout(double seconds) {
+		this->batchTimeout = seconds;
+	}
+
+	// Batches of a lost worker, or of one that misses the deadline of the batch it is
+	// working on, go back to the front of the queue; a late duplicate result of a
+	// reassigned batch is ignored
+	bool run(const std::vector<ScenarioSpec>& specs, size_t batchSize, std::vector<ScenarioResult>& results) {
+		std::vector<size_t> batchBegin;
+		for (size_t i = 0; i < specs.size(); i += batchSize) {
+			batchBegin.push_back(i);
+		}
+		batchBegin.push_back(specs.size());
+		size_t batchCount = batchBegin.size() - 1;
+
+		results.assign(specs.size(), ScenarioResult());
+		std::deque<size_t> pending;
+		for (size_t i = 0; i < batchCount; i++) {
+			pending.push_back(i);
+		}
+		std::vector<bool> completed(batchCount, false);
+		size_t completedCount = 0;
+		sf::Clock progressTimer;
+		sf::Clock clock;
+
+		while (completedCount < batchCount) {
+			if (progressTimer.getElapsedTime().asSeconds() > SWEEP_TIMEOUT) {
+				std::cout << "Error: Sweep made no progress for " << SWEEP_TIMEOUT << " [s], " << completedCount << "/" << batchCount << " batches done" << std::endl;
+				return false;
+			}
+			bool ready = selector.wait(sf::milliseconds(100));
+
+			if (ready && selector.isReady(listener)) {
+				WorkerConnection worker;
+				worker.socket = std::make_unique<sf::TcpSocket>();
+				if (listener.accept(*worker.socket) == sf::Socket::Done) {
+					selector.add(*worker.socket);
+					workers.push_back(std::move(worker));
+				}
+			}
+
+			for (size_t w = 0; ready && w < workers.size(); ) {
+				WorkerConnection& worker = workers[w];
+				if (!selector.isReady(*worker.socket)) {
+					w++;
+					continue;
+				}
+
+				sf::Packet packet;
+				if (worker.socket->receive(packet) != sf::Socket::Done) {
+					std::cout << "Worker " << worker.socket->getRemoteAddress() << " lost, reassigning " << worker.batches.size() << " batches" << std::endl;
+					dropWorker(w, pending);
+					continue;
+				}
+
+				sf::Uint8 type = 0;
+				packet >> type;
+				if (type == static_cast<sf::Uint8>(SweepMessage::HELLO)) {
+					sf::Uint32 threads = 0;
+					packet >> threads;
+					worker.ready = true;
+					std::cout << "Worker " << worker.socket->getRemoteAddress() << " connected with " << threads << " threads" << std::endl;
+				}
+				else if (type == static_cast<sf::Uint8>(SweepMessage::RESULTS)) {
+					sf::Uint32 batch = 0, count = 0;
+					packet >> batch >> count;
+					if (batch < batchCount && !completed[batch] && count == batchBegin[batch + 1] - batchBegin[batch]) {
+						for (size_t i = batchBegin[batch]; i < batchBegin[batch + 1]; i++) {
+							packet >> results[i];
+							results[i].name = specs[i].name;
+						}
+						completed[batch] = true;
+						completedCount++;
+						progressTimer.restart();
+					}
+					worker.batches.erase(std::remove_if(worker.batches.begin(), worker.batches.end(), [batch](const InFlightBatch& inFlight) {
+						return inFlight.batch == batch;
+					}), worker.batches.end());
+					// The worker moves on to its next batch now
+					if (!worker.batches.empty())
+						worker.batches.front().deadline = std::min(worker.batches.front().deadline, clock.getElapsedTime().asSeconds() + batchTimeout);
+				}
+				w++;
+			}
+
+			// A worker that stalls with its connection open would hold its batches forever
+			double now = clock.getElapsedTime().asSeconds();
+			for (size_t w = 0; w < workers.size(); ) {
+				if (!workers[w].batches.empty() && workers[w].batches.front().deadline < now) {
+					std::cout << "Worker " << workers[w].socket->getRemoteAddress() << " missed the deadline of batch " << workers[w].batches.front().batch
+						<< ", dropped, reassigning " << workers[w].batches.size() << " batches" << std::endl;
+					workers[w].socket->disconnect();
+					dropWorker(w, pending);
+					droppedWorkers++;
+					continue;
+				}
+				w++;
+			}
+
+			for (WorkerConnection& worker : workers) {
+				while (worker.ready && worker.batches.size() < SWEEP_BATCHES_IN_FLIGHT && !pending.empty()) {
+					size_t batch = pending.front();
+					pending.pop_front();
+					if (completed[batch])
+						continue;
+
+					sf::Packet packet;
+					packet << static_cast<sf::Uint8>(SweepMessage::BATCH) << static_cast<sf::Uint32>(batch) << static_cast<sf::Uint32>(batchBegin[batch + 1] - batchBegin[batch]);
+					for (size_t i = batchBegin[batch]; i < batchBegin[batch + 1]; i++) {
+						packet << specs[i];
+					}
+					if (worker.socket->send(packet) != sf::Socket::Done) {
+						pending.push_front(batch);
+						break;
+					}
+					// Batches queued behind another one get their deadline when the worker starts them
+					worker.batches.push_back(InFlightBatch{ batch, worker.batches.empty() ? now + batchTimeout : INFINITY });
+				}
+			}
+		}
+
+		for (WorkerConnection& worker : workers) {
+			sf::Packet packet;
+			packet << static_cast<sf::Uint8>(SweepMessage::DONE);
+			worker.socket->send(packet);
+			selector.remove(*worker.socket);
+			worker.socket->disconnect();
+		}
+		workers.clear();
+		return true;
+	}
+
+private:
+	struct InFlightBatch {
+		size_t batch;
+		double deadline;	//[s] of the coordinator clock
+	};
+
+	struct WorkerConnection {
+		std::unique_ptr<sf::TcpSocket> socket;
+		std::vector<InFlightBatch> batches;
+		bool ready = false;
+	};
+
+	sf::TcpListener listener;
+	sf::SocketSelector selector;
+	std::vector<WorkerConnection> workers;
+	size_t reassignedBatches;
+	size_t droppedWorkers;
+	double batchTimeout;
+
+	void dropWorker(size_t index, std::deque<size_t>& pending) {
+		WorkerConnection& worker = workers[index];
+		for (const InFlightBatch& inFlight : worker.batches) {
+			pending.push_front(inFlight.batch);
+		}
+		reassignedBatches += worker.batches.size();
+		selector.remove(*worker.socket);
+		workers.erase(workers.begin() + index);
+	}
+};
+
+class SweepWorker {
+public:
+	// failAfter > 0 drops the connection when the next batch arrives, stallAfter > 0 stops
+	// answering with the connection open, to test reassignment
+	int run(const std::string& host, unsigned short port, unsigned int threads, int failAfter, int stallAfter) {
+		sf::TcpSocket socket;
+		bool connected = false;
+		for (int i = 0; i < SWEEP_CONNECT_RETRIES && !connected; i++) {
+			connected = (socket.connect(host, port, sf::seconds(1)) == sf::Socket::Done);
+			if (!connected)
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+		if (!connected) {
+			std::cout << "Error: Could not connect to coordinator " << host << ":" << port << std::endl;
+			return -1;
+		}
+
+		JobSystem jobs(threads);
+		sf::Packet hello;
+		hello << static_cast<sf::Uint8>(SweepMessage::HELLO) << static_cast<sf::Uint32>(jobs.getWorkerCount());
+		socket.send(hello);
+
+		int batchesReceived = 0;
 		while (true) {
-			std::cin >> n;
-			if (std::cin.fail()) {
-				std::cin.clear();
-				std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-				std::cout << "Invalid input. Please enter a number.\n";
+			sf::Packet packet;
+			if (socket.receive(packet) != sf::Socket::Done) {
+				std::cout << "Error: Coordinator disconnected" << std::endl;
+				return -1;
+			}
+
+			sf::Uint8 type = 0;
+			packet >> type;
+			if (type == static_cast<sf::Uint8>(SweepMessage::DONE))
+				return 0;
+			if (type != static_cast<sf::Uint8>(SweepMessage::BATCH))
 				continue;
+
+			sf::Uint32 batch = 0, count = 0;
+			packet >> batch >> count;
+			std::vector<ScenarioSpec> specs(count);
+			for (ScenarioSpec& spec : specs) {
+				packet >> spec;
+			}
+
+			batchesReceived++;
+			if (failAfter > 0 && batchesReceived > failAfter) {
+				std::cout << "Simulated worker failure after " << failAfter << " batches" << std::endl;
+				return -1;
+			}
+			if (stallAfter > 0 && batchesReceived > stallAfter) {
+				if (batchesReceived == stallAfter + 1)
+					std::cout << "Simulated worker stall after " << stallAfter << " batches" << std::endl;
+				continue;
+			}
+
+			std::vector<ScenarioResult> results = runScenarios(specs, jobs);
+			sf::Packet reply;
+			reply << static_cast<sf::Uint8>(SweepMessage::RESULTS) << batch << count;
+			for (ScenarioResult& result : results) {
+				reply << result;
+			}
+			if (socket.send(reply) != sf::Socket::Done) {
+				std::cout << "Error: Could not send results of batch " << batch << std::endl;
+				return -1;
+			}
+		}
+	}
+};
+
+void spawnProcess(const std::string& command) {
+#ifdef _WIN32
+	std::system(("start \"\" /B " + command).c_str());
+#else
+	std::system((command + " &").c_str());
+#endif
+}
+
+void writeSweepResults(const std::vector<ScenarioResult>& results) {
+	std::filesystem::create_directory("logData");
+	std::ofstream resultFile(SWEEP_RESULTS_FILE, std::ios::out);
+	resultFile << "name;steps;t[s];xT[m];yT[m];phiT[rad];wall[s];stop;path[m];rotation[rad];max v[m/s];mean v[m/s];L travel[m];R travel[m];closure[m];\n";
+	for (const ScenarioResult& result : results) {
+		const StatisticsSample& statistics = result.statistics;
+		resultFile << result.name << ";" << result.steps << ";" << result.time << ";" << result.x << ";" << result.y << ";" << result.phi << ";" << result.wallTime << ";" << getStopReasonName(result.stopReason) << ";"
+			<< statistics.pathLength << ";" << statistics.totalRotation << ";" << statistics.maxSpeed << ";" << statistics.meanSpeed << ";"
+			<< statistics.leftTravel << ";" << statistics.rightTravel << ";" << statistics.closureError << ";\n";
+	}
+	std::cout << "Results written to " << SWEEP_RESULTS_FILE << std::endl;
+}
+
+void b_one() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setVectorSimulation();
+	config.setPositionResetStatus(true);
+	config.setTimerResetStatus(true);
+	config.setDataStatus(true);
+}
+void b_second() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setRectangleSimulation();
+	config.setPositionResetStatus(true);
+	config.setTimerResetStatus(true);
+	config.setDataStatus(true);
+}
+void b_third() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setCurveSimulation();
+	config.setPositionResetStatus(true);
+	config.setTimerResetStatus(true);
+	config.setDataStatus(true);
+}
+void b_fourth() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setGameSimulation();
+	config.setPositionResetStatus(true);
+	config.setTimerResetStatus(true);
+}
+
+void b_sim() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setSimulationMode();
+	config.setPositionResetStatus(true);
+	config.setTimerResetStatus(true);
+}
+void b_game() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setGameMode();
+	config.setPositionResetStatus(true);
+	config.setTimerResetStatus(true);
+}
+
+void b_lMode() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setLightMode();
+	config.setChangeStatus(true);
+}
+void b_dMode() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setDarkMode();
+	config.setChangeStatus(true);
+}
+
+void b_posReset() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setPositionResetStatus(true);
+}
+void b_timeReset() {
+	AppConfig& config = AppConfig::getInstance();
+	config.setTimerResetStatus(true);
+}
+
+// ==================================================================================================
+// Headless commands - benchmarks and tools running without the window
+// ==================================================================================================
+
+int benchScenarioLoader(const std::vector<std::string>& args) {
+	double sizeMB = SCENARIO_BENCH_SIZE_MB;
+	if (args.size() > 1)
+		sizeMB = parseArgument<double>(args[1], DBL_MIN);
+	size_t targetSize = static_cast<size_t>(sizeMB * 1024 * 1024);
+
+	std::filesystem::create_directory("logData");
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Generating " << sizeMB << " MB scenario file " << SCENARIO_BENCH_FILE << std::endl;
+
+	std::ofstream benchFile(SCENARIO_BENCH_FILE, std::ios::out | std::ios::binary);
+	if (!benchFile.is_open()) {
+		std::cout << "Error: Could not open file for writing" << std::endl;
+		return -1;
+	}
+	benchFile << "t[s];vL[m/s];vR[m/s]\n";
+
+	std::vector<char> buffer(1 << 20);
+	size_t written = 0;
+	size_t generatedRows = 0;
+	while (written < targetSize) {
+		char* p = buffer.data();
+		char* end = buffer.data() + buffer.size();
+		while (p < end - 128 && written + (p - buffer.data()) < targetSize) {
+			double t = generatedRows * SIMULATION_FIXED_STEP;
+			p = std::to_chars(p, end, t, std::chars_format::fixed, 3).ptr;
+			*p++ = SCENARIO_SEPARATOR;
+			p = std::to_chars(p, end, 0.5 + 0.4 * sin(t * 0.1), std::chars_format::fixed, 6).ptr;
+			*p++ = SCENARIO_SEPARATOR;
+			p = std::to_chars(p, end, 0.5 + 0.4 * cos(t * 0.07), std::chars_format::fixed, 6).ptr;
+			*p++ = '\n';
+			generatedRows++;
+		}
+		benchFile.write(buffer.data(), p - buffer.data());
+		written += p - buffer.data();
+	}
+	benchFile.close();
+	std::cout << "Generated " << generatedRows << " rows" << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	VelocitySchedule schedule;
+	std::vector<double> rowsPerSecond;
+	for (int i = 0; i < SCENARIO_BENCH_REPETITIONS; i++) {
+		auto start = std::chrono::high_resolution_clock::now();
+		if (!schedule.loadFromFile(SCENARIO_BENCH_FILE))
+			return -1;
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+
+		double seconds = std::max<double>(duration.count(), 1) * TIME_uS;
+		rowsPerSecond.push_back(schedule.size() / seconds);
+		printf("Run %d | rows = %zu | t = %.3f [ms] | %.3f [Mrows/s] | %.1f [MB/s]\n", i + 1, schedule.size(), seconds / TIME_mS, rowsPerSecond.back() * 1e-6, written / seconds / (1024 * 1024));
+	}
+	if (schedule.size() != generatedRows) {
+		std::cout << "Error: Loaded " << schedule.size() << " rows, expected " << generatedRows << std::endl;
+		return -1;
+	}
+
+	std::sort(rowsPerSecond.begin(), rowsPerSecond.end());
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("Median throughput: %.3f [Mrows/s]\n", rowsPerSecond[rowsPerSecond.size() / 2] * 1e-6);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return 0;
+}
+
+int benchJobSystem(const std::vector<std::string>& args) {
+	unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	double profileHours = JOB_BENCH_PROFILE_HOURS;
+	if (args.size() > 1)
+		maxThreads = parseArgument<unsigned int>(args[1], 1);
+	if (args.size() > 2)
+		profileHours = parseArgument<double>(args[2], DBL_MIN);
+
+	// Recorded-like profile with a speed change every second
+	std::filesystem::create_directory("logData");
+	std::ofstream profileFile(JOB_BENCH_PROFILE_FILE, std::ios::out);
+	long profileSeconds = static_cast<long>(profileHours * 3600);
+	for (long t = 0; t < profileSeconds; t++) {
+		profileFile << t << SCENARIO_SEPARATOR << 0.5 + 0.4 * sin(t * 0.01) << SCENARIO_SEPARATOR << 0.5 + 0.4 * cos(t * 0.013) << '\n';
+	}
+	profileFile << profileSeconds << SCENARIO_SEPARATOR << 0 << SCENARIO_SEPARATOR << 0 << '\n';
+	profileFile.close();
+
+	// Enough short maneuvers next to the long profile to keep every core busy
+	std::vector<ScenarioSpec> specs;
+	ScenarioSpec profile;
+	profile.name = "profile";
+	profile.mode = SimulationMode::VECTOR;
+	profile.scenarioFile = JOB_BENCH_PROFILE_FILE;
+	specs.push_back(profile);
+
+	long profileSteps = static_cast<long>(profileSeconds * SIMULATION_SECOND_STEP_AMOUNT);
+	long shortRuns = std::max(64L, profileSteps * static_cast<long>(maxThreads) / 1000);
+	std::vector<ScenarioSpec> maneuvers = makeManeuverSweep(shortRuns);
+	specs.insert(specs.end(), maneuvers.begin(), maneuvers.end());
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Workload: " << profileHours << " h profile + " << shortRuns << " rectangle/curve runs" << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	double baseline = 0;
+	for (unsigned int threads = 1; threads <= maxThreads; threads = (threads == maxThreads) ? threads + 1 : std::min(threads * 2, maxThreads)) {
+		JobSystem jobs(threads);
+		auto start = std::chrono::high_resolution_clock::now();
+		std::vector<ScenarioResult> results = runScenarios(specs, jobs);
+		double seconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() * TIME_uS;
+
+		long totalSteps = 0;
+		double longest = 0;
+		double busy = 0;
+		for (ScenarioResult& result : results) {
+			totalSteps += result.steps;
+			longest = std::max(longest, result.wallTime);
+			busy += result.wallTime;
+		}
+		if (threads == 1)
+			baseline = seconds;
+
+		// Best possible makespan is limited by total work and by the longest scenario
+		double bound = std::max(busy / threads, longest);
+		printf("threads = %2u | t = %8.3f [s] | %8.3f [Msteps/s] | speedup = %5.2f | utilization = %5.1f %%\n",
+			threads, seconds, totalSteps / seconds * 1e-6, baseline / seconds, 100.0 * bound / seconds);
+	}
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return 0;
+}
+
+// Hot paths of the simulation in isolation. Optional filter runs only benchmarks whose
+// name contains it, drawTrail needs a graphics context for its render texture.
+int benchMicro(const std::vector<std::string>& args) {
+	std::string filter = (args.size() > 1 && args[1] != "all") ? args[1] : "";
+	std::string resultPath = (args.size() > 2) ? args[2] : MICROBENCH_RESULTS_FILE;
+	auto selected = [&](const std::string& name) {
+		return name.find(filter) != std::string::npos;
+	};
+
+	Benchmark bench(MICROBENCH_WARMUP, MICROBENCH_REPETITIONS);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Warmup " << MICROBENCH_WARMUP << ", at least " << MICROBENCH_REPETITIONS << " repetitions, time per operation" << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	if (selected("Vehicle::recalculate")) {
+		for (long fleetSize : { 1L, 64L, 1024L }) {
+			std::vector<Vehicle> fleet;
+			for (long i = 0; i < fleetSize; i++) {
+				fleet.emplace_back(DEFAULT_WHEELBASE);
+				fleet.back().lWheel.setTangencialVel(0.4 + i * 1e-3);
+				fleet.back().rWheel.setTangencialVel(0.5);
+			}
+			long steps = std::max(16L, 65536 / fleetSize);
+			bench.run("Vehicle::recalculate", fleetSize, fleetSize * steps, [&]() {
+				for (long s = 0; s < steps; s++) {
+					for (Vehicle& vehicle : fleet) {
+						vehicle.recalculate(SIMULATION_FIXED_STEP);
+					}
+				}
+				benchmarkSink = fleet.back().getX();
+			});
+		}
+	}
+
+	if (selected("Vehicle::sampleWheelTrails")) {
+		Vehicle vehicle(DEFAULT_WHEELBASE);
+		vehicle.lWheel.setTangencialVel(0.4);
+		vehicle.rWheel.setTangencialVel(0.5);
+		const long operations = 65536;
+		bench.run("Vehicle::sampleWheelTrails", 1, operations, [&]() {
+			for (long i = 0; i < operations; i++) {
+				vehicle.recalculate(SIMULATION_FIXED_STEP);
+				vehicle.sampleWheelTrails();
+			}
+			benchmarkSink = vehicle.lWheel.trail.getX(0);
+		});
+	}
+
+	if (selected("SimulationData::setVehicleSpeed")) {
+		for (long breakpoints : { 16L, 1024L, 65536L }) {
+			SimulationData data;
+			for (long i = 0; i < breakpoints; i++) {
+				data.getSchedule().addBreakpoint(i * 0.01, 0.3 + (i % 7) * 0.05, 0.3 + (i % 5) * 0.05);
+			}
+			Vehicle vehicle(DEFAULT_WHEELBASE);
+			const long operations = 65536;
+			double endTime = data.getSchedule().getEndTime();
+
+			// Time only moves forward in a simulation, the usual case
+			bench.run("SimulationData::setVehicleSpeed", breakpoints, operations, [&]() {
+				data.getSchedule().resetCursor();
+				for (long i = 0; i < operations; i++) {
+					data.setVehicleSpeed(endTime * i / operations, vehicle);
+				}
+				benchmarkSink = vehicle.lWheel.getTangencialVel();
+			});
+
+			// Jumps after a timer reset or seek
+			std::vector<double> times(operations);
+			std::uint32_t state = 12345;
+			for (double& time : times) {
+				state = state * 1664525u + 1013904223u;
+				time = endTime * (state >> 8) / double(1 << 24);
+			}
+			bench.run("SimulationData::setVehicleSpeed(random)", breakpoints, operations, [&]() {
+				for (double time : times) {
+					data.setVehicleSpeed(time, vehicle);
+				}
+				benchmarkSink = vehicle.lWheel.getTangencialVel();
+			});
+		}
+	}
+
+	if (selected("FileHandler::writeToFile")) {
+		Vehicle vehicle(DEFAULT_WHEELBASE);
+		vehicle.lWheel.setTangencialVel(0.4);
+		vehicle.rWheel.setTangencialVel(0.5);
+		vehicle.recalculate(SIMULATION_FIXED_STEP);
+		{
+			FileHandler log("microbench_write");
+			const long rows = 4096;
+			bench.run("FileHandler::writeToFile", 15, rows, [&]() {
+				for (long i = 0; i < rows; i++) {
+					log.writeVehicleState(getStepTime(i), i, vehicle);
+				}
+				log.flush();
+			});
+		}
+		std::filesystem::remove("logData/microbench_write.csv");
+	}
+
+	if (selected("Trail::addTrailPoint")) {
+		for (int trailLength : { DEFAULT_TRAIL_LEN, DEFAULT_TRAIL_LEN * 10, DEFAULT_TRAIL_LEN * 100 }) {
+			Trail trail;
+			trail.changeTrailSettings(trailLength, 0);
+			const long operations = 65536;
+			bench.run("Trail::addTrailPoint", trailLength, operations, [&]() {
+				for (long i = 0; i < operations; i++) {
+					trail.addTrailPoint(i * 1e-3, -i * 1e-3);
+				}
+			});
+		}
+	}
+
+	if (selected("drawTrail")) {
+		sf::RenderTexture texture;
+		if (!texture.create(1920, 1080)) {
+			std::cout << "Error: Could not create render texture, drawTrail skipped" << std::endl;
+		}
+		else {
+			texture.setView(sf::View(sf::Vector2f(0, 0), sf::Vector2f(1920, 1080)));
+			for (int trailLength : { DEFAULT_TRAIL_LEN, DEFAULT_TRAIL_LEN * 10, DEFAULT_TRAIL_LEN * 100 }) {
+				Trail trail;
+				trail.changeTrailSettings(trailLength, 0);
+				for (int i = 0; i < trailLength; i++) {
+					trail.addTrailPoint(cos(i * 0.01) * 3, sin(i * 0.01) * 3);
+				}
+				bench.run("drawTrail", trailLength, 1, [&]() {
+					texture.clear();
+					drawTrail(texture, trail, sf::Color::White);
+					texture.display();
+				});
 			}
-			std::cout << CLI_SIMPLE_SEP << std::endl;
+		}
+	}
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	bool written = bench.writeResults(resultPath);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return written ? 0 : -1;
+}
+
+// Runs rectangles, curves and random vector schedules with every integration method over a
+// range of time steps. Errors are measured at the end of the schedule against
+//   - the continuous schedule integrated exactly (speed changes at the breakpoint times),
+//   - the speeds the simulation actually sampled integrated exactly, i.e. integration error only.
+int benchIntegrators(const std::vector<std::string>& args) {
+	double tolerance = (args.size() > 1) ? parseArgument<double>(args[1], DBL_MIN) : INTEGRATOR_DEFAULT_TOLERANCE;
+	int randomSchedules = (args.size() > 2) ? parseArgument<int>(args[2], 0) : 4;
+
+	std::vector<std::pair<std::string, SimulationData>> scenarios;
+	for (double side : { 1.0, 2.5 }) {
+		scenarios.emplace_back("rectangle_" + std::to_string(side), SimulationData());
+		scenarios.back().second.setRectangleData(side);
+	}
+	for (double radius : { 0.5, 1.5 }) {
+		scenarios.emplace_back("curve_" + std::to_string(radius), SimulationData());
+		scenarios.back().second.setCurveData(radius, 1.0, radius * 0.6);
+	}
+	std::mt19937 generator(2024);
+	std::uniform_real_distribution<double> duration(0.2, 2.0);
+	std::uniform_real_distribution<double> speed(-0.4, 0.8);
+	for (int i = 0; i < randomSchedules; i++) {
+		scenarios.emplace_back("random_" + std::to_string(i), SimulationData());
+		double time = 0;
+		for (int segment = 0; segment < 20; segment++) {
+			scenarios.back().second.getSchedule().addBreakpoint(time, speed(generator), speed(generator));
+			time += duration(generator);
+		}
+		scenarios.back().second.getSchedule().addBreakpoint(time, 0, 0);
+	}
+
+	const std::vector<IntegrationMethod> methods = { IntegrationMethod::EULER, IntegrationMethod::MIDPOINT, IntegrationMethod::RK4, IntegrationMethod::EXACT_ARC };
+	const std::vector<double> steps = { 0.0005, 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1 };
+
+	std::filesystem::create_directory("logData");
+	std::ofstream resultFile(INTEGRATOR_RESULTS_FILE, std::ios::out);
+	resultFile << "scenario;method;dt[s];steps;position error[m];heading error[rad];integration error[m];ns per step;ns per simulated second;\n";
+
+	// Worst case over all scenarios for every method and step
+	std::map<std::pair<size_t, size_t>, double> worstError, worstHeading, worstIntegration, cost;
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << scenarios.size() << " scenarios, " << methods.size() << " methods, " << steps.size() << " time steps" << std::endl;
+	for (auto& scenario : scenarios) {
+		VelocitySchedule& schedule = scenario.second.getSchedule();
+		Vehicle start(DEFAULT_WHEELBASE);
+		long double refX = start.getX(), refY = start.getY(), refPhi = start.getPhi();
+		for (size_t i = 0; i + 1 < schedule.size(); i++) {
+			long double vL = schedule.getLeftSpeed(i), vR = schedule.getRightSpeed(i);
+			integrateArc(refX, refY, refPhi, (vR + vL) / 2, (vR - vL) / DEFAULT_WHEELBASE, schedule.getTime(i + 1) - schedule.getTime(i));
+		}
+		double endTime = schedule.getEndTime();
+
+		for (size_t m = 0; m < methods.size(); m++) {
+			for (size_t d = 0; d < steps.size(); d++) {
+				double dt = steps[d];
+				long stepCount = static_cast<long>(ceil(endTime / dt)) + 1;
+
+				// Sampled speeds integrated exactly, outside the timed runs
+				Vehicle sampled(DEFAULT_WHEELBASE);
+				long double sampledX = sampled.getX(), sampledY = sampled.getY(), sampledPhi = sampled.getPhi();
+				schedule.resetCursor();
+				for (long k = 0; k < stepCount; k++) {
+					scenario.second.setVehicleSpeed(k * dt, sampled);
+					long double vL = sampled.lWheel.getTangencialVel(), vR = sampled.rWheel.getTangencialVel();
+					integrateArc(sampledX, sampledY, sampledPhi, (vR + vL) / 2, (vR - vL) / DEFAULT_WHEELBASE, dt);
+				}
+
+				std::vector<double> times;
+				double x = 0, y = 0, phi = 0;
+				for (int r = 0; r < INTEGRATOR_REPETITIONS; r++) {
+					Vehicle vehicle(DEFAULT_WHEELBASE);
+					vehicle.setIntegrationMethod(methods[m]);
+					schedule.resetCursor();
+					auto timer = std::chrono::steady_clock::now();
+					for (long k = 0; k < stepCount; k++) {
+						scenario.second.setVehicleSpeed(k * dt, vehicle);
+						vehicle.recalculate(dt);
+					}
+					times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - timer).count());
+					x = vehicle.getX();
+					y = vehicle.getY();
+					phi = vehicle.getPhi();
+				}
+				std::sort(times.begin(), times.end());
+				double nanoseconds = times[times.size() / 2];
+
+				double positionError = hypot(x - static_cast<double>(refX), y - static_cast<double>(refY));
+				double headingError = getHeadingError(phi, static_cast<double>(refPhi));
+				double integrationError = hypot(x - static_cast<double>(sampledX), y - static_cast<double>(sampledY));
+				resultFile << scenario.first << ";" << getIntegrationMethodName(methods[m]) << ";" << dt << ";" << stepCount << ";" << positionError << ";"
+					<< headingError << ";" << integrationError << ";" << nanoseconds / stepCount << ";" << nanoseconds / endTime << ";\n";
+
+				auto key = std::make_pair(m, d);
+				worstError[key] = std::max(worstError[key], positionError);
+				worstHeading[key] = std::max(worstHeading[key], headingError);
+				worstIntegration[key] = std::max(worstIntegration[key], integrationError);
+				cost[key] = std::max(cost[key], nanoseconds / endTime);
+			}
+		}
+	}
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	std::cout << "Worst case over all scenarios:" << std::endl;
+	printf("%-10s %8s %16s %16s %16s %16s\n", "method", "dt [s]", "position [m]", "heading [rad]", "integration [m]", "ns / sim. s");
+	bool found = false;
+	std::pair<size_t, size_t> cheapest;
+	for (size_t m = 0; m < methods.size(); m++) {
+		for (size_t d = 0; d < steps.size(); d++) {
+			auto key = std::make_pair(m, d);
+			printf("%-10s %8.4f %16.3e %16.3e %16.3e %16.0f\n", getIntegrationMethodName(methods[m]), steps[d], worstError[key], worstHeading[key], worstIntegration[key], cost[key]);
+			if (worstError[key] <= tolerance && (!found || cost[key] < cost[cheapest])) {
+				cheapest = key;
+				found = true;
+			}
+		}
+	}
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	if (found) {
+		printf("Cheapest within %g [m]: %s, dt = %g [s], %.0f ns per simulated second\n", tolerance, getIntegrationMethodName(methods[cheapest.first]), steps[cheapest.second], cost[cheapest]);
+	}
+	else {
+		printf("No method and time step within %g [m]\n", tolerance);
+	}
+	std::cout << "Results written to " << INTEGRATOR_RESULTS_FILE << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return 0;
+}
+
+// Cost of dd_step_batch per vehicle step for growing batches, one step per call as a
+// controller in lockstep would use it and many steps per call, next to stepping the same
+// number of Vehicle objects. Checks first that both give identical poses.
+int benchCApi(const std::vector<std::string>& args) {
+	long maxBatch = (args.size() > 1) ? parseArgument<long>(args[1], 1) : API_BENCH_MAX_BATCH;
+	dd_step_params params = { SIMULATION_FIXED_STEP, DEFAULT_WHEELBASE, DD_INTEGRATION_EULER, 0 };
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "C API version " << dd_get_api_version() << ", vehicle steps per repetition " << API_BENCH_VEHICLE_STEPS << std::endl;
+
+	bool identical = true;
+	for (int method = DD_INTEGRATION_EULER; method <= DD_INTEGRATION_EXACT_ARC; method++) {
+		Vehicle vehicle(DEFAULT_WHEELBASE);
+		vehicle.setIntegrationMethod(static_cast<IntegrationMethod>(method));
+		dd_vehicle_state state;
+		dd_init_states(&state, 1);
+		dd_step_params methodParams = params;
+		methodParams.integration = method;
+		for (int segment = 0; segment < 50; segment++) {
+			dd_wheel_command command = { 0.3 + (segment % 7) * 0.05, 0.3 + (segment % 5) * 0.07 };
+			vehicle.lWheel.setTangencialVel(command.left);
+			vehicle.rWheel.setTangencialVel(command.right);
+			for (int step = 0; step < 40; step++) {
+				vehicle.recalculate(params.dt);
+			}
+			dd_step_batch(&state, &command, 1, 40, &methodParams);
+		}
+		identical = identical && state.x == vehicle.getX() && state.y == vehicle.getY() && state.phi == vehicle.getPhi();
+	}
+	std::cout << "Poses identical to Vehicle::recalculate: " << (identical ? "yes" : "NO") << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	Benchmark bench(1, API_BENCH_REPETITIONS);
+	for (long batch = 1; batch <= maxBatch; batch *= 10) {
+		std::vector<dd_vehicle_state> states(batch);
+		std::vector<dd_wheel_command> commands(batch);
+		dd_init_states(states.data(), states.size());
+		for (long i = 0; i < batch; i++) {
+			commands[i] = { 0.4 + i * 1e-7, 0.5 };
+		}
+		long calls = std::max(1L, API_BENCH_VEHICLE_STEPS / batch);
+
+		bench.run("dd_step_batch(1 step)", batch, batch * calls, [&]() {
+			for (long call = 0; call < calls; call++) {
+				dd_step_batch(states.data(), commands.data(), states.size(), 1, &params);
+			}
+			benchmarkSink = states.back().x;
+		});
+
+		const unsigned int stepsPerCall = 100;
+		long longCalls = std::max(1L, calls / stepsPerCall);
+		bench.run("dd_step_batch(100 steps)", batch, batch * longCalls * stepsPerCall, [&]() {
+			for (long call = 0; call < longCalls; call++) {
+				dd_step_batch(states.data(), commands.data(), states.size(), stepsPerCall, &params);
+			}
+			benchmarkSink = states.back().x;
+		});
+
+		// Every Vehicle keeps three trails, a million of them is not worth the memory
+		if (batch <= 10000) {
+			std::vector<Vehicle> fleet;
+			for (long i = 0; i < batch; i++) {
+				fleet.emplace_back(DEFAULT_WHEELBASE);
+				fleet.back().lWheel.setTangencialVel(commands[i].left);
+				fleet.back().rWheel.setTangencialVel(commands[i].right);
+			}
+			bench.run("Vehicle::recalculate", batch, batch * calls, [&]() {
+				for (long call = 0; call < calls; call++) {
+					for (Vehicle& vehicle : fleet) {
+						vehicle.recalculate(params.dt);
+					}
+				}
+				benchmarkSink = fleet.back().getX();
+			});
+		}
+	}
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	bool written = bench.writeResults(API_BENCH_RESULTS_FILE);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (written && identical) ? 0 : -1;
+}
+
+// Snapshot and fork of a running scenario: cost of saving and restoring the state, checks
+// that a restored run and an unchanged fork end exactly where the original does, then
+// continues variants with the rest of the schedule moved earlier in parallel
+int benchSnapshot(const std::vector<std::string>& args) {
+	int variants = (args.size() > 1) ? parseArgument<int>(args[1], 1) : 8;
+	double forkTime = (args.size() > 2) ? parseArgument<double>(args[2], 0) : 3.5;
+
+	ScenarioSpec spec;
+	spec.name = "snapshot";
+	spec.mode = SimulationMode::RECTANGLE;
+	spec.parameters[0] = 2.0;
+	ScenarioRun original(spec);
+	if (!original.prepare())
+		return -1;
+	original.getVehicle().setTrailSettings(DEFAULT_TRAIL_LEN * 10, 3);
+	long forkStep = std::min(static_cast<long>(forkTime * SIMULATION_SECOND_STEP_AMOUNT), original.getTotalSteps());
+	while (original.getStep() < forkStep) {
+		original.step();
+	}
+
+	std::vector<char> blob;
+	std::vector<double> saveTimes, restoreTimes;
+	ScenarioRun restored(spec);
+	restored.prepare();
+	for (int i = 0; i < SNAPSHOT_BENCH_REPETITIONS; i++) {
+		auto start = std::chrono::steady_clock::now();
+		original.saveSnapshot(blob);
+		auto saved = std::chrono::steady_clock::now();
+		if (!restored.restoreSnapshot(blob))
+			return -1;
+		saveTimes.push_back(std::chrono::duration<double, std::micro>(saved - start).count());
+		restoreTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - saved).count());
+	}
+	std::sort(saveTimes.begin(), saveTimes.end());
+	std::sort(restoreTimes.begin(), restoreTimes.end());
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("Snapshot at step %ld: %zu bytes | save %.2f us | restore %.2f us (median of %d)\n", forkStep, blob.size(),
+		saveTimes[saveTimes.size() / 2], restoreTimes[restoreTimes.size() / 2], SNAPSHOT_BENCH_REPETITIONS);
+
+	// Trailing bytes are rejected and leave the run as it was
+	std::vector<char> damaged = blob;
+	damaged.push_back(0);
+	ScenarioRun untouched(spec);
+	untouched.prepare();
+	bool rejected = !untouched.restoreSnapshot(damaged) && untouched.getStep() == 0 && untouched.getVehicle().getX() == 0
+		&& untouched.getData().getSchedule().getCursor() == 0;
+	std::cout << "Damaged snapshot rejected without changing the run: " << (rejected ? "yes" : "NO") << std::endl;
+
+	auto start = std::chrono::steady_clock::now();
+	std::unique_ptr<ScenarioRun> unchanged = original.fork();
+	printf("Fork: %.2f us\n", std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+
+	ScenarioResult reference = original.run();
+	ScenarioResult fromSnapshot = restored.run();
+	ScenarioResult fromFork = unchanged->run();
+	bool identical = fromSnapshot.x == reference.x && fromSnapshot.y == reference.y && fromSnapshot.phi == reference.phi
+		&& fromFork.x == reference.x && fromFork.y == reference.y && fromFork.phi == reference.phi;
+	std::cout << "Restored snapshot and fork end identical to the original: " << (identical ? "yes" : "NO") << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	// Variant i applies every speed change after the fork i * SNAPSHOT_VARIANT_SHIFT earlier
+	ScenarioRun base(spec);
+	base.prepare();
+	base.restoreSnapshot(blob);
+	VelocitySchedule& schedule = base.getData().getSchedule();
+	size_t nextBreakpoint = 0;
+	while (nextBreakpoint < schedule.size() && schedule.getTime(nextBreakpoint) <= forkTime) {
+		nextBreakpoint++;
+	}
+
+	std::vector<std::unique_ptr<ScenarioRun>> forks;
+	std::vector<double> shifts;
+	for (int i = 0; i < variants; i++) {
+		double shift = -SNAPSHOT_VARIANT_SHIFT * i;
+		std::unique_ptr<ScenarioRun> variant = base.fork();
+		VelocitySchedule& variantSchedule = variant->getData().getSchedule();
+		if (nextBreakpoint >= variantSchedule.size() || variantSchedule.getTime(nextBreakpoint) + shift <= forkTime
+			|| !variantSchedule.shiftBreakpoints(nextBreakpoint, shift)) {
+			std::cout << "Variant " << i << ": shift of " << shift << " [s] reaches before the fork, skipped" << std::endl;
+			continue;
+		}
+		variant->setTotalSteps(ScenarioRun::getStepCount(variant->getData()));
+		forks.push_back(std::move(variant));
+		shifts.push_back(shift);
+	}
+
+	std::vector<ScenarioResult> results(forks.size());
+	JobSystem jobs(std::max(1u, std::thread::hardware_concurrency()));
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < forks.size(); i++) {
+		jobs.submit([&, i] {
+			results[i] = forks[i]->run();
+		});
+	}
+	jobs.wait();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%-8s %10s %12s %12s %12s\n", "variant", "shift [s]", "x [m]", "y [m]", "phi [rad]");
+	for (size_t i = 0; i < forks.size(); i++) {
+		printf("%-8zu %10.2f %12.6f %12.6f %12.6f\n", i, shifts[i], results[i].x, results[i].y, results[i].phi);
+	}
+	printf("%zu variants continued in %.3f [s] on %u threads\n", forks.size(), seconds, jobs.getWorkerCount());
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (identical && rejected) ? 0 : -1;
+}
+
+// Long random schedule recorded into a Timeline, then random seeks and a slow drag back
+// over the whole run. Every seek is compared with the pose of a straight run.
+int benchTimeline(const std::vector<std::string>& args) {
+	double minutes = (args.size() > 1) ? parseArgument<double>(args[1], DBL_MIN) : TIMELINE_BENCH_MINUTES;
+	long interval = (args.size() > 2) ? parseArgument<long>(args[2], 1) : TIMELINE_DEFAULT_INTERVAL;
+	size_t budget = (args.size() > 3) ? static_cast<size_t>(parseArgument<double>(args[3], DBL_MIN) * 1024 * 1024) : TIMELINE_DEFAULT_BUDGET;
+	int seeks = (args.size() > 4) ? parseArgument<int>(args[4], 1) : TIMELINE_BENCH_SEEKS;
+
+	SimulationData data;
+	std::mt19937 generator(2024);
+	std::uniform_real_distribution<double> duration(0.5, 5.0);
+	std::uniform_real_distribution<double> speed(-0.4, 0.8);
+	for (double time = 0; time < minutes * 60; time += duration(generator)) {
+		data.getSchedule().addBreakpoint(time, speed(generator), speed(generator));
+	}
+	long totalSteps = ScenarioRun::getStepCount(data);
+
+	Vehicle vehicle(DEFAULT_WHEELBASE);
+	vehicle.setTrailSettings(DEFAULT_TRAIL_LEN * 10, 3);
+	Timeline timeline(interval, budget);
+	std::vector<double> referenceX(totalSteps + 1), referenceY(totalSteps + 1), referencePhi(totalSteps + 1);
+
+	auto start = std::chrono::steady_clock::now();
+	timeline.record(0, vehicle, data.getSchedule());
+	referenceX[0] = vehicle.getX();
+	referenceY[0] = vehicle.getY();
+	referencePhi[0] = vehicle.getPhi();
+	for (long step = 0; step < totalSteps; step++) {
+		data.setVehicleSpeed(getStepTime(step), vehicle);
+		vehicle.recalculate(SIMULATION_FIXED_STEP);
+		timeline.record(step + 1, vehicle, data.getSchedule());
+		referenceX[step + 1] = vehicle.getX();
+		referenceY[step + 1] = vehicle.getY();
+		referencePhi[step + 1] = vehicle.getPhi();
+	}
+	double recordSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("Recorded %ld steps (%.0f [s] simulated) in %.3f [s]\n", totalSteps, getStepTime(totalSteps), recordSeconds);
+	printf("Keyframes: %zu | interval %ld steps | %.2f MB of %.2f MB budget\n", timeline.getKeyframeCount(), timeline.getInterval(),
+		timeline.getMemoryUsage() / 1048576.0, budget / 1048576.0);
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	Vehicle scrubbed(DEFAULT_WHEELBASE);
+	long mismatches = 0;
+	auto measure = [&](const char* name, const std::vector<long>& targets) {
+		std::vector<double> times;
+		long maxSteps = 0;
+		for (long target : targets) {
+			auto seekStart = std::chrono::steady_clock::now();
+			long simulated = timeline.seek(target, scrubbed, data);
+			times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - seekStart).count());
+			maxSteps = std::max(maxSteps, simulated);
+			if (simulated < 0 || scrubbed.getX() != referenceX[target] || scrubbed.getY() != referenceY[target] || scrubbed.getPhi() != referencePhi[target])
+				mismatches++;
+		}
+		std::sort(times.begin(), times.end());
+		printf("%-12s %6zu seeks | median %8.1f us | max %8.1f us | at most %ld steps simulated\n", name, targets.size(),
+			times[times.size() / 2], times.back(), maxSteps);
+	};
+
+	std::vector<long> randomTargets(seeks), dragTargets(seeks);
+	std::uniform_int_distribution<long> anyStep(0, totalSteps);
+	for (int i = 0; i < seeks; i++) {
+		randomTargets[i] = anyStep(generator);
+		dragTargets[i] = totalSteps - static_cast<long>(static_cast<double>(totalSteps) * i / seeks);
+	}
+	measure("random", randomTargets);
+	measure("drag back", dragTargets);
+
+	std::cout << "Seeks matching the straight run: " << (mismatches == 0 ? "all" : std::to_string(2 * seeks - mismatches) + " of " + std::to_string(2 * seeks)) << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (mismatches == 0) ? 0 : -1;
+}
+
+// Fleet of the same vehicle model on one geometry policy, trails switched off so the
+// kinematics dominate. Returns the poses reached for the comparison of both policies.
+template <typename Geometry>
+std::vector<double> benchVehicleGeometry(Benchmark& bench, const std::string& name, const Geometry& geometry, long fleetSize) {
+	std::vector<BasicVehicle<Geometry>> fleet;
+	for (long i = 0; i < fleetSize; i++) {
+		fleet.emplace_back(geometry);
+		fleet.back().setTrailSettings(0, INT_MAX);
+		fleet.back().lWheel.setTangencialVel(0.4 + i * 1e-3);
+		fleet.back().rWheel.setTangencialVel(0.5);
+	}
+	long steps = std::max(16L, 262144 / fleetSize);
+
+	bench.run("recalculate(" + name + ")", fleetSize, fleetSize * steps, [&]() {
+		for (long s = 0; s < steps; s++) {
+			for (auto& vehicle : fleet) {
+				vehicle.recalculate(SIMULATION_FIXED_STEP);
+			}
+		}
+		benchmarkSink = fleet.back().getX();
+	});
+	bench.run("setAngularVel(" + name + ")", fleetSize, fleetSize * steps, [&]() {
+		for (long s = 0; s < steps; s++) {
+			for (auto& vehicle : fleet) {
+				vehicle.setAngularVel(s * 1e-4);
+			}
+		}
+		benchmarkSink = fleet.back().rWheel.getAngularVel();
+	});
+
+	std::vector<double> poses;
+	for (auto& vehicle : fleet) {
+		poses.insert(poses.end(), { vehicle.getX(), vehicle.getY(), vehicle.getPhi(), vehicle.getWheelPositions().leftX, vehicle.rWheel.getAngularVel() });
+	}
+	return poses;
+}
+
+// Same default robot as compile time and as run time geometry
+int benchGeometry(const std::vector<std::string>& args) {
+	std::string resultPath = (args.size() > 1) ? args[1] : GEOMETRY_RESULTS_FILE;
+
+	Benchmark bench(MICROBENCH_WARMUP, MICROBENCH_REPETITIONS);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Geometry: wheelbase " << DefaultDimensions::wheelbase << " [m], wheel radius " << DefaultDimensions::wheelRadius << " [m]" << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	bool identical = true;
+	for (long fleetSize : { 1L, 64L, 1024L }) {
+		std::vector<double> fixed = benchVehicleGeometry(bench, "fixed", FixedGeometry<DefaultDimensions>(), fleetSize);
+		std::vector<double> runtime = benchVehicleGeometry(bench, "runtime", RuntimeGeometry(), fleetSize);
+		identical = identical && fixed == runtime;
+	}
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	std::cout << "Fixed and runtime geometry give identical results: " << (identical ? "yes" : "NO") << std::endl;
+	bool written = bench.writeResults(resultPath);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (written && identical) ? 0 : -1;
+}
+
+template <typename Real>
+void benchVehiclePrecision(Benchmark& bench, const std::string& name, long fleetSize) {
+	std::vector<BasicVehicle<RuntimeGeometry, Real>> fleet;
+	for (long i = 0; i < fleetSize; i++) {
+		fleet.emplace_back(RuntimeGeometry());
+		fleet.back().setTrailSettings(0, INT_MAX);
+		fleet.back().lWheel.setTangencialVel(Real(0.4 + i * 1e-3));
+		fleet.back().rWheel.setTangencialVel(Real(0.5));
+	}
+	long steps = std::max(16L, 262144 / fleetSize);
+	bench.run("recalculate(" + name + ")", fleetSize, fleetSize * steps, [&]() {
+		for (long s = 0; s < steps; s++) {
+			for (auto& vehicle : fleet) {
+				vehicle.recalculate(SIMULATION_FIXED_STEP);
+			}
+		}
+		benchmarkSink = static_cast<double>(fleet.back().getX());
+	});
+}
+
+// Drives the same rectangle laps with float, double and long double state. A lap ends
+// where it started, so any offset between the precisions is accumulated rounding error;
+// long double is the reference. Ends with the cost of each precision on fleets.
+int benchPrecision(const std::vector<std::string>& args) {
+	long laps = (args.size() > 1) ? parseArgument<long>(args[1], 1) : PRECISION_DEFAULT_LAPS;
+	double tolerance = (args.size() > 2) ? parseArgument<double>(args[2], DBL_MIN) * 1e-3 : PRECISION_DEFAULT_TOLERANCE;
+
+	SimulationData lap;
+	lap.setRectangleData(1.0);
+	VelocitySchedule& schedule = lap.getSchedule();
+
+	BasicVehicle<RuntimeGeometry, long double> reference{ RuntimeGeometry() };
+	BasicVehicle<RuntimeGeometry, double> doubleVehicle{ RuntimeGeometry() };
+	BasicVehicle<RuntimeGeometry, float> floatVehicle{ RuntimeGeometry() };
+	reference.setTrailSettings(0, INT_MAX);
+	doubleVehicle.setTrailSettings(0, INT_MAX);
+	floatVehicle.setTrailSettings(0, INT_MAX);
+
+	std::filesystem::create_directory("logData");
+	std::ofstream resultFile(PRECISION_RESULTS_FILE, std::ios::out);
+	resultFile << "laps;steps;double position error[m];double heading error[rad];float position error[m];float heading error[rad];\n";
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Rectangle laps of 1 [m], reference in long double, tolerance " << tolerance << " [m]" << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("%10s %14s %16s %16s %16s %16s\n", "laps", "steps", "double pos [m]", "double phi [rad]", "float pos [m]", "float phi [rad]");
+
+	long steps = 0;
+	long floatFailLap = -1;
+	long nextCheckpoint = 1, checkpointBase = 1;
+	auto start = std::chrono::steady_clock::now();
+	for (long completed = 1; completed <= laps; completed++) {
+		for (size_t segment = 0; segment + 1 < schedule.size(); segment++) {
+			double vL = schedule.getLeftSpeed(segment), vR = schedule.getRightSpeed(segment);
+			reference.lWheel.setTangencialVel(vL);
+			reference.rWheel.setTangencialVel(vR);
+			doubleVehicle.lWheel.setTangencialVel(vL);
+			doubleVehicle.rWheel.setTangencialVel(vR);
+			floatVehicle.lWheel.setTangencialVel(static_cast<float>(vL));
+			floatVehicle.rWheel.setTangencialVel(static_cast<float>(vR));
+
+			long segmentSteps = std::lround((schedule.getTime(segment + 1) - schedule.getTime(segment)) * SIMULATION_SECOND_STEP_AMOUNT);
+			for (long s = 0; s < segmentSteps; s++) {
+				reference.recalculate(SIMULATION_FIXED_STEP);
+				doubleVehicle.recalculate(SIMULATION_FIXED_STEP);
+				floatVehicle.recalculate(SIMULATION_FIXED_STEP);
+			}
+			steps += segmentSteps;
+		}
+
+		// Checkpoints at 1, 2, 5, 10, 20, 50 ... laps and after the last one
+		if (completed != nextCheckpoint && completed != laps)
+			continue;
+		double refX = static_cast<double>(reference.getX()), refY = static_cast<double>(reference.getY()), refPhi = static_cast<double>(reference.getPhi());
+		double doubleError = hypot(doubleVehicle.getX() - refX, doubleVehicle.getY() - refY);
+		double doubleHeading = getHeadingError(doubleVehicle.getPhi(), refPhi);
+		double floatError = hypot(floatVehicle.getX() - refX, floatVehicle.getY() - refY);
+		double floatHeading = getHeadingError(floatVehicle.getPhi(), refPhi);
+		printf("%10ld %14ld %16.3e %16.3e %16.3e %16.3e\n", completed, steps, doubleError, doubleHeading, floatError, floatHeading);
+		resultFile << completed << ";" << steps << ";" << doubleError << ";" << doubleHeading << ";" << floatError << ";" << floatHeading << ";\n";
+		if (floatFailLap < 0 && floatError > tolerance)
+			floatFailLap = completed;
+
+		if (completed == nextCheckpoint) {
+			if (nextCheckpoint == checkpointBase)
+				nextCheckpoint = 2 * checkpointBase;
+			else if (nextCheckpoint == 2 * checkpointBase)
+				nextCheckpoint = 5 * checkpointBase;
+			else
+				nextCheckpoint = checkpointBase = 10 * checkpointBase;
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	if (floatFailLap > 0)
+		printf("float exceeds %g [m] by checkpoint of lap %ld\n", tolerance, floatFailLap);
+	else
+		printf("float stays within %g [m] for %ld laps\n", tolerance, laps);
+	printf("Drift analysis: %.1f [s], results written to %s\n", seconds, PRECISION_RESULTS_FILE);
+	printf("State size: float %zu B | double %zu B | long double %zu B per vehicle\n", sizeof(floatVehicle), sizeof(doubleVehicle), sizeof(reference));
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	Benchmark bench(MICROBENCH_WARMUP, MICROBENCH_REPETITIONS);
+	for (long fleetSize : { 1L, 64L, 1024L }) {
+		benchVehiclePrecision<float>(bench, "float", fleetSize);
+		benchVehiclePrecision<double>(bench, "double", fleetSize);
+	}
+	bool written = bench.writeResults(PRECISION_BENCH_FILE);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return written ? 0 : -1;
+}
+
+// Bare pose with both wheels, stepped the way Vehicle did before the shared heading sine and
+// cosine (libm for the heading and again for each wheel) and the way it does now
+struct BenchPose {
+	double x = 0, y = 0, phi = 0;
+	double leftX = 0, leftY = 0, rightX = 0, rightY = 0;
+
+	void stepLibm(const RuntimeGeometry& geometry, double v, double omega, double dt) {
+		double phiEnd = phi + omega * dt;
+		x += v * std::cos(phiEnd) * dt;
+		y += v * std::sin(phiEnd) * dt;
+		phi += omega * dt;
+		getWheelPosition(geometry, x, y, phi, -M_PI / 2, leftX, leftY);
+		getWheelPosition(geometry, x, y, phi, M_PI / 2, rightX, rightY);
+	}
+
+	void stepShared(const RuntimeGeometry& geometry, double v, double omega, double dt) {
+		double sinPhi, cosPhi;
+		phi += omega * dt;
+		getSinCos(phi, sinPhi, cosPhi);
+		x += v * cosPhi * dt;
+		y += v * sinPhi * dt;
+		WheelPositions<double> wheels = computeWheelPositions(geometry, x, y, sinPhi, cosPhi);
+		leftX = wheels.leftX;
+		leftY = wheels.leftY;
+		rightX = wheels.rightX;
+		rightY = wheels.rightY;
+	}
+};
+
+// Largest absolute error of fastSinCos and libm against long double over samples in <-range, range>
+void measureSinCosError(std::mt19937_64& generator, double range, long samples, double& fastError, double& libmError, bool& batchIdentical) {
+	std::uniform_real_distribution<double> argument(-range, range);
+	std::vector<double> angles(samples), sine(samples), cosine(samples);
+	for (double& angle : angles) {
+		angle = argument(generator);
+	}
+	fastSinCosBatch(angles.data(), sine.data(), cosine.data(), angles.size());
+
+	fastError = libmError = 0;
+	for (long i = 0; i < samples; i++) {
+		double s, c;
+		fastSinCos(angles[i], s, c);
+		batchIdentical = batchIdentical && s == sine[i] && c == cosine[i];
+
+		long double exactSine = sinl(angles[i]), exactCosine = cosl(angles[i]);
+		fastError = std::max({ fastError, static_cast<double>(fabsl(s - exactSine)), static_cast<double>(fabsl(c - exactCosine)) });
+		libmError = std::max({ libmError, static_cast<double>(fabsl(std::sin(angles[i]) - exactSine)), static_cast<double>(fabsl(std::cos(angles[i]) - exactCosine)) });
+	}
+}
+
+// Accuracy and cost of the polynomial sine and cosine. The kernel is compared with long double
+// over single turns and the whole reduced range, then rectangle laps are driven with Vehicle
+// (shared heading sine and cosine) and with the former libm step; long double is the reference
+// for the body and the wheel positions.
+int benchSinCos(const std::vector<std::string>& args) {
+	long laps = (args.size() > 1) ? parseArgument<long>(args[1], 1) : SINCOS_DEFAULT_LAPS;
+	long samples = (args.size() > 2) ? parseArgument<long>(args[2], 1) : SINCOS_DEFAULT_SAMPLES;
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Kernel error against long double, " << samples << " samples per range" << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("%-16s %16s %16s\n", "range [rad]", "fastSinCos", "libm");
+	std::mt19937_64 generator(41);
+	bool batchIdentical = true;
+	double worstFastError = 0;
+	for (double range : { M_PI, 1e3, FAST_SINCOS_MAX_ARGUMENT }) {
+		double fastError, libmError;
+		measureSinCosError(generator, range, samples, fastError, libmError, batchIdentical);
+		printf("+-%-14g %16.3e %16.3e\n", range, fastError, libmError);
+		worstFastError = std::max(worstFastError, fastError);
+	}
+	std::cout << "Batch and scalar kernel give identical results: " << (batchIdentical ? "yes" : "NO") << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	SimulationData lap;
+	lap.setRectangleData(1.0);
+	VelocitySchedule& schedule = lap.getSchedule();
+	RuntimeGeometry geometry;
+
+	BasicVehicle<RuntimeGeometry, long double> reference{ RuntimeGeometry() };
+	Vehicle vehicle{ RuntimeGeometry() };
+	BenchPose libmPose;
+	reference.setTrailSettings(0, INT_MAX);
+	vehicle.setTrailSettings(0, INT_MAX);
+
+	std::cout << "Rectangle laps of 1 [m], position error against long double" << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("%10s %14s %16s %16s %16s %16s\n", "laps", "steps", "fast body [m]", "fast wheel [m]", "libm body [m]", "libm wheel [m]");
+
+	long steps = 0;
+	long nextCheckpoint = 1;
+	double maxFastBody = 0, maxFastWheel = 0, maxLibmBody = 0, maxLibmWheel = 0;
+	for (long completed = 1; completed <= laps; completed++) {
+		for (size_t segment = 0; segment + 1 < schedule.size(); segment++) {
+			double vL = schedule.getLeftSpeed(segment), vR = schedule.getRightSpeed(segment);
+			reference.lWheel.setTangencialVel(vL);
+			reference.rWheel.setTangencialVel(vR);
+			vehicle.lWheel.setTangencialVel(vL);
+			vehicle.rWheel.setTangencialVel(vR);
+			double v, omega;
+			getBodyVelocity(geometry, vL, vR, v, omega);
+
+			long segmentSteps = std::lround((schedule.getTime(segment + 1) - schedule.getTime(segment)) * SIMULATION_SECOND_STEP_AMOUNT);
+			for (long s = 0; s < segmentSteps; s++) {
+				reference.recalculate(SIMULATION_FIXED_STEP);
+				vehicle.recalculate(SIMULATION_FIXED_STEP);
+				libmPose.stepLibm(geometry, v, omega, SIMULATION_FIXED_STEP);
+			}
+			steps += segmentSteps;
+
+			// Errors at every segment end, the checkpoints only print them
+			double refX = static_cast<double>(reference.getX()), refY = static_cast<double>(reference.getY());
+			WheelPositions<long double> refWheels = reference.getWheelPositions();
+			WheelPositions<double> wheels = vehicle.getWheelPositions();
+			double refLeftX = static_cast<double>(refWheels.leftX), refLeftY = static_cast<double>(refWheels.leftY);
+			double refRightX = static_cast<double>(refWheels.rightX), refRightY = static_cast<double>(refWheels.rightY);
+			maxFastBody = std::max(maxFastBody, hypot(vehicle.getX() - refX, vehicle.getY() - refY));
+			maxFastWheel = std::max({ maxFastWheel, hypot(wheels.leftX - refLeftX, wheels.leftY - refLeftY),
+				hypot(wheels.rightX - refRightX, wheels.rightY - refRightY) });
+			maxLibmBody = std::max(maxLibmBody, hypot(libmPose.x - refX, libmPose.y - refY));
+			maxLibmWheel = std::max({ maxLibmWheel, hypot(libmPose.leftX - refLeftX, libmPose.leftY - refLeftY),
+				hypot(libmPose.rightX - refRightX, libmPose.rightY - refRightY) });
+		}
+
+		if (completed == nextCheckpoint || completed == laps) {
+			printf("%10ld %14ld %16.3e %16.3e %16.3e %16.3e\n", completed, steps, maxFastBody, maxFastWheel, maxLibmBody, maxLibmWheel);
+			if (completed == nextCheckpoint)
+				nextCheckpoint *= 10;
+		}
+	}
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	// Cost of the kernels and of one pose step with both wheels
+	Benchmark bench(MICROBENCH_WARMUP, MICROBENCH_REPETITIONS);
+	std::vector<double> angles(SINCOS_BATCH), sine(SINCOS_BATCH), cosine(SINCOS_BATCH);
+	for (size_t i = 0; i < angles.size(); i++) {
+		angles[i] = (i * 0.37) - 150.0;
+	}
+	bench.run("std::sin + std::cos", SINCOS_BATCH, SINCOS_BATCH, [&]() {
+		for (size_t i = 0; i < angles.size(); i++) {
+			sine[i] = std::sin(angles[i]);
+			cosine[i] = std::cos(angles[i]);
+		}
+		benchmarkSink = sine.back() + cosine.back();
+	});
+	bench.run("fastSinCos", SINCOS_BATCH, SINCOS_BATCH, [&]() {
+		for (size_t i = 0; i < angles.size(); i++) {
+			fastSinCos(angles[i], sine[i], cosine[i]);
+		}
+		benchmarkSink = sine.back() + cosine.back();
+	});
+	bench.run("fastSinCosBatch", SINCOS_BATCH, SINCOS_BATCH, [&]() {
+		fastSinCosBatch(angles.data(), sine.data(), cosine.data(), angles.size());
+		benchmarkSink = sine.back() + cosine.back();
+	});
+
+	const long stepOperations = 262144;
+	bench.run("pose step (libm)", 1, stepOperations, [&]() {
+		BenchPose pose;
+		for (long i = 0; i < stepOperations; i++) {
+			pose.stepLibm(geometry, 0.5, 0.3, SIMULATION_FIXED_STEP);
+		}
+		benchmarkSink = pose.leftX + pose.rightY;
+	});
+	bench.run("pose step (shared sincos)", 1, stepOperations, [&]() {
+		BenchPose pose;
+		for (long i = 0; i < stepOperations; i++) {
+			pose.stepShared(geometry, 0.5, 0.3, SIMULATION_FIXED_STEP);
+		}
+		benchmarkSink = pose.leftX + pose.rightY;
+	});
+	bench.run("Vehicle::recalculate", 1, stepOperations, [&]() {
+		Vehicle stepped{ RuntimeGeometry() };
+		stepped.setTrailSettings(0, INT_MAX);
+		stepped.lWheel.setTangencialVel(0.35);
+		stepped.rWheel.setTangencialVel(0.65);
+		for (long i = 0; i < stepOperations; i++) {
+			stepped.recalculate(SIMULATION_FIXED_STEP);
+		}
+		benchmarkSink = stepped.getX() + stepped.getY();
+	});
+	std::vector<dd_vehicle_state> states(SINCOS_BATCH);
+	std::vector<dd_wheel_command> commands(SINCOS_BATCH, dd_wheel_command{ 0.35, 0.65 });
+	dd_step_params params{ SIMULATION_FIXED_STEP, DEFAULT_WHEELBASE, DD_INTEGRATION_EULER, 0 };
+	bench.run("dd_step_batch(euler)", SINCOS_BATCH, SINCOS_BATCH * 64, [&]() {
+		dd_init_states(states.data(), states.size());
+		dd_step_batch(states.data(), commands.data(), states.size(), 64, &params);
+		benchmarkSink = states.back().x;
+	});
+	bool written = bench.writeResults(SINCOS_RESULTS_FILE);
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("Kernel error at most %.3e, vehicle over %ld laps: body %.3e [m], wheels %.3e [m] (libm %.3e [m], %.3e [m])\n",
+		worstFastError, laps, maxFastBody, maxFastWheel, maxLibmBody, maxLibmWheel);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (written && batchIdentical) ? 0 : -1;
+}
+
+// One byte per cell, the plain layout the packed occupancy grid is compared with
+struct ByteWorld {
+	std::vector<std::uint8_t> cells;
+	long columns = 0;
+	long rows = 0;
+	double resolution = 1;
+
+	bool collidesCircle(double x, double y, double radius) const {
+		double cx = x / resolution - 0.5, cy = y / resolution - 0.5, r = radius / resolution;
+		long firstRow = std::max(0L, static_cast<long>(std::ceil(cy - r))), lastRow = std::min(rows - 1, static_cast<long>(std::floor(cy + r)));
+		long firstColumn = std::max(0L, static_cast<long>(std::ceil(cx - r))), lastColumn = std::min(columns - 1, static_cast<long>(std::floor(cx + r)));
+		for (long row = firstRow; row <= lastRow; row++) {
+			for (long column = firstColumn; column <= lastColumn; column++) {
+				double dx = column - cx, dy = row - cy;
+				if (dx * dx + dy * dy <= r * r && cells[static_cast<size_t>(row) * columns + column])
+					return true;
+			}
+		}
+		return false;
+	}
+};
+
+// Warehouse of square cells: outer walls, racks 1 [m] deep along x with 2 [m] aisles and
+// a cross aisle every 20 [m], optionally also as a byte grid
+void buildBenchWarehouse(long size, OccupancyGrid& world, ByteWorld* bytes) {
+	world.create(size, size, WORLD_BENCH_RESOLUTION, 0, 0);
+	if (bytes) {
+		bytes->columns = size;
+		bytes->rows = size;
+		bytes->resolution = WORLD_BENCH_RESOLUTION;
+		bytes->cells.assign(static_cast<size_t>(size) * size, 0);
+	}
+
+	auto fill = [&](long firstColumn, long firstRow, long lastColumn, long lastRow) {
+		for (long row = std::max(0L, firstRow); row <= std::min(size - 1, lastRow); row++) {
+			for (long column = std::max(0L, firstColumn); column <= std::min(size - 1, lastColumn); column++) {
+				world.setOccupied(column, row);
+				if (bytes)
+					bytes->cells[static_cast<size_t>(row) * size + column] = 1;
+			}
+		}
+	};
+	fill(0, 0, size - 1, 19);
+	fill(0, size - 20, size - 1, size - 1);
+	fill(0, 0, 19, size - 1);
+	fill(size - 20, 0, size - 1, size - 1);
+	for (long band = 300; band + 100 < size - 300; band += 300) {
+		for (long block = 200; block < size - 200; block += 2000) {
+			fill(block, band, std::min(block + 1799, size - 201), band + 99);
+		}
+	}
+}
+
+// Collision checks of a vehicle sized disc on a warehouse map: uniformly random positions
+// (every query misses the cache on large maps) and vehicles driving along the aisles in
+// 5 [mm] steps, the per step pattern of a simulation. The packed grid is compared with a
+// byte per cell grid, both must give the same answers.
+int benchWorld(const std::vector<std::string>& args) {
+	long largest = (args.size() > 1) ? parseArgument<long>(args[1], 1) : WORLD_BENCH_DEFAULT_CELLS;
+	long queries = (args.size() > 2) ? parseArgument<long>(args[2], 1) : WORLD_BENCH_DEFAULT_QUERIES;
+	double radius = DEFAULT_WHEELBASE / 2;
+
+	Benchmark bench(1, 5);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("Footprint radius %.3f [m], cells of %.3f [m], %ld queries per case\n", radius, WORLD_BENCH_RESOLUTION, queries);
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	bool identical = true;
+	std::vector<std::string> summary;
+	for (long size : { std::min(1000L, largest), largest }) {
+		OccupancyGrid world;
+		ByteWorld bytes;
+		buildBenchWarehouse(size, world, &bytes);
+		double extent = size * WORLD_BENCH_RESOLUTION;
+		printf("Map %ld x %ld cells (%.0f x %.0f [m]): packed %.1f MB, bytes %.1f MB\n", size, size, extent, extent,
+			world.getMemoryBytes() / 1048576.0, bytes.cells.size() / 1048576.0);
+
+		std::mt19937_64 generator(45);
+		std::uniform_real_distribution<double> position(0, extent);
+		std::vector<double> randomX(queries), randomY(queries), pathX(queries), pathY(queries);
+		for (long i = 0; i < queries; i++) {
+			randomX[i] = position(generator);
+			randomY[i] = position(generator);
+		}
+		// Aisle centers between the racks, driven left to right one after another
+		long aisles = std::max(1L, (size - 600) / 300);
+		double x = 0.5, aisle = 0;
+		for (long i = 0; i < queries; i++) {
+			x += SIMULATION_FIXED_STEP;
+			if (x > extent - 0.5) {
+				x = 0.5;
+				aisle = std::fmod(aisle + 1, aisles);
+			}
+			pathX[i] = x;
+			pathY[i] = (200 + aisle * 300 + 50) * WORLD_BENCH_RESOLUTION;
+		}
+
+		for (int pattern = 0; pattern < 2; pattern++) {
+			const std::vector<double>& qx = pattern ? pathX : randomX;
+			const std::vector<double>& qy = pattern ? pathY : randomY;
+			std::string suffix = std::string(pattern ? "path" : "random") + ", " + std::to_string(size);
+			long packedHits = 0, byteHits = 0;
+			for (long i = 0; i < queries; i++) {
+				bool packed = world.collidesCircle(qx[i], qy[i], radius);
+				identical = identical && packed == bytes.collidesCircle(qx[i], qy[i], radius);
+				packedHits += packed;
+			}
+
+			bench.run("collidesCircle(packed, " + suffix + ")", size, queries, [&]() {
+				long hits = 0;
+				for (long i = 0; i < queries; i++) {
+					hits += world.collidesCircle(qx[i], qy[i], radius);
+				}
+				benchmarkSink = hits;
+			});
+			double packedRate = 1e3 / bench.getLastMedian();
+			bench.run("collidesCircle(bytes, " + suffix + ")", size, queries, [&]() {
+				long hits = 0;
+				for (long i = 0; i < queries; i++) {
+					hits += bytes.collidesCircle(qx[i], qy[i], radius);
+				}
+				byteHits = hits;
+				benchmarkSink = hits;
+			});
+			double byteRate = 1e3 / bench.getLastMedian();
+
+			char line[160];
+			snprintf(line, sizeof(line), "%-18s %8.1f Mchecks/s packed | %8.1f Mchecks/s bytes | %5.1f %% colliding",
+				suffix.c_str(), packedRate, byteRate, 100.0 * packedHits / queries);
+			summary.push_back(line);
+		}
+		std::cout << CLI_SIMPLE_SEP << std::endl;
+	}
+
+	for (const std::string& line : summary) {
+		std::cout << line << std::endl;
+	}
+	std::cout << "Packed and byte grid give identical answers: " << (identical ? "yes" : "NO") << std::endl;
+	bool written = bench.writeResults(WORLD_BENCH_FILE);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (written && identical) ? 0 : -1;
+}
+
+// Cell by cell DDA without the block jumps of OccupancyGrid::castRay, the reference
+double castRayFlat(const OccupancyGrid& world, double x, double y, double dirX, double dirY, double maxRange) {
+	double resolution = world.getResolution();
+	double ox = (x - world.getOriginX()) / resolution, oy = (y - world.getOriginY()) / resolution;
+	double maxT = maxRange / resolution;
+	long column = static_cast<long>(std::floor(ox)), row = static_cast<long>(std::floor(oy));
+	long stepX = (dirX > 0) ? 1 : -1, stepY = (dirY > 0) ? 1 : -1;
+	double t = 0;
+	while (t < maxT) {
+		if (column < 0 || row < 0 || column >= world.getColumns() || row >= world.getRows())
+			return maxRange;
+		if (world.isOccupied(column, row))
+			return t * resolution;
+		double tx = (dirX != 0) ? ((column + (stepX > 0)) - ox) / dirX : INFINITY;
+		double ty = (dirY != 0) ? ((row + (stepY > 0)) - oy) / dirY : INFINITY;
+		if (tx < ty) {
+			t = tx;
+			column += stepX;
+		}
+		else {
+			t = ty;
+			row += stepY;
+		}
+	}
+	return maxRange;
+}
+
+// Lidar scans in the warehouse of --bench-world from poses in the aisles: one scan with the
+// block jumps and with the plain cell by cell DDA, then a fleet of vehicles scanned on one
+// and on all workers of the job system. Throughput in rays per second.
+int benchLidar(const std::vector<std::string>& args) {
+	LidarSettings settings;
+	settings.beams = (args.size() > 1) ? parseArgument<long>(args[1], 1) : LIDAR_DEFAULT_BEAMS;
+	long vehicles = (args.size() > 2) ? parseArgument<long>(args[2], 1) : LIDAR_BENCH_DEFAULT_VEHICLES;
+	unsigned int threads = (args.size() > 3) ? parseArgument<unsigned int>(args[3]) : 0;
+	Lidar lidar(settings);
+	long beams = settings.beams;
+
+	OccupancyGrid world;
+	buildBenchWarehouse(LIDAR_BENCH_MAP_CELLS, world, nullptr);
+	double extent = LIDAR_BENCH_MAP_CELLS * WORLD_BENCH_RESOLUTION;
+
+	// Vehicles on the aisle center lines, heading anywhere
+	std::mt19937_64 generator(46);
+	std::uniform_real_distribution<double> along(1, extent - 1), heading(-M_PI, M_PI);
+	std::vector<double> poseX(vehicles), poseY(vehicles), posePhi(vehicles);
+	long aisles = (LIDAR_BENCH_MAP_CELLS - 600) / 300;
+	for (long i = 0; i < vehicles; i++) {
+		poseX[i] = along(generator);
+		poseY[i] = (250 + (i % aisles) * 300) * WORLD_BENCH_RESOLUTION;
+		posePhi[i] = heading(generator);
+	}
+
+	Benchmark bench(1, 11);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("Lidar: %ld beams, range %.1f [m] | map %d x %d cells of %.3f [m] | %ld vehicles\n", beams, settings.maxRange,
+		LIDAR_BENCH_MAP_CELLS, LIDAR_BENCH_MAP_CELLS, WORLD_BENCH_RESOLUTION, vehicles);
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	// Same ranges from both traversals
+	std::vector<float> ranges(vehicles * beams);
+	long mismatches = 0, hits = 0;
+	double maxDifference = 0;
+	for (long i = 0; i < vehicles; i++) {
+		lidar.scan(world, poseX[i], poseY[i], posePhi[i], &ranges[i * beams]);
+		for (long beam = 0; beam < beams; beam++) {
+			double angle = posePhi[i] + lidar.getAngleMin() + beam * lidar.getAngleIncrement();
+			double flat = castRayFlat(world, poseX[i], poseY[i], cos(angle), sin(angle), settings.maxRange);
+			double difference = std::fabs(flat - ranges[i * beams + beam]);
+			maxDifference = std::max(maxDifference, difference);
+			mismatches += difference > 1e-5;
+			hits += ranges[i * beams + beam] < settings.maxRange;
+		}
+	}
+
+	std::vector<double> dirX(vehicles * beams), dirY(vehicles * beams);
+	for (long i = 0; i < vehicles * beams; i++) {
+		double angle = posePhi[i / beams] + lidar.getAngleMin() + (i % beams) * lidar.getAngleIncrement();
+		dirX[i] = cos(angle);
+		dirY[i] = sin(angle);
+	}
+	bench.run("castRayFlat", beams, vehicles * beams, [&]() {
+		double sum = 0;
+		for (long i = 0; i < vehicles * beams; i++) {
+			sum += castRayFlat(world, poseX[i / beams], poseY[i / beams], dirX[i], dirY[i], settings.maxRange);
+		}
+		benchmarkSink = sum;
+	});
+	double flatRate = 1e3 / bench.getLastMedian();
+	bench.run("Lidar::scan", beams, vehicles * beams, [&]() {
+		for (long i = 0; i < vehicles; i++) {
+			lidar.scan(world, poseX[i], poseY[i], posePhi[i], &ranges[i * beams]);
+		}
+		benchmarkSink = ranges.back();
+	});
+	double scanRate = 1e3 / bench.getLastMedian();
+
+	std::vector<std::pair<unsigned int, double>> fleetRates;
+	unsigned int allWorkers = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned int workers : { 1u, allWorkers }) {
+		JobSystem jobs(workers);
+		bench.run("scanFleet(" + std::to_string(workers) + " workers)", beams, vehicles * beams, [&]() {
+			scanFleet(lidar, world, poseX.data(), poseY.data(), posePhi.data(), vehicles, ranges.data(), jobs);
+			benchmarkSink = ranges.back();
+		});
+		fleetRates.push_back({ workers, 1e3 / bench.getLastMedian() });
+		if (workers == allWorkers)
 			break;
+	}
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("%-28s %10.2f Mrays/s\n", "cell by cell DDA", flatRate);
+	printf("%-28s %10.2f Mrays/s\n", "DDA with block jumps", scanRate);
+	for (const auto& rate : fleetRates) {
+		printf("%-28s %10.2f Mrays/s | %.0f scans/s\n", ("fleet, " + std::to_string(rate.first) + " workers").c_str(), rate.second, rate.second * 1e6 / beams);
+	}
+	printf("Beams with a hit: %.1f %% | ranges differing from the plain DDA: %ld (largest %.2e [m])\n", 100.0 * hits / (vehicles * beams), mismatches, maxDifference);
+	bool written = bench.writeResults(LIDAR_BENCH_FILE);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (written && mismatches == 0) ? 0 : -1;
+}
+
+// Fleet of rectangles and curves repeating their schedules with encoder odometry next to
+// each vehicle, every vehicle on its own random stream. Drift of the estimates for ideal
+// encoders (quantization only), noisy encoders and uneven slip, a trace of the first
+// vehicle of every case, and the cost of the odometry on top of the physics step.
+int benchOdometry(const std::vector<std::string>& args) {
+	long vehicles = (args.size() > 1) ? parseArgument<long>(args[1], 1) : ODOMETRY_BENCH_VEHICLES;
+	double seconds = (args.size() > 2) ? parseArgument<double>(args[2], DBL_MIN) : ODOMETRY_BENCH_SECONDS;
+	std::uint64_t seed = (args.size() > 3) ? parseArgument<std::uint64_t>(args[3]) : ODOMETRY_DEFAULT_SEED;
+
+	std::vector<ScenarioSpec> specs = makeManeuverSweep(vehicles);
+	std::vector<SimulationData> schedules(vehicles);
+	for (long i = 0; i < vehicles; i++) {
+		if (!ScenarioRun::buildSchedule(specs[i], schedules[i]))
+			return -1;
+	}
+
+	struct OdometryCase {
+		std::string name;
+		EncoderSettings encoders;
+	};
+	std::vector<OdometryCase> cases(3);
+	cases[0].name = "quantization";
+	cases[1].name = "noise";
+	cases[1].encoders.noise = 0.01;
+	cases[2].name = "slip";
+	cases[2].encoders.noise = 0.01;
+	cases[2].encoders.slipLeft = 0.01;
+	cases[2].encoders.slipRight = 0.02;
+
+	std::filesystem::create_directory("logData");
+	std::ofstream driftFile(ODOMETRY_DRIFT_FILE, std::ios::out);
+	if (!driftFile.is_open()) {
+		std::cout << "Error: Could not open " << ODOMETRY_DRIFT_FILE << std::endl;
+		return -1;
+	}
+	driftFile << "case;t[s];mean position error[m];max position error[m];mean heading error[rad];\n";
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("%ld vehicles, %.0f [s], %ld ticks per revolution, seed %llu\n", vehicles, seconds, static_cast<long>(ENCODER_DEFAULT_TICKS), static_cast<unsigned long long>(seed));
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("%-14s %10s %18s %18s %18s\n", "case", "t [s]", "mean error [m]", "max error [m]", "heading [rad]");
+
+	long totalSteps = std::lround(seconds * SIMULATION_SECOND_STEP_AMOUNT);
+	for (const OdometryCase& odometryCase : cases) {
+		std::vector<Vehicle> fleet;
+		std::vector<Odometry> estimates;
+		for (long i = 0; i < vehicles; i++) {
+			fleet.emplace_back(RuntimeGeometry());
+			fleet.back().setTrailSettings(0, INT_MAX);
+			estimates.emplace_back(fleet.back().getGeometry(), odometryCase.encoders, seed, static_cast<std::uint64_t>(i));
+		}
+		FileHandler trace("odometry_trace_" + odometryCase.name, std::vector<std::string>{ "t[s]", "ticksL", "ticksR",
+			"x[m]", "y[m]", "phi[rad]", "xO[m]", "yO[m]", "phiO[rad]", "position error[m]", "heading error[rad]" });
+
+		double nextReport = 1;
+		for (long step = 1; step <= totalSteps; step++) {
+			double time = getStepTime(step - 1);
+			for (long i = 0; i < vehicles; i++) {
+				schedules[i].setVehicleSpeed(std::fmod(time, schedules[i].getSchedule().getEndTime()), fleet[i]);
+				fleet[i].recalculate(SIMULATION_FIXED_STEP);
+				estimates[i].step(SIMULATION_FIXED_STEP, fleet[i].lWheel.getTangencialVel(), fleet[i].rWheel.getTangencialVel());
+			}
+			const Odometry& first = estimates[0];
+			trace.writeToFile(std::vector<double>{ getStepTime(step), (double)first.getLeftTicks(), (double)first.getRightTicks(),
+				fleet[0].getX(), fleet[0].getY(), fleet[0].getPhi(), first.getX(), first.getY(), first.getPhi(),
+				first.getPositionError(fleet[0].getX(), fleet[0].getY()), first.getHeadingError(fleet[0].getPhi()) });
+
+			if (step % static_cast<long>(SIMULATION_SECOND_STEP_AMOUNT) == 0) {
+				double now = getStepTime(step);
+				double meanError = 0, maxError = 0, meanHeading = 0;
+				for (long i = 0; i < vehicles; i++) {
+					double error = estimates[i].getPositionError(fleet[i].getX(), fleet[i].getY());
+					meanError += error / vehicles;
+					maxError = std::max(maxError, error);
+					meanHeading += std::fabs(estimates[i].getHeadingError(fleet[i].getPhi())) / vehicles;
+				}
+				driftFile << odometryCase.name << ";" << now << ";" << meanError << ";" << maxError << ";" << meanHeading << ";\n";
+				if (now >= nextReport || step == totalSteps) {
+					printf("%-14s %10.0f %18.6f %18.6f %18.6f\n", odometryCase.name.c_str(), now, meanError, maxError, meanHeading);
+					nextReport *= 10;
+				}
+			}
+		}
+		trace.flush();
+	}
+	driftFile.close();
+	std::cout << "Drift written to " << ODOMETRY_DRIFT_FILE << ", first vehicle traces to logData/odometry_trace_<case>.csv" << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	// Per vehicle step of a fleet driving straight, with and without the odometry
+	Benchmark bench(MICROBENCH_WARMUP, MICROBENCH_REPETITIONS);
+	const long steps = 64;
+	std::vector<Vehicle> fleet;
+	std::vector<Odometry> estimates;
+	for (long i = 0; i < vehicles; i++) {
+		fleet.emplace_back(RuntimeGeometry());
+		fleet.back().setTrailSettings(0, INT_MAX);
+		fleet.back().lWheel.setTangencialVel(0.4 + i * 1e-4);
+		fleet.back().rWheel.setTangencialVel(0.5);
+		estimates.emplace_back(fleet.back().getGeometry(), cases[2].encoders, seed, static_cast<std::uint64_t>(i));
+	}
+	bench.run("Vehicle::recalculate", vehicles, vehicles * steps, [&]() {
+		for (long s = 0; s < steps; s++) {
+			for (long i = 0; i < vehicles; i++) {
+				fleet[i].recalculate(SIMULATION_FIXED_STEP);
+			}
+		}
+		benchmarkSink = fleet.back().getX();
+	});
+	double physics = bench.getLastMedian();
+	bench.run("recalculate + Odometry::step", vehicles, vehicles * steps, [&]() {
+		for (long s = 0; s < steps; s++) {
+			for (long i = 0; i < vehicles; i++) {
+				fleet[i].recalculate(SIMULATION_FIXED_STEP);
+				estimates[i].step(SIMULATION_FIXED_STEP, fleet[i].lWheel.getTangencialVel(), fleet[i].rWheel.getTangencialVel());
+			}
+		}
+		benchmarkSink = fleet.back().getX() + estimates.back().getX();
+	});
+	double withOdometry = bench.getLastMedian();
+	for (long i = 0; i < vehicles; i++) {
+		estimates[i] = Odometry(fleet[i].getGeometry(), cases[0].encoders, seed, static_cast<std::uint64_t>(i));
+	}
+	bench.run("recalculate + Odometry::step (no noise)", vehicles, vehicles * steps, [&]() {
+		for (long s = 0; s < steps; s++) {
+			for (long i = 0; i < vehicles; i++) {
+				fleet[i].recalculate(SIMULATION_FIXED_STEP);
+				estimates[i].step(SIMULATION_FIXED_STEP, fleet[i].lWheel.getTangencialVel(), fleet[i].rWheel.getTangencialVel());
+			}
+		}
+		benchmarkSink = fleet.back().getX() + estimates.back().getX();
+	});
+	double quantizationOnly = bench.getLastMedian();
+	bool written = bench.writeResults(ODOMETRY_BENCH_FILE);
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("Odometry per vehicle step: %.1f [ns] with noise and slip, %.1f [ns] quantization only (physics step %.1f [ns])\n",
+		withOdometry - physics, quantizationOnly - physics, physics);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return written ? 0 : -1;
+}
+
+// Fleet of the --bench-odometry slip case with an EKF per vehicle fusing its encoder
+// odometry and range / bearing observations of a landmark grid. Accuracy of the filter
+// against plain dead reckoning, the consistency of its covariance (mean normalized error,
+// 3 for a consistent filter) and the cost of predictions and landmark updates.
+int benchEkf(const std::vector<std::string>& args) {
+	long vehicles = (args.size() > 1) ? parseArgument<long>(args[1], 1) : EKF_BENCH_VEHICLES;
+	double seconds = (args.size() > 2) ? parseArgument<double>(args[2], DBL_MIN) : EKF_BENCH_SECONDS;
+	std::uint64_t seed = (args.size() > 3) ? parseArgument<std::uint64_t>(args[3]) : ODOMETRY_DEFAULT_SEED;
+
+	std::vector<ScenarioSpec> specs = makeManeuverSweep(vehicles);
+	std::vector<SimulationData> schedules(vehicles);
+	for (long i = 0; i < vehicles; i++) {
+		if (!ScenarioRun::buildSchedule(specs[i], schedules[i]))
+			return -1;
+	}
+
+	EncoderSettings encoders;
+	encoders.noise = 0.01;
+	encoders.slipLeft = 0.01;
+	encoders.slipRight = 0.02;
+	LandmarkSensorSettings sensorSettings;
+	LandmarkMap landmarkMap(makeLandmarkGrid(-EKF_LANDMARK_EXTENT, -EKF_LANDMARK_EXTENT, EKF_LANDMARK_EXTENT, EKF_LANDMARK_EXTENT,
+		LANDMARK_DEFAULT_SPACING), sensorSettings.maxRange);
+	const std::vector<Landmark>& landmarks = landmarkMap.getLandmarks();
+	double rangeVariance = sensorSettings.rangeNoise * sensorSettings.rangeNoise;
+	double bearingVariance = sensorSettings.bearingNoise * sensorSettings.bearingNoise;
+
+	std::vector<Vehicle> fleet;
+	std::vector<Odometry> odometry;
+	std::vector<PoseEkf> filters;
+	std::vector<LandmarkSensor> sensors;
+	for (long i = 0; i < vehicles; i++) {
+		fleet.emplace_back(RuntimeGeometry());
+		fleet.back().setTrailSettings(0, INT_MAX);
+		odometry.emplace_back(fleet.back().getGeometry(), encoders, seed, static_cast<std::uint64_t>(i));
+		filters.emplace_back(fleet.back().getWheelbase());
+		sensors.emplace_back(&landmarkMap, sensorSettings, seed, static_cast<std::uint64_t>(vehicles + i));
+	}
+
+	std::filesystem::create_directory("logData");
+	std::ofstream accuracyFile(EKF_ACCURACY_FILE, std::ios::out);
+	if (!accuracyFile.is_open()) {
+		std::cout << "Error: Could not open " << EKF_ACCURACY_FILE << std::endl;
+		return -1;
+	}
+	accuracyFile << "t[s];odometry mean error[m];ekf mean error[m];ekf max error[m];ekf mean heading error[rad];mean normalized error[-];\n";
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("%ld vehicles, %.0f [s], %zu landmarks every %.1f [m] seen up to %.1f [m] at %.0f [Hz], seed %llu\n", vehicles, seconds,
+		landmarks.size(), LANDMARK_DEFAULT_SPACING, sensorSettings.maxRange, sensorSettings.rate, static_cast<unsigned long long>(seed));
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("%10s %18s %18s %18s %18s %12s\n", "t [s]", "odometry [m]", "ekf mean [m]", "ekf max [m]", "heading [rad]", "NEES");
+
+	std::vector<LandmarkObservation> observations;
+	long accepted = 0, rejected = 0;
+	long totalSteps = std::lround(seconds * SIMULATION_SECOND_STEP_AMOUNT);
+	double nextReport = 1;
+	for (long step = 1; step <= totalSteps; step++) {
+		double time = getStepTime(step - 1);
+		for (long i = 0; i < vehicles; i++) {
+			schedules[i].setVehicleSpeed(std::fmod(time, schedules[i].getSchedule().getEndTime()), fleet[i]);
+			fleet[i].recalculate(SIMULATION_FIXED_STEP);
+			odometry[i].step(SIMULATION_FIXED_STEP, fleet[i].lWheel.getTangencialVel(), fleet[i].rWheel.getTangencialVel());
+			filters[i].predict(odometry[i].getLastDistanceLeft(), odometry[i].getLastDistanceRight());
+			if (sensors[i].isObservationDue(getStepTime(step))) {
+				sensors[i].observe(fleet[i].getX(), fleet[i].getY(), fleet[i].getPhi(), nullptr, observations);
+				for (const LandmarkObservation& observation : observations) {
+					const Landmark& landmark = landmarks[observation.landmark];
+					if (filters[i].updateLandmark(observation.range, observation.bearing, landmark.x, landmark.y, rangeVariance, bearingVariance))
+						accepted++;
+					else
+						rejected++;
+				}
+			}
+		}
+
+		if (step % static_cast<long>(SIMULATION_SECOND_STEP_AMOUNT) == 0) {
+			double now = getStepTime(step);
+			double odometryError = 0, meanError = 0, maxError = 0, meanHeading = 0, meanNormalized = 0;
+			for (long i = 0; i < vehicles; i++) {
+				odometryError += odometry[i].getPositionError(fleet[i].getX(), fleet[i].getY()) / vehicles;
+				double error = std::hypot(filters[i].getX() - fleet[i].getX(), filters[i].getY() - fleet[i].getY());
+				meanError += error / vehicles;
+				maxError = std::max(maxError, error);
+				meanHeading += std::fabs(std::remainder(filters[i].getPhi() - fleet[i].getPhi(), 2 * M_PI)) / vehicles;
+				meanNormalized += filters[i].getNormalizedError(fleet[i].getX(), fleet[i].getY(), fleet[i].getPhi()) / vehicles;
+			}
+			accuracyFile << now << ";" << odometryError << ";" << meanError << ";" << maxError << ";" << meanHeading << ";" << meanNormalized << ";\n";
+			if (now >= nextReport || step == totalSteps) {
+				printf("%10.0f %18.6f %18.6f %18.6f %18.6f %12.3f\n", now, odometryError, meanError, maxError, meanHeading, meanNormalized);
+				nextReport *= 10;
+			}
+		}
+	}
+	accuracyFile.close();
+	printf("Landmark updates: %ld accepted, %ld rejected by the gate\n", accepted, rejected);
+	std::cout << "Accuracy written to " << EKF_ACCURACY_FILE << std::endl;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+
+	// Filter operations of the whole fleet, updates with an observation of the landmark
+	// ahead of each estimate so every one passes the gate
+	Benchmark bench(MICROBENCH_WARMUP, MICROBENCH_REPETITIONS);
+	const long steps = 64;
+	bench.run("PoseEkf::predict", vehicles, vehicles * steps, [&]() {
+		for (long s = 0; s < steps; s++) {
+			for (long i = 0; i < vehicles; i++) {
+				filters[i].predict(0.004 + i * 1e-6, 0.005);
+			}
+		}
+		benchmarkSink = filters.back().getX();
+	});
+	double predictTime = bench.getLastMedian();
+	bench.run("PoseEkf::updateLandmark", vehicles, vehicles * steps, [&]() {
+		for (long s = 0; s < steps; s++) {
+			for (long i = 0; i < vehicles; i++) {
+				filters[i].updateLandmark(2.0, 0.1, filters[i].getX() + 2.0 * cos(filters[i].getPhi() + 0.1),
+					filters[i].getY() + 2.0 * sin(filters[i].getPhi() + 0.1), rangeVariance, bearingVariance);
+			}
+		}
+		benchmarkSink = filters.back().getX();
+	});
+	double updateTime = bench.getLastMedian();
+	bench.run("LandmarkSensor::observe", vehicles, vehicles, [&]() {
+		for (long i = 0; i < vehicles; i++) {
+			sensors[i].observe(fleet[i].getX(), fleet[i].getY(), fleet[i].getPhi(), nullptr, observations);
+		}
+		benchmarkSink = static_cast<double>(observations.size());
+	});
+	double observeTime = bench.getLastMedian();
+	bool written = bench.writeResults(EKF_BENCH_FILE);
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("EKF predict %.1f [ns] (%.1f M/s) | landmark update %.1f [ns] (%.1f M/s) | observation of %zu landmarks %.1f [ns]\n",
+		predictTime, 1e3 / predictTime, updateTime, 1e3 / updateTime, landmarks.size(), observeTime);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return written ? 0 : -1;
+}
+
+// Visit counts of many maneuvers from random start poses accumulated into one coverage
+// map. Every job counts into a private tiled map and the maps are summed tile range by tile
+// range at the end; the same runs counted into one dense map with atomic increments show
+// what the private maps save. The merged map is exported for the --coverage window option.
+int benchCoverage(const std::vector<std::string>& args) {
+	long runs = (args.size() > 1) ? parseArgument<long>(args[1], 1) : COVERAGE_BENCH_RUNS;
+	double cellSize = (args.size() > 2) ? parseArgument<double>(args[2], DBL_MIN) : COVERAGE_DEFAULT_RESOLUTION;
+	unsigned int threads = (args.size() > 3) ? parseArgument<unsigned int>(args[3]) : 0;
+	std::string file = (args.size() > 4) ? args[4] : COVERAGE_DEFAULT_FILE;
+	if (runs <= 0) {
+		std::cout << "Error: Coverage needs at least one run" << std::endl;
+		return -1;
+	}
+
+	std::vector<ScenarioSpec> specs = makeManeuverSweep(runs);
+	std::vector<SimulationData> schedules(runs);
+	std::vector<double> startX(runs), startY(runs), startPhi(runs);
+	for (long i = 0; i < runs; i++) {
+		if (!ScenarioRun::buildSchedule(specs[i], schedules[i]))
+			return -1;
+		RandomStream random(COVERAGE_DEFAULT_SEED, static_cast<std::uint64_t>(i));
+		startX[i] = (2 * random.uniform() - 1) * COVERAGE_START_SPREAD;
+		startY[i] = (2 * random.uniform() - 1) * COVERAGE_START_SPREAD;
+		startPhi[i] = (2 * random.uniform() - 1) * M_PI;
+	}
+
+	CoverageMap result;
+	long cells = static_cast<long>(std::ceil(2 * COVERAGE_BENCH_EXTENT / cellSize));
+	if (!result.create(cells, cells, cellSize, -COVERAGE_BENCH_EXTENT, -COVERAGE_BENCH_EXTENT))
+		return -1;
+
+	// Stepped like a scenario run, the trajectory starting at the origin is moved to the
+	// start pose of the run
+	auto drive = [&](long i, auto&& visit) {
+		Vehicle vehicle(DEFAULT_WHEELBASE);
+		vehicle.setTrailSettings(0, INT_MAX);
+		SimulationData data = schedules[i];
+		long steps = ScenarioRun::getStepCount(data);
+		double c = cos(startPhi[i]), s = sin(startPhi[i]);
+		for (long step = 0; step < steps; step++) {
+			data.setVehicleSpeed(getStepTime(step), vehicle);
+			vehicle.recalculate(SIMULATION_FIXED_STEP);
+			visit(startX[i] + c * vehicle.getX() - s * vehicle.getY(), startY[i] + s * vehicle.getX() + c * vehicle.getY());
+		}
+		return steps;
+	};
+
+	JobSystem jobs(threads);
+	long jobCount = std::min(runs, static_cast<long>(jobs.getWorkerCount()));
+	std::vector<CoverageMap> parts(jobCount, result);
+	std::vector<long> jobSteps(jobCount, 0);
+	auto start = std::chrono::steady_clock::now();
+	for (long j = 0; j < jobCount; j++) {
+		jobs.submit([&, j]() {
+			for (long i = j; i < runs; i += jobCount) {
+				long lastCell = -1;
+				jobSteps[j] += drive(i, [&](double x, double y) {
+					parts[j].visit(x, y, lastCell);
+				});
+			}
+		});
+	}
+	jobs.wait();
+	double privateTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	start = std::chrono::steady_clock::now();
+	if (!mergeCoverage(parts, result, jobs))
+		return -1;
+	double mergeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	size_t partBytes = 0;
+	for (const CoverageMap& part : parts) {
+		partBytes += part.getMemoryBytes();
+	}
+	parts.clear();
+
+	// Baseline: every visit an atomic increment of one shared dense map
+	std::vector<std::uint32_t> shared(static_cast<size_t>(cells) * cells, 0);
+	start = std::chrono::steady_clock::now();
+	for (long j = 0; j < jobCount; j++) {
+		jobs.submit([&, j]() {
+			for (long i = j; i < runs; i += jobCount) {
+				long lastCell = -1;
+				drive(i, [&](double x, double y) {
+					double column = std::floor((x + COVERAGE_BENCH_EXTENT) / cellSize);
+					double row = std::floor((y + COVERAGE_BENCH_EXTENT) / cellSize);
+					if (!(column >= 0 && row >= 0 && column < cells && row < cells)) {
+						lastCell = -1;
+						return;
+					}
+					long cell = static_cast<long>(row) * cells + static_cast<long>(column);
+					if (cell != lastCell)
+						std::atomic_ref<std::uint32_t>(shared[cell]).fetch_add(1, std::memory_order_relaxed);
+					lastCell = cell;
+				});
+			}
+		});
+	}
+	jobs.wait();
+	double sharedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	bool identical = true;
+	for (long row = 0; row < cells && identical; row++) {
+		for (long column = 0; column < cells; column++) {
+			if (result.getCount(column, row) != shared[row * cells + column]) {
+				identical = false;
+				break;
+			}
+		}
+	}
+	long steps = 0;
+	for (long count : jobSteps) {
+		steps += count;
+	}
+	std::uint64_t visits = result.getTotal();
+	long usedTiles = 0;
+	for (size_t tile = 0; tile < result.getTileCount(); tile++) {
+		usedTiles += result.isTileAllocated(tile);
+	}
+
+	std::filesystem::create_directory("logData");
+	bool written = result.saveToFile(file);
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("%ld runs from random start poses within %.1f [m], %ld steps | %ld x %ld cells of %.3f [m] | %ld jobs on %u workers\n", runs,
+		COVERAGE_START_SPREAD, steps, cells, cells, cellSize, jobCount, jobs.getWorkerCount());
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("Private tiled maps: %.3f [s] (%.1f M steps/s), merge %.3f [ms], %ld of %zu tiles used, %.2f [MB] in all maps\n", privateTime,
+		steps / privateTime * 1e-6, mergeTime * 1e3, usedTiles, result.getTileCount(), partBytes / 1048576.0);
+	printf("Shared atomic map:  %.3f [s] (%.1f M steps/s), %.2f [MB]\n", sharedTime, steps / sharedTime * 1e-6, shared.size() * sizeof(std::uint32_t) / 1048576.0);
+	printf("Counts identical to the shared map: %s | %llu visits, most visited cell %u\n", identical ? "yes" : "no",
+		static_cast<unsigned long long>(visits), result.getMaxCount());
+	if (written)
+		std::cout << "Coverage map written to " << file << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (identical && written) ? 0 : -1;
+}
+
+int sweepCoordinator(const std::vector<std::string>& args) {
+	if (args.size() < 2) {
+		std::cout << "Usage: " << args[0] << " <port> [runs] [batch size] [batch timeout s]" << std::endl;
+		return -1;
+	}
+	unsigned short port = parseArgument<unsigned short>(args[1], 1);
+	long runs = (args.size() > 2) ? parseArgument<long>(args[2], 1) : SWEEP_DEFAULT_RUNS;
+	size_t batchSize = (args.size() > 3) ? parseArgument<size_t>(args[3], 1) : SWEEP_BATCH_SIZE;
+
+	SweepCoordinator coordinator;
+	if (args.size() > 4)
+		coordinator.setBatchTimeout(parseArgument<double>(args[4], DBL_MIN));
+	if (!coordinator.listen(port))
+		return -1;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Coordinator listening on port " << coordinator.getPort() << ", " << runs << " scenarios" << std::endl;
+
+	std::vector<ScenarioResult> results;
+	auto start = std::chrono::high_resolution_clock::now();
+	if (!coordinator.run(makeManeuverSweep(runs), batchSize, results))
+		return -1;
+	double seconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() * TIME_uS;
+
+	std::cout << "Sweep finished in " << seconds << " [s], reassigned batches: " << coordinator.getReassignedBatches() << ", dropped workers: " << coordinator.getDroppedWorkers() << std::endl;
+	writeSweepResults(results);
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return 0;
+}
+
+int sweepWorker(const std::vector<std::string>& args) {
+	if (args.size() < 3) {
+		std::cout << "Usage: " << args[0] << " <host> <port> [threads] [fail after batches] [stall after batches]" << std::endl;
+		return -1;
+	}
+	unsigned int threads = (args.size() > 3) ? parseArgument<unsigned int>(args[3]) : 0;
+	int failAfter = (args.size() > 4) ? parseArgument<int>(args[4], 0) : 0;
+	int stallAfter = (args.size() > 5) ? parseArgument<int>(args[5], 0) : 0;
+
+	SweepWorker worker;
+	return worker.run(args[1], parseArgument<unsigned short>(args[2], 1), threads, failAfter, stallAfter);
+}
+
+// Coordinator in this process and several single threaded worker processes on 127.0.0.1,
+// the first worker fails after its first batch and the second one stalls after it, so
+// both reassignment paths run every time. Results must match a local run exactly.
+int sweepLocalTest(const std::vector<std::string>& args) {
+	int workerCount = (args.size() > 1) ? parseArgument<int>(args[1], 1) : 3;
+	long runs = (args.size() > 2) ? parseArgument<long>(args[2], 1) : SWEEP_DEFAULT_RUNS;
+	std::vector<ScenarioSpec> specs = makeManeuverSweep(runs);
+
+	SweepCoordinator coordinator;
+	coordinator.setBatchTimeout(SWEEP_LOCAL_BATCH_TIMEOUT);
+	if (!coordinator.listen(sf::Socket::AnyPort))
+		return -1;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Spawning " << workerCount << " workers for port " << coordinator.getPort() << std::endl;
+
+	std::string executable = "\"" + AppConfig::getInstance().getExecutablePath() + "\"";
+	for (int i = 0; i < workerCount; i++) {
+		std::string failAfter = (i == 0 && workerCount > 1) ? " 1" : " 0";
+		std::string stallAfter = (i == 1 && workerCount > 2) ? " 1" : " 0";
+		spawnProcess(executable + " --sweep-worker 127.0.0.1 " + std::to_string(coordinator.getPort()) + " 1" + failAfter + stallAfter);
+	}
+
+	std::vector<ScenarioResult> results;
+	if (!coordinator.run(specs, SWEEP_BATCH_SIZE / 4, results))
+		return -1;
+
+	JobSystem jobs(0);
+	std::vector<ScenarioResult> reference = runScenarios(specs, jobs);
+	long mismatches = 0;
+	for (size_t i = 0; i < specs.size(); i++) {
+		if (!results[i].valid || results[i].steps != reference[i].steps || results[i].x != reference[i].x || results[i].y != reference[i].y || results[i].phi != reference[i].phi) {
+			mismatches++;
+		}
+	}
+
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	std::cout << "Scenarios: " << specs.size() << " | mismatches: " << mismatches << " | reassigned batches: " << coordinator.getReassignedBatches()
+		<< " | dropped workers: " << coordinator.getDroppedWorkers() << std::endl;
+	bool passed = (mismatches == 0) && (workerCount < 2 || coordinator.getReassignedBatches() > 0) && (workerCount < 3 || coordinator.getDroppedWorkers() > 0);
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return passed ? 0 : -1;
+}
+
+// Publishes rectangle runs paced to real time, counterpart of --telemetry-receiver
+int telemetryPublish(const std::vector<std::string>& args) {
+	if (args.size() < 3) {
+		std::cout << "Usage: " << args[0] << " <host> <port> [rate Hz] [samples per datagram] [seconds]" << std::endl;
+		return -1;
+	}
+	double rate = (args.size() > 3) ? parseArgument<double>(args[3], 0) : TELEMETRY_DEFAULT_RATE;
+	int batch = (args.size() > 4) ? parseArgument<int>(args[4], 1) : TELEMETRY_DEFAULT_BATCH;
+	double seconds = (args.size() > 5) ? parseArgument<double>(args[5], DBL_MIN) : 10;
+
+	TelemetryPublisher publisher;
+	if (!publisher.open(args[1], parseArgument<unsigned short>(args[2], 1), rate, batch))
+		return -1;
+
+	ScenarioSpec spec;
+	spec.name = "telemetry";
+	spec.parameters[0] = 1;
+
+	auto start = std::chrono::steady_clock::now();
+	double elapsed = 0;
+	while (elapsed < seconds) {
+		ScenarioRun run(spec);
+		run.setSampleListener([&](const VehicleSample& sample) {
+			publisher.publish(sample, run.getVehicle().getStatistics());
+		});
+		publisher.resetSampleTime();
+		if (!run.prepare())
+			return -1;
+		while (run.getStep() < run.getTotalSteps() && elapsed < seconds) {
+			run.step();
+			elapsed += SIMULATION_FIXED_STEP;
+			std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<long long>(elapsed * 1e6)));
 		}
+	}
+	publisher.flush();
+	return 0;
+}
 
-		double prevTime = 0;
-		double time;
+int telemetryReceiver(const std::vector<std::string>& args) {
+	unsigned short port = (args.size() > 1) ? parseArgument<unsigned short>(args[1], 1) : TELEMETRY_DEFAULT_PORT;
+	double seconds = (args.size() > 2) ? parseArgument<double>(args[2], DBL_MIN) : 10;
 
-		for (int i = 0; i < n; i++) {
-			while (true) {
-				std::cout << i + 1 << ". Time [s]: ";
-				std::cin >> time;
-				if (std::cin.fail()) {
-					std::cin.clear();
-					std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-					std::cout << "Invalid input. Please enter a number.\n";
+	sf::UdpSocket socket;
+	if (socket.bind(port) != sf::Socket::Done) {
+		std::cout << "Error: Could not bind UDP port " << port << std::endl;
+		return -1;
+	}
+	sf::SocketSelector selector;
+	selector.add(socket);
+
+	std::vector<char> datagram(sf::UdpSocket::MaxDatagramSize);
+	std::vector<double> latencies;
+	long received = 0, samples = 0, lost = 0, late = 0, duplicates = 0, invalid = 0, scans = 0;
+	double lastScanHits = 0;
+	bool streamStarted = false;
+	std::uint32_t expectedSequence = 0;
+	std::vector<bool> missing(TELEMETRY_SEQUENCE_WINDOW, false);	// sequences counted as lost, by sequence % window
+	VehicleSample lastSample = VehicleSample();
+	StatisticsSample lastStatistics = StatisticsSample();
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Receiving telemetry on port " << port << " for " << seconds << " [s]" << std::endl;
+	sf::Clock timer;
+	sf::Clock reportTimer;
+	while (timer.getElapsedTime().asSeconds() < seconds) {
+		if (selector.wait(sf::milliseconds(100))) {
+			std::size_t size = 0;
+			sf::IpAddress sender;
+			unsigned short senderPort;
+			if (socket.receive(datagram.data(), datagram.size(), size, sender, senderPort) != sf::Socket::Done)
+				continue;
+			std::int64_t now = getSteadyTimeNs();
+
+			TelemetryHeader header;
+			if (size < sizeof(TelemetryHeader)) {
+				invalid++;
+				continue;
+			}
+			memcpy(&header, datagram.data(), sizeof(TelemetryHeader));
+			if (header.magic == LIDAR_SCAN_MAGIC) {
+				LidarScanHeader scan;
+				if (size < sizeof(LidarScanHeader)) {
+					invalid++;
 					continue;
 				}
-				if (time < prevTime) {
-					std::cout << "Next time must be higher than previous one.\n";
+				memcpy(&scan, datagram.data(), sizeof(LidarScanHeader));
+				if (scan.version != LIDAR_SCAN_VERSION || size != sizeof(LidarScanHeader) + scan.beamCount * sizeof(float)) {
+					invalid++;
 					continue;
 				}
-				break;
+				long hits = 0;
+				for (std::uint32_t beam = 0; beam < scan.beamCount; beam++) {
+					float range;
+					memcpy(&range, datagram.data() + sizeof(LidarScanHeader) + beam * sizeof(float), sizeof(float));
+					hits += range < scan.maxRange;
+				}
+				lastScanHits = scan.beamCount > 0 ? 100.0 * hits / scan.beamCount : 0;
+				scans++;
+				continue;
+			}
+			if (header.magic != TELEMETRY_MAGIC || header.version != TELEMETRY_VERSION || size != sizeof(TelemetryHeader) + header.sampleCount * sizeof(VehicleSample) + sizeof(StatisticsSample)) {
+				invalid++;
+				continue;
 			}
-			prevTime = time;
 
-			while (true) {
-				std::cout << i + 1 << ". Tangencial speed vT of Left wheel [m/s]: ";
-				std::cin >> vT_L[time];
-				if (std::cin.fail()) {
-					std::cin.clear();
-					std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-					std::cout << "Invalid input. Please enter a number.\n";
-					continue;
-				}
-				break;
+			if (!streamStarted) {
+				streamStarted = true;
+				expectedSequence = header.sequence;
 			}
-			while (true) {
-				std::cout << i + 1 << ". Tangencial speed vT of Right wheel [m/s]: ";
-				std::cin >> vT_R[time];
-				if (std::cin.fail()) {
-					std::cin.clear();
-					std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-					std::cout << "Invalid input. Please enter a number.\n";
-					continue;
+			// Signed difference, the sequence wraps around
+			std::int32_t ahead = static_cast<std::int32_t>(header.sequence - expectedSequence);
+			if (ahead >= 0) {
+				lost += ahead;
+				for (std::int32_t i = std::max(0, ahead - TELEMETRY_SEQUENCE_WINDOW + 1); i <= ahead; i++) {
+					missing[(expectedSequence + i) % TELEMETRY_SEQUENCE_WINDOW] = i < ahead;
 				}
-				break;
+				expectedSequence = header.sequence + 1;
 			}
-			std::cout << CLI_SIMPLE_SEP << std::endl;
-		}
-		std::cout << CLI_COMPLEX_SEP << std::endl;
-	}
-
-	void getRectangleData() {
-		rectangleSide = 0;
-		std::cout << CLI_COMPLEX_SEP << std::endl;
-		while (true) {
-			std::cout << "Enter size of rectangle side to draw [m]: ";
-			std::cin >> rectangleSide;
-			if (std::cin.fail()) {
-				std::cin.clear();
-				std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-				std::cout << "Invalid input. Please enter a number.\n";
-				continue;
+			else if (ahead >= -TELEMETRY_SEQUENCE_WINDOW && missing[header.sequence % TELEMETRY_SEQUENCE_WINDOW]) {
+				// Counted as lost when the gap was seen
+				missing[header.sequence % TELEMETRY_SEQUENCE_WINDOW] = false;
+				late++;
+				lost--;
 			}
-			std::cout << CLI_SIMPLE_SEP << std::endl;
-			break;
-		}
-		std::cout << CLI_COMPLEX_SEP << std::endl;
-	}
-	void calculateRectangleData() {
-		vT_L.clear();
-		vT_R.clear();
-
-		double calcTime = 1; // [s]
-		double omegaT = degToRad(-90) / (calcTime);
-		double time = 0;
-
-		for (int i = 0; i < 4; i++) {
-			vT_L[time] = this->rectangleSide / (calcTime);
-			vT_R[time] = this->rectangleSide / (calcTime);
-			time += calcTime;
-
-			vT_L[time] = +(DEFAULT_WHEELBASE * omegaT) / 2;
-			vT_R[time] = -(DEFAULT_WHEELBASE * omegaT) / 2;
-			time += calcTime;
-		}
-		vT_L[time] = 0;
-		vT_R[time] = 0;
-	}
-
-	void getCurveData() {
-		r1 = 0; l = 0; r2 = 0;
-		std::cout << CLI_COMPLEX_SEP << std::endl;
-		while (true) {
-			std::cout << "Enter radius of the 1. curve  - R1 [m]: ";
-			std::cin >> r1;
-			if (std::cin.fail()) {
-				std::cin.clear();
-				std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-				std::cout << "Invalid input. Please enter a number.\n";
+			else {
+				// Duplicate, or too old to tell
+				duplicates++;
 				continue;
 			}
-			std::cout << CLI_SIMPLE_SEP << std::endl;
-			break;
-		}
 
-		while (true) {
-			std::cout << "Enter distance betwewn curves - L1 [m]: ";
-			std::cin >> l;
-			if (std::cin.fail()) {
-				std::cin.clear();
-				std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-				std::cout << "Invalid input. Please enter a number.\n";
-				continue;
+			received++;
+			samples += header.sampleCount;
+			latencies.push_back((now - header.sendTime) * 1e-3);
+			if (header.sampleCount > 0) {
+				memcpy(&lastSample, datagram.data() + sizeof(TelemetryHeader) + (header.sampleCount - 1) * sizeof(VehicleSample), sizeof(VehicleSample));
+				memcpy(&lastStatistics, datagram.data() + sizeof(TelemetryHeader) + header.sampleCount * sizeof(VehicleSample), sizeof(StatisticsSample));
 			}
-			std::cout << CLI_SIMPLE_SEP << std::endl;
-			break;
 		}
 
-		while (true) {
-			std::cout << "Enter radius of the 2. curve  - R2 [m]: ";
-			std::cin >> r2;
-			if (std::cin.fail()) {
-				std::cin.clear();
-				std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-				std::cout << "Invalid input. Please enter a number.\n";
-				continue;
-			}
-			std::cout << CLI_SIMPLE_SEP << std::endl;
-			break;
+		if (reportTimer.getElapsedTime().asSeconds() >= 1) {
+			printf("datagrams = %ld | samples = %ld | lost = %ld | t = %.3f [s] | x = %f | y = %f | phi = %f | path = %.3f [m]\n", received, samples, lost, lastSample.time, lastSample.x, lastSample.y, lastSample.phi, lastStatistics.pathLength);
+			if (scans > 0)
+				printf("lidar scans = %ld | beams with a hit = %.1f %%\n", scans, lastScanHits);
+			reportTimer.restart();
 		}
-		std::cout << CLI_COMPLEX_SEP << std::endl;
 	}
-	void calculateCurvaData() {
-		vT_L.clear();
-		vT_R.clear();
 
-		double calcTime = 1; // [s]
-		double omegaT, vT;
-		double time = 0;
-
-		omegaT = degToRad(90) / (calcTime);
-		vT = (degToRad(90) * r1) / (calcTime);
-		vT_L[time] = ((2 * vT) + (DEFAULT_WHEELBASE * omegaT)) / 2;
-		vT_R[time] = ((2 * vT) - (DEFAULT_WHEELBASE * omegaT)) / 2;
-		time += calcTime;
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	long expected = received + lost;
+	printf("Datagrams: %ld received, %ld lost (%.3f %%), %ld out of order, %ld duplicate, %ld invalid\n", received, lost, expected > 0 ? 100.0 * lost / expected : 0.0,
+		late, duplicates, invalid);
+	if (scans > 0)
+		printf("Lidar scans: %ld\n", scans);
+	if (!latencies.empty()) {
+		std::sort(latencies.begin(), latencies.end());
+		// Nearest rank, below a hundred samples p99 is the maximum
+		size_t p99 = static_cast<size_t>(std::ceil(latencies.size() * 0.99)) - 1;
+		printf("Latency [us]: min = %.1f | median = %.1f | p99 = %.1f | max = %.1f\n", latencies.front(), latencies[latencies.size() / 2], latencies[p99], latencies.back());
+	}
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return 0;
+}
 
-		vT_L[time] = this->l / (calcTime);
-		vT_R[time] = this->l / (calcTime);
-		time += calcTime;
+// Drives --remote-control of the window application with a slalom, then goes silent
+// so the watchdog has to stop the vehicle
+int remoteCommandSender(const std::vector<std::string>& args) {
+	if (args.size() < 3) {
+		std::cout << "Usage: " << args[0] << " <host> <port> [rate Hz] [seconds] [wheels 0/1]" << std::endl;
+		return -1;
+	}
+	sf::IpAddress address(args[1]);
+	unsigned short port = parseArgument<unsigned short>(args[2], 1);
+	double rate = (args.size() > 3) ? parseArgument<double>(args[3], DBL_MIN) : REMOTE_COMMAND_DEFAULT_RATE;
+	double seconds = (args.size() > 4) ? parseArgument<double>(args[4], DBL_MIN) : 10;
+	bool wheels = (args.size() > 5) && parseArgument<int>(args[5], 0, 1) != 0;
+	if (address == sf::IpAddress::None || rate <= 0) {
+		std::cout << "Error: Invalid host or rate" << std::endl;
+		return -1;
+	}
 
-		omegaT = degToRad(-90) / (calcTime);
-		vT = (degToRad(90) * r2) / (calcTime);
-		vT_L[time] = ((2 * vT) + (DEFAULT_WHEELBASE * omegaT)) / 2;
-		vT_R[time] = ((2 * vT) - (DEFAULT_WHEELBASE * omegaT)) / 2;
-		time += calcTime;
+	sf::UdpSocket socket;
+	RemoteCommand command;
+	command.magic = REMOTE_COMMAND_MAGIC;
+	command.version = REMOTE_COMMAND_VERSION;
+	command.mode = static_cast<std::uint16_t>(wheels ? RemoteCommandMode::WHEEL_VELOCITY : RemoteCommandMode::BODY_VELOCITY);
+	command.reserved = 0;
+
+	std::cout << "Sending " << rate << " [Hz] commands to " << args[1] << ":" << port << " for " << seconds << " [s]" << std::endl;
+	auto start = std::chrono::steady_clock::now();
+	long count = static_cast<long>(seconds * rate);
+	for (long i = 0; i < count; i++) {
+		double t = i / rate;
+		double v = 0.5;
+		double omega = 1.5 * sin(t * 2);
+		command.sequence = static_cast<std::uint32_t>(i);
+		command.a = wheels ? v - (DEFAULT_WHEELBASE * omega) / 2 : v;
+		command.b = wheels ? v + (DEFAULT_WHEELBASE * omega) / 2 : omega;
+		command.sendTime = getSteadyTimeNs();
+		socket.send(&command, sizeof(RemoteCommand), address, port);
+		std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<long long>((i + 1) / rate * 1e6)));
+	}
+	std::cout << "Sent " << count << " commands" << std::endl;
+	return 0;
+}
 
-		vT_L[time] = 0;
-		vT_R[time] = 0;
+// One writer thread and several readers mapping the ring by name; every record carries
+// its index in x and y, so a reader can tell a torn or misplaced record from a good one
+int benchTelemetryRing(const std::vector<std::string>& args) {
+	int readerCount = (args.size() > 1) ? parseArgument<int>(args[1], 1) : 2;
+	long records = (args.size() > 2) ? parseArgument<long>(args[2], 1) : RING_BENCH_RECORDS;
+	std::string name = std::string(RING_DEFAULT_NAME) + "Bench";
+
+	TelemetryRing ring;
+	if (!ring.create(name, RING_DEFAULT_CAPACITY))
+		return -1;
+	std::vector<std::unique_ptr<TelemetryRingReader>> readers;
+	for (int i = 0; i < readerCount; i++) {
+		readers.push_back(std::make_unique<TelemetryRingReader>());
+		if (!readers.back()->open(name))
+			return -1;
 	}
 
-	void setVehicleSpeed(double time, Vehicle& vehicle) {
-		std::map<double, double>::iterator it = vT_L.lower_bound(time); // iterator to the first element with key >= key
-		if (it != vT_L.begin()) {
-			--it;
-			vehicle.lWheel.setTangencialVel(it->second);
-		}
-		
-		it = vT_R.lower_bound(time); // iterator to the first element with key >= key
-		if (it != vT_R.begin()) {
-			--it;
-			vehicle.rWheel.setTangencialVel(it->second);
-		}
+	std::atomic<bool> writerDone = false;
+	std::vector<long> received(readerCount, 0), corrupted(readerCount, 0);
+	std::vector<double> readerSeconds(readerCount, 0);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < readerCount; i++) {
+		threads.emplace_back([&, i]() {
+			TelemetryRingReader& reader = *readers[i];
+			VehicleSample sample;
+			auto start = std::chrono::steady_clock::now();
+			while (true) {
+				bool done = writerDone.load(std::memory_order_acquire);
+				if (!reader.read(sample)) {
+					if (done)
+						break;
+					std::this_thread::yield();
+					continue;
+				}
+				received[i]++;
+				if (sample.x != static_cast<double>(sample.step) || sample.y != -static_cast<double>(sample.step))
+					corrupted[i]++;
+			}
+			readerSeconds[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		});
 	}
 
-private:
-	AppConfig& config = AppConfig::getInstance();
-	std::map<double, double> vT_L;
-	std::map<double, double> vT_R;
-	double rectangleSide;
-	double r1;
-	double l;
-	double r2;
-};
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	std::cout << "Writing " << records << " records for " << readerCount << " readers" << std::endl;
+	VehicleSample sample = VehicleSample();
+	auto start = std::chrono::steady_clock::now();
+	for (long i = 0; i < records; i++) {
+		sample.time = i * SIMULATION_FIXED_STEP;
+		sample.step = i;
+		sample.x = static_cast<double>(i);
+		sample.y = -static_cast<double>(i);
+		ring.write(sample);
+	}
+	double writerSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	writerDone.store(true, std::memory_order_release);
+	for (auto& thread : threads) {
+		thread.join();
+	}
 
-class FileHandler {
-public:
-	FileHandler() {
-		std::filesystem::create_directory("logData");
-		createNewFile();
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("Writer: %.1f Mrecords/s | %.1f ns/record\n", records / writerSeconds * 1e-6, writerSeconds / records * 1e9);
+	bool passed = true;
+	for (int i = 0; i < readerCount; i++) {
+		std::uint64_t lost = readers[i]->getLostRecords();
+		printf("Reader %d: %ld read | %llu lost | %llu torn | %ld corrupted | %.1f Mrecords/s\n", i, received[i],
+			static_cast<unsigned long long>(lost), static_cast<unsigned long long>(readers[i]->getTornReads()), corrupted[i], received[i] / readerSeconds[i] * 1e-6);
+		passed = passed && corrupted[i] == 0 && received[i] + static_cast<long>(lost) == records;
 	}
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return passed ? 0 : -1;
+}
 
-	void writeToFile(std::vector<double> data) {
-		if (currentFileStream.is_open()) {
-			for (int i = 0; i < data.size(); i++) {
-				currentFileStream << data[i] << ";";
-			}
-			currentFileStream <<std::endl;
+// Follows the ring of a running window application (--shm-ring) or scenario
+int telemetryRingReader(const std::vector<std::string>& args) {
+	std::string name = (args.size() > 1) ? args[1] : RING_DEFAULT_NAME;
+	double seconds = (args.size() > 2) ? parseArgument<double>(args[2], DBL_MIN) : 10;
+
+	TelemetryRingReader reader;
+	if (!reader.open(name))
+		return -1;
+
+	long received = 0;
+	VehicleSample sample = VehicleSample();
+	auto start = std::chrono::steady_clock::now();
+	auto report = start;
+	while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+		if (!reader.read(sample)) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
 		}
 		else {
-			std::cout << "Error: File not open for writing" << std::endl;
+			received++;
 		}
-	}
 
-	void writeToFile(std::vector<std::string> data) {
-		if (currentFileStream.is_open()) {
-			for (int i = 0; i < data.size(); i++) {
-				currentFileStream << data[i] << ";";
-			}
-			currentFileStream << std::endl;
-		}
-		else {
-			std::cout << "Error: File not open for writing" << std::endl;
+		if (std::chrono::steady_clock::now() - report >= std::chrono::seconds(1)) {
+			printf("records = %ld | lost = %llu | t = %.3f [s] | x = %f | y = %f | phi = %f\n", received,
+				static_cast<unsigned long long>(reader.getLostRecords()), sample.time, sample.x, sample.y, sample.phi);
+			report = std::chrono::steady_clock::now();
 		}
 	}
+	printf("Records: %ld read, %llu lost, %llu torn\n", received, static_cast<unsigned long long>(reader.getLostRecords()), static_cast<unsigned long long>(reader.getTornReads()));
+	return 0;
+}
 
-	void createNewFile() {
-		currentFileStream.close();
-
-		auto now = std::chrono::system_clock::now(); // Get the current time
-		auto now_c = std::chrono::system_clock::to_time_t(now); // Convert to time_t
-		std::stringstream filename_ss;
-		std::tm timeinfo;
-		localtime_s(&timeinfo, &now_c); // Convert time_t to tm structure
-		filename_ss << std::put_time(&timeinfo, "%Y_%m_%d__%H_%M_%S"); // Format the time
-		std::string filename = "logData/" + filename_ss.str(); // Append file extension
+// Re-executes a session recorded with --record as fast as possible and checks the poses
+int replayJournal(const std::vector<std::string>& args) {
+	if (args.size() < 2) {
+		std::cout << "Usage: " << args[0] << " <journal file> [trace 0/1]" << std::endl;
+		return -1;
+	}
+	bool writeTrace = (args.size() > 2) && parseArgument<int>(args[2], 0, 1) != 0;
+
+	std::unique_ptr<FileHandler> trace;
+	if (writeTrace)
+		trace = std::make_unique<FileHandler>("replay");
+
+	ReplayResult result;
+	auto start = std::chrono::steady_clock::now();
+	if (!replaySessionJournal(args[1], result, trace.get()))
+		return -1;
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("Replayed %lld steps, %.3f [s] of session in %.3f [s] (%.1f Msteps/s)\n", static_cast<long long>(result.steps),
+		result.simulatedTime, seconds, result.steps / seconds * 1e-6);
+	printf("Recorded poses: %lld checked, %lld mismatched\n", static_cast<long long>(result.checks), static_cast<long long>(result.mismatches));
+	if (result.mismatches > 0) {
+		printf("First mismatch at step %lld, largest position error %e [m]\n", static_cast<long long>(result.firstMismatchStep), result.maxPositionError);
+	}
+	if (!result.complete) {
+		std::cout << "Journal has no end record, the session did not close normally" << std::endl;
+	}
+	printStatistics(result.statistics);
+	if (writeTrace) {
+		std::cout << "Trace written to logData/replay.csv" << std::endl;
+	}
+	std::cout << ((result.mismatches == 0) ? "IDENTICAL" : "DIVERGED") << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (result.mismatches == 0) ? 0 : -1;
+}
 
-		if (config.getAppMode() == ApplicationMode::GAME_MODE) {
-			filename += "-VAR_DELTA-GAME_MODE";
+// One scenario until its stop conditions end it, with summary and optional log
+// rectangle[:side], curve[:R1:L1:R2] or the path of a scenario file
+bool parseScenarioArgument(const std::string& argument, ScenarioSpec& spec) {
+	if (argument.empty()) {
+		std::cout << "Error: No scenario given" << std::endl;
+		return false;
+	}
+	std::string kind = argument.substr(0, argument.find(':'));
+	if (kind == "rectangle" || kind == "curve") {
+		spec.name = kind;
+		spec.mode = (kind == "rectangle") ? SimulationMode::RECTANGLE : SimulationMode::CURVE;
+		if (spec.mode == SimulationMode::CURVE) {
+			spec.parameters[0] = 1;
+			spec.parameters[1] = 1;
+			spec.parameters[2] = 1;
 		}
-		else {
-			filename += "-FIX_DELTA-SIMULATION";
+		std::stringstream values(argument.substr(kind.size()));
+		std::string value;
+		std::getline(values, value, ':');
+		for (int i = 0; i < 3 && std::getline(values, value, ':'); i++) {
+			spec.parameters[i] = parseArgument<double>(value);
 		}
+	}
+	else {
+		spec.name = "scenario";
+		spec.mode = SimulationMode::VECTOR;
+		spec.scenarioFile = argument;
+	}
+	return true;
+}
 
-		switch (config.getSimMode()) {
-		case SimulationMode::VECTOR:
-			filename += "-VECTOR.csv";
-			break;
-		case SimulationMode::RECTANGLE:
-			filename += "-RECTANGLE.csv";
-			break;
-		case SimulationMode::CURVE:
-			filename += "-CURVE.csv";
-			break;
-		case SimulationMode::GAME:
-			filename += "-GAME.csv";
-			break;
-		default:
-			filename += ".csv";
-			break;
-		}
+int runScenario(const std::vector<std::string>& args) {
+	if (args.size() < 2) {
+		std::cout << "Usage: " << args[0] << " <rectangle[:side]|curve[:R1:L1:R2]|scenario file> [stop conditions] [log 0/1] [world image] [meters per pixel] [origin x] [origin y]" << std::endl;
+		return -1;
+	}
+	ScenarioSpec spec;
+	if (!parseScenarioArgument(args[1], spec))
+		return -1;
+	if (args.size() > 2 && !parseStopConditions(args[2], spec.stop))
+		return -1;
+	spec.logEnabled = (args.size() > 3) && parseArgument<int>(args[3], 0, 1) != 0;
+
+	OccupancyGrid world;
+	if (args.size() > 4 && !loadWorldOption(std::vector<std::string>(args.begin() + 4, args.end()), world))
+		return -1;
+
+	ScenarioRun run(spec);
+	if (!run.prepare())
+		return -1;
+	if (!world.empty())
+		run.setWorld(&world);
+	ScenarioResult result = run.run();
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("Stopped by %s after %ld steps, %.3f [s] (%.3f [s] wall)\n", getStopReasonName(result.stopReason), result.steps, result.time, result.wallTime);
+	printf("Pose: x = %f [m] | y = %f [m] | phi = %f [rad]\n", result.x, result.y, result.phi);
+	printStatistics(result.statistics);
+	if (spec.logEnabled)
+		std::cout << "Log written to logData/" << spec.name << ".csv" << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return 0;
+}
 
-		// Open the file for writing
-		currentFileStream.open(filename, std::ios::out);
-		if (!currentFileStream.is_open()) {
-			std::cout << "Error: Could not open file for writing" << std::endl;
-		}
+// Stop conditions that already hold at the start: a return to start target on a rectangle
+// must end the run when the vehicle comes back, and a standstill condition must wait for a
+// vehicle that idles before its first breakpoint to move and stop again
+int checkStopConditions(const std::vector<std::string>&) {
+	ScenarioSpec closure;
+	closure.name = "closure";
+	closure.parameters[0] = 1;
+	if (!parseStopConditions("schedule=0,time=60,pose=0:0:0.01", closure.stop))
+		return -1;
+	ScenarioRun closureRun(closure);
+	if (!closureRun.prepare())
+		return -1;
+	long closureSteps = closureRun.getTotalSteps();
+	ScenarioResult closed = closureRun.run();
+	bool closurePassed = closed.stopReason == StopReason::POSE_REACHED && closed.steps > closureSteps / 2;
+
+	ScenarioSpec idle;
+	idle.name = "idle_start";
+	idle.mode = SimulationMode::VECTOR;
+	if (!parseStopConditions("schedule=0,time=60,still=0.001:0.5", idle.stop))
+		return -1;
+	SimulationData idleData;
+	idleData.getSchedule().addBreakpoint(0, 0, 0);
+	idleData.getSchedule().addBreakpoint(1, 0.5, 0.5);
+	idleData.getSchedule().addBreakpoint(3, 0, 0);
+	ScenarioRun idleRun(idle, std::move(idleData));
+	if (!idleRun.prepare())
+		return -1;
+	ScenarioResult stopped = idleRun.run();
+	bool idlePassed = stopped.stopReason == StopReason::STANDSTILL && stopped.time > 3.4 && stopped.time < 3.6;
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("Return to start: %s after %ld of %ld steps, closure %.3e [m] | %s\n", getStopReasonName(closed.stopReason), closed.steps, closureSteps,
+		closed.statistics.closureError, closurePassed ? "ok" : "WRONG");
+	printf("Idle start, moving 1..3 [s]: %s at %.3f [s] | %s\n", getStopReasonName(stopped.stopReason), stopped.time, idlePassed ? "ok" : "WRONG");
+	std::cout << ((closurePassed && idlePassed) ? "PASSED" : "FAILED") << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return (closurePassed && idlePassed) ? 0 : -1;
+}
 
-		this->writeToFile(std::vector<std::string>{ "t[s]", "step","vT[m/s]","omegaT[rad/s]","xT[m]", "yT[m]", "phiT[rad]",
-													"vL[m/s]", "omegaL[rad/s]", "xL[m]", "yL[m]",
-													"vR[m/s]", "omegaR[rad/s]", "xR[m]", "yR[m]" });
+// End pose distribution of a maneuver under wheel speed noise and slip, samples run in
+// parallel with one random stream each. Checks the noise free run against the stepped
+// simulation (exact arc integration) and a prefix of the samples against one worker.
+int runMonteCarloCommand(const std::vector<std::string>& args) {
+	if (args.size() < 2) {
+		std::cout << "Usage: " << args[0] << " <rectangle[:side]|curve[:R1:L1:R2]|scenario file> [samples] [speed noise m/s] [slip] [correlation s] [seed] [threads]" << std::endl;
+		return -1;
+	}
+	ScenarioSpec spec;
+	if (!parseScenarioArgument(args[1], spec))
+		return -1;
+	long samples = (args.size() > 2) ? parseArgument<long>(args[2], 1) : MONTE_CARLO_DEFAULT_SAMPLES;
+	PerturbationSettings settings;
+	if (args.size() > 3)
+		settings.speedNoise = parseArgument<double>(args[3], 0);
+	if (args.size() > 4)
+		settings.slip = parseArgument<double>(args[4], 0);
+	if (args.size() > 5)
+		settings.correlationTime = parseArgument<double>(args[5], 0);
+	std::uint64_t seed = (args.size() > 6) ? parseArgument<std::uint64_t>(args[6]) : MONTE_CARLO_DEFAULT_SEED;
+	unsigned int threads = (args.size() > 7) ? parseArgument<unsigned int>(args[7]) : 0;
+	if (samples <= 0) {
+		std::cout << "Error: Monte Carlo needs at least one sample" << std::endl;
+		return -1;
 	}
 
-private:
-	AppConfig& config = AppConfig::getInstance();
-	std::string filename;
-	std::ofstream currentFileStream;
-};
+	ScenarioRun nominal(spec);
+	if (!nominal.prepare())
+		return -1;
+	double duration;
+	std::vector<SpeedSegment> segments = getAppliedSegments(nominal.getData().getSchedule(), nominal.getTotalSteps(), duration);
+	double wheelbase = nominal.getVehicle().getWheelbase();
+	nominal.getVehicle().setIntegrationMethod(IntegrationMethod::EXACT_ARC);
+	ScenarioResult stepped = nominal.run();
+	RandomStream unused;
+	double arcX = 0, arcY = 0, arcPhi = 0;
+	runPerturbed(segments, duration, wheelbase, PerturbationSettings{ 0, 0, 0 }, unused, arcX, arcY, arcPhi);
+
+	JobSystem jobs(threads);
+	std::vector<double> endX(samples), endY(samples), endPhi(samples);
+	auto start = std::chrono::steady_clock::now();
+	runMonteCarlo(segments, duration, wheelbase, settings, 0, 0, 0, samples, seed, endX.data(), endY.data(), endPhi.data(), jobs);
+	double runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	start = std::chrono::steady_clock::now();
+	PoseDistribution distribution = summarizePoses(endX, endY, endPhi);
+	double summaryTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	long checked = std::min(samples, static_cast<long>(MONTE_CARLO_CHECK_SAMPLES));
+	std::vector<double> checkX(checked), checkY(checked), checkPhi(checked);
+	{
+		JobSystem single(1);
+		runMonteCarlo(segments, duration, wheelbase, settings, 0, 0, 0, checked, seed, checkX.data(), checkY.data(), checkPhi.data(), single);
+	}
+	bool identical = std::equal(checkX.begin(), checkX.end(), endX.begin()) && std::equal(checkY.begin(), checkY.end(), endY.begin())
+		&& std::equal(checkPhi.begin(), checkPhi.end(), endPhi.begin());
+
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	printf("%s: %zu speed segments over %.3f [s] | speed noise %.4f [m/s] held %.3f [s] | slip %.4f | seed %llu\n", spec.name.c_str(),
+		segments.size(), duration, settings.speedNoise, settings.correlationTime, settings.slip, static_cast<unsigned long long>(seed));
+	printf("Noise free end pose: x = %.9f | y = %.9f | phi = %.9f (stepped exact arc differs by %.2e [m])\n", arcX, arcY, arcPhi,
+		std::hypot(arcX - stepped.x, arcY - stepped.y));
+	printf("Stepped run of %ld steps: %.1f [us]\n", stepped.steps, stepped.wallTime * 1e6);
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("%ld samples on %u workers in %.3f [s] (%.0f samples/s, %.0f [ns] per sample), summary %.3f [s]\n", samples, jobs.getWorkerCount(),
+		runTime, samples / runTime, runTime * 1e9 / samples * jobs.getWorkerCount(), summaryTime);
+	printf("First %ld samples identical with one worker: %s\n", checked, identical ? "yes" : "no");
+	std::cout << CLI_SIMPLE_SEP << std::endl;
+	printf("Mean: x = %.6f [m] | y = %.6f [m] | phi = %.6f [rad]\n", distribution.mean(0, 0), distribution.mean(1, 0), distribution.mean(2, 0));
+	printf("Covariance:\n");
+	for (int r = 0; r < 3; r++) {
+		printf("  %14.6e %14.6e %14.6e\n", distribution.covariance(r, 0), distribution.covariance(r, 1), distribution.covariance(r, 2));
+	}
+	printf("%-12s %14s %14s %14s %14s\n", "percentile", "x [m]", "y [m]", "phi [rad]", "radius [m]");
+	for (int p = 0; p < 3; p++) {
+		printf("%-12.0f %14.6f %14.6f %14.6f %14.6f\n", distribution.percentiles[p] * 100, distribution.x[p], distribution.y[p], distribution.phi[p], distribution.radius[p]);
+	}
+	printf("95 %% confidence ellipse: %.6f x %.6f [m], major axis at %.4f [rad]\n", distribution.ellipseMajor, distribution.ellipseMinor, distribution.ellipseAngle);
 
-void b_one() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setVectorSimulation();
-	config.setPositionResetStatus(true);
-	config.setTimerResetStatus(true);
-	config.setDataStatus(true);
-}
-void b_second() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setRectangleSimulation();
-	config.setPositionResetStatus(true);
-	config.setTimerResetStatus(true);
-	config.setDataStatus(true);
-}
-void b_third() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setCurveSimulation();
-	config.setPositionResetStatus(true);
-	config.setTimerResetStatus(true);
-	config.setDataStatus(true);
-}
-void b_fourth() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setGameSimulation();
-	config.setPositionResetStatus(true);
-	config.setTimerResetStatus(true);
+	FileHandler poses("monte_carlo_" + spec.name, std::vector<std::string>{ "x[m]", "y[m]", "phi[rad]" });
+	for (long i = 0; i < std::min(samples, static_cast<long>(MONTE_CARLO_EXPORT_SAMPLES)); i++) {
+		poses.writeToFile(std::vector<double>{ endX[i], endY[i], endPhi[i] });
+	}
+	poses.flush();
+	FileHandler ellipse("monte_carlo_" + spec.name + "_ellipse", std::vector<std::string>{ "x[m]", "y[m]" });
+	for (int i = 0; i <= MONTE_CARLO_ELLIPSE_POINTS; i++) {
+		double x, y;
+		getEllipsePoint(distribution.mean(0, 0), distribution.mean(1, 0), distribution.ellipseMajor, distribution.ellipseMinor, distribution.ellipseAngle,
+			2 * M_PI * i / MONTE_CARLO_ELLIPSE_POINTS, x, y);
+		ellipse.writeToFile(std::vector<double>{ x, y });
+	}
+	ellipse.flush();
+	std::cout << "First " << std::min(samples, static_cast<long>(MONTE_CARLO_EXPORT_SAMPLES)) << " end poses written to logData/monte_carlo_" << spec.name
+		<< ".csv, ellipse to logData/monte_carlo_" << spec.name << "_ellipse.csv" << std::endl;
+	std::cout << CLI_COMPLEX_SEP << std::endl;
+	return identical ? 0 : -1;
 }
 
-void b_sim() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setSimulationMode();
-	config.setPositionResetStatus(true);
-	config.setTimerResetStatus(true);
-}
-void b_game() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setGameMode();
-	config.setPositionResetStatus(true);
-	config.setTimerResetStatus(true);
+int runHeadlessCommand(const std::vector<std::string>& args) {
+	// Command and the usage of its arguments
+	const std::map<std::string, std::pair<std::function<int(const std::vector<std::string>&)>, std::string>> commands = {
+		{ "--bench-scenario", { &benchScenarioLoader, "[size MB]" } },
+		{ "--bench-jobs", { &benchJobSystem, "[max threads] [profile hours]" } },
+		{ "--bench-micro", { &benchMicro, "[filter|all] [result file]" } },
+		{ "--bench-integrators", { &benchIntegrators, "[tolerance m] [random schedules]" } },
+		{ "--bench-capi", { &benchCApi, "[max batch]" } },
+		{ "--bench-snapshot", { &benchSnapshot, "[variants] [fork time s]" } },
+		{ "--bench-timeline", { &benchTimeline, "[minutes] [keyframe interval] [budget MB] [seeks]" } },
+		{ "--bench-geometry", { &benchGeometry, "[result file]" } },
+		{ "--bench-precision", { &benchPrecision, "[laps] [tolerance mm]" } },
+		{ "--bench-sincos", { &benchSinCos, "[laps] [samples]" } },
+		{ "--bench-world", { &benchWorld, "[cells per side] [queries]" } },
+		{ "--bench-lidar", { &benchLidar, "[beams] [vehicles] [threads]" } },
+		{ "--bench-odometry", { &benchOdometry, "[vehicles] [seconds] [seed]" } },
+		{ "--bench-ekf", { &benchEkf, "[vehicles] [seconds] [seed]" } },
+		{ "--bench-coverage", { &benchCoverage, "[runs] [cell m] [threads] [output file]" } },
+		{ "--sweep-coordinator", { &sweepCoordinator, "<port> [runs] [batch size] [batch timeout s]" } },
+		{ "--sweep-worker", { &sweepWorker, "<host> <port> [threads] [fail after batches] [stall after batches]" } },
+		{ "--sweep-local", { &sweepLocalTest, "[workers] [runs]" } },
+		{ "--telemetry-publish", { &telemetryPublish, "<host> <port> [rate Hz] [samples per datagram] [seconds]" } },
+		{ "--telemetry-receiver", { &telemetryReceiver, "[port] [seconds]" } },
+		{ "--remote-command", { &remoteCommandSender, "<host> <port> [rate Hz] [seconds] [wheels 0/1]" } },
+		{ "--bench-ring", { &benchTelemetryRing, "[readers] [records]" } },
+		{ "--ring-reader", { &telemetryRingReader, "[name] [seconds]" } },
+		{ "--replay", { &replayJournal, "<journal file> [trace 0/1]" } },
+		{ "--run-scenario", { &runScenario, "<rectangle[:side]|curve[:R1:L1:R2]|file> [stop conditions] [log 0/1] [world image] [m/px] [origin x] [origin y]" } },
+		{ "--check-stop", { &checkStopConditions, "" } },
+		{ "--run-monte-carlo", { &runMonteCarloCommand, "<rectangle[:side]|curve[:R1:L1:R2]|file> [samples] [speed noise] [slip] [correlation s] [seed] [threads]" } },
+	};
+
+	auto command = commands.find(args[0]);
+	if (command == commands.end()) {
+		std::cout << "Unknown command " << args[0] << ". Available commands:" << std::endl;
+		for (const auto& entry : commands) {
+			std::cout << "  " << entry.first << " " << entry.second.second << std::endl;
+		}
+		return -1;
+	}
+	try {
+		return command->second.first(args);
+	}
+	catch (const ArgumentError& error) {
+		std::cout << "Error: " << error.what() << std::endl;
+		std::cout << "Usage: " << args[0] << " " << command->second.second << std::endl;
+		return -1;
+	}
 }
 
-void b_lMode() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setLightMode();
-	config.setChangeStatus(true);
-}
-void b_dMode() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setDarkMode();
-	config.setChangeStatus(true);
+// Values following a window application option, up to the next option
+std::vector<std::string> getOptionValues(const std::vector<std::string>& args, const std::string& option) {
+	std::vector<std::string> values;
+	auto it = std::find(args.begin(), args.end(), option);
+	if (it == args.end())
+		return values;
+	for (it++; it != args.end() && it->rfind("--", 0) != 0; it++) {
+		values.push_back(*it);
+	}
+	return values;
 }
 
-void b_posReset() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setPositionResetStatus(true);
-}
-void b_timeReset() {
-	AppConfig& config = AppConfig::getInstance();
-	config.setTimerResetStatus(true);
+// Window application options
+const char* const WINDOW_OPTION_USAGE[] = {
+	"--telemetry <host> <port> [rate Hz] [samples per datagram]",
+	"--remote-control [port] [watchdog ms]",
+	"--shm-ring [name] [capacity]",
+	"--record [journal file]",
+	"--world <image> [meters per pixel] [origin x] [origin y]",
+	"--lidar [beams] [range m] [rate Hz], needs --world",
+	"--odometry [ticks per revolution] [slip left] [slip right] [noise rad/sqrt(s)] [seed]",
+	"--ekf [landmark spacing m] [range m] [range noise m] [bearing noise rad] [rate Hz], needs --odometry",
+	"--monte-carlo [samples] [speed noise m/s] [slip] [correlation s] [seed]",
+	"--coverage [coverage file], without a file the vehicle's visits are counted"
+};
+
+int runWindowApplication(const std::vector<std::string>& args);
+
+int main(int argc, char* argv[]) {
+	AppConfig::getInstance().setExecutablePath(argv[0]);
+	std::vector<std::string> args(argv + 1, argv + argc);
+	try {
+		return runWindowApplication(args);
+	}
+	catch (const ArgumentError& error) {
+		std::cout << "Error: " << error.what() << std::endl;
+		std::cout << "Usage:" << std::endl;
+		for (const char* usage : WINDOW_OPTION_USAGE) {
+			std::cout << "  " << usage << std::endl;
+		}
+		return -1;
+	}
 }
 
-int main() {
+int runWindowApplication(const std::vector<std::string>& args) {
+	const std::vector<std::string> windowOptions = { "--telemetry", "--remote-control", "--shm-ring", "--record", "--world", "--lidar", "--odometry", "--ekf",
+		"--monte-carlo", "--coverage" };
+	if (!args.empty() && std::find(windowOptions.begin(), windowOptions.end(), args[0]) == windowOptions.end()) {
+		return runHeadlessCommand(args);
+	}
+
+	TelemetryPublisher telemetry;
+	std::vector<std::string> telemetryOptions = getOptionValues(args, "--telemetry");
+	if (telemetryOptions.size() >= 2) {
+		telemetry.open(telemetryOptions[0], parseArgument<unsigned short>(telemetryOptions[1], 1),
+			(telemetryOptions.size() > 2) ? parseArgument<double>(telemetryOptions[2], 0) : TELEMETRY_DEFAULT_RATE,
+			(telemetryOptions.size() > 3) ? parseArgument<int>(telemetryOptions[3], 1) : TELEMETRY_DEFAULT_BATCH);
+	}
+
+	RemoteCommandReceiver remoteControl;
+	if (std::find(args.begin(), args.end(), "--remote-control") != args.end()) {
+		std::vector<std::string> remoteOptions = getOptionValues(args, "--remote-control");
+		remoteControl.open((remoteOptions.size() > 0) ? parseArgument<unsigned short>(remoteOptions[0], 1) : REMOTE_COMMAND_DEFAULT_PORT,
+			(remoteOptions.size() > 1) ? parseArgument<double>(remoteOptions[1], 0) : REMOTE_COMMAND_WATCHDOG);
+	}
+
+	TelemetryRing telemetryRing;
+	if (std::find(args.begin(), args.end(), "--shm-ring") != args.end()) {
+		std::vector<std::string> ringOptions = getOptionValues(args, "--shm-ring");
+		telemetryRing.create((ringOptions.size() > 0) ? ringOptions[0] : RING_DEFAULT_NAME,
+			(ringOptions.size() > 1) ? parseArgument<std::uint32_t>(ringOptions[1], 1) : RING_DEFAULT_CAPACITY);
+	}
+
+	OccupancyGrid world;
+	if (std::find(args.begin(), args.end(), "--world") != args.end() && !loadWorldOption(getOptionValues(args, "--world"), world)) {
+		return -1;
+	}
+
+	std::unique_ptr<Lidar> lidar;
+	if (std::find(args.begin(), args.end(), "--lidar") != args.end()) {
+		if (world.empty()) {
+			std::cout << "Error: --lidar needs a world map (--world)" << std::endl;
+			return -1;
+		}
+		std::vector<std::string> lidarOptions = getOptionValues(args, "--lidar");
+		LidarSettings settings;
+		if (lidarOptions.size() > 0)
+			settings.beams = parseArgument<long>(lidarOptions[0], 1);
+		if (lidarOptions.size() > 1)
+			settings.maxRange = parseArgument<double>(lidarOptions[1], DBL_MIN);
+		if (lidarOptions.size() > 2)
+			settings.rate = parseArgument<double>(lidarOptions[2], 0);
+		lidar = std::make_unique<Lidar>(settings);
+	}
+	std::vector<float> scanRanges(lidar ? lidar->getSettings().beams : 0);
+	double scanX = 0, scanY = 0, scanPhi = 0;
+	bool scanValid = false;
+
 	AppConfig& config = AppConfig::getInstance();
 
 	sf::RenderWindow window(resolutionPicker(), "Diferential drive simulation", sf::Style::Close);
@@ -1468,29 +4915,159 @@ int main() {
 	panel.addIndicator(sf::Vector2f((window.getSize().x - (oneCol * 2.f)), botRow), oneSize, "S", font, sf::Keyboard::Key::S);
 	panel.addIndicator(sf::Vector2f((window.getSize().x - (oneCol * 1.f)), botRow), oneSize, "D", font, sf::Keyboard::Key::D);
 
-	panel.addLabel(sf::Vector2f(oneCol * 5.f, topRow), sf::Vector2f(oneCol * 3.f, oneRow * 0.5f), "Vehicle - v [m/s]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 5.f, topRow), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "Vehicle - v [m/s]: ", font);
 	std::u32string utf32_string = U"Vehicle - \u03c9 [rad/s]:";
-	panel.addLabel(sf::Vector2f(oneCol * 5.f, botRow * 0.5f), sf::Vector2f(oneCol * 3.f, oneRow * 0.5f), sf::String::fromUtf32(utf32_string.begin(), utf32_string.end()), font);
-	panel.addLabel(sf::Vector2f(oneCol * 5.f, botRow), sf::Vector2f(oneCol * 3.f, oneRow * 0.5f), "R Wheel - v [m/s]: ", font);
-	panel.addLabel(sf::Vector2f(oneCol * 5.f, botRow + botRow * 0.5f), sf::Vector2f(oneCol * 3.f, oneRow * 0.5f), "L Wheel - v [m/s]: ", font);
-	panel.addLabel(sf::Vector2f(oneCol * 8.f, topRow), sf::Vector2f(oneCol * 3.f, oneRow * 0.5f), "Vehicle - x [m]: ", font);
-	panel.addLabel(sf::Vector2f(oneCol * 8.f, botRow * 0.5f), sf::Vector2f(oneCol * 3.f, oneRow * 0.5f), "Vehicle - y [m]: ", font);
-	panel.addLabel(sf::Vector2f(oneCol * 8.f, botRow), sf::Vector2f(oneCol * 3.f, oneRow * 0.5f), "Sim.Time [s]: ", font);
-	panel.addLabel(sf::Vector2f(oneCol * 8.f, botRow + botRow * 0.5f), sf::Vector2f(oneCol * 3.f, oneRow * 0.49f), "Sim.Step [-]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 5.f, botRow * 0.5f), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), sf::String::fromUtf32(utf32_string.begin(), utf32_string.end()), font);
+	panel.addLabel(sf::Vector2f(oneCol * 5.f, botRow), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "R Wheel - v [m/s]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 5.f, botRow + botRow * 0.5f), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "L Wheel - v [m/s]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 7.f, topRow), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "Vehicle - x [m]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 7.f, botRow * 0.5f), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "Vehicle - y [m]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 7.f, botRow), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "Sim.Time [s]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 7.f, botRow + botRow * 0.5f), sf::Vector2f(oneCol * 2.f, oneRow * 0.49f), "Sim.Step [-]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 9.f, topRow), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "Path [m]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 9.f, botRow * 0.5f), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "Rotation [rad]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 9.f, botRow), sf::Vector2f(oneCol * 2.f, oneRow * 0.5f), "Max v [m/s]: ", font);
+	panel.addLabel(sf::Vector2f(oneCol * 9.f, botRow + botRow * 0.5f), sf::Vector2f(oneCol * 2.f, oneRow * 0.49f), "Closure [m]: ", font);
+
+	// Timeline above the panel, all the way right follows the running simulation
+	double timelinePosition = 1;
+	panel.addSlider(sf::Vector2f(0.f, -SLIDER_HEIGHT), sf::Vector2f(window.getSize().x, SLIDER_HEIGHT), ApplicationMode::SIMULATION_MODE, [&](double value) {
+		timelinePosition = value;
+	});
 
 	// Model logic
 	Vehicle vehicle = Vehicle(DEFAULT_WHEELBASE);
 	simulationView.setCenter(vehicle.getX(), -vehicle.getY());
 	SimulationData data = SimulationData();
+	data.setWheelbase(vehicle.getWheelbase());
+
+	// Encoder dead reckoning next to the true vehicle, its estimate is drawn as a trail
+	std::unique_ptr<Odometry> odometry;
+	if (std::find(args.begin(), args.end(), "--odometry") != args.end()) {
+		std::vector<std::string> odometryOptions = getOptionValues(args, "--odometry");
+		EncoderSettings encoders;
+		if (odometryOptions.size() > 0)
+			encoders.ticksPerRevolution = parseArgument<long>(odometryOptions[0], 1);
+		if (odometryOptions.size() > 1)
+			encoders.slipLeft = parseArgument<double>(odometryOptions[1]);
+		if (odometryOptions.size() > 2)
+			encoders.slipRight = parseArgument<double>(odometryOptions[2]);
+		if (odometryOptions.size() > 3)
+			encoders.noise = parseArgument<double>(odometryOptions[3], 0);
+		odometry = std::make_unique<Odometry>(vehicle.getGeometry(), encoders,
+			(odometryOptions.size() > 4) ? parseArgument<std::uint64_t>(odometryOptions[4]) : ODOMETRY_DEFAULT_SEED);
+	}
+
+	// Filter fusing the odometry with landmark observations, landmarks cover the world map
+	// or the area around the origin
+	std::unique_ptr<PoseEkf> ekf;
+	std::unique_ptr<LandmarkSensor> landmarkSensor;
+	LandmarkMap landmarks;
+	std::vector<LandmarkObservation> observations;
+	double observedX = 0, observedY = 0;
+	if (std::find(args.begin(), args.end(), "--ekf") != args.end()) {
+		if (!odometry) {
+			std::cout << "Error: --ekf needs encoder odometry (--odometry)" << std::endl;
+			return -1;
+		}
+		std::vector<std::string> ekfOptions = getOptionValues(args, "--ekf");
+		double spacing = (ekfOptions.size() > 0) ? parseArgument<double>(ekfOptions[0], DBL_MIN) : LANDMARK_DEFAULT_SPACING;
+		LandmarkSensorSettings settings;
+		if (ekfOptions.size() > 1)
+			settings.maxRange = parseArgument<double>(ekfOptions[1], DBL_MIN);
+		if (ekfOptions.size() > 2)
+			settings.rangeNoise = parseArgument<double>(ekfOptions[2], DBL_MIN);
+		if (ekfOptions.size() > 3)
+			settings.bearingNoise = parseArgument<double>(ekfOptions[3], DBL_MIN);
+		if (ekfOptions.size() > 4)
+			settings.rate = parseArgument<double>(ekfOptions[4], DBL_MIN);
+		if (world.empty()) {
+			landmarks = LandmarkMap(makeLandmarkGrid(-EKF_LANDMARK_EXTENT, -EKF_LANDMARK_EXTENT, EKF_LANDMARK_EXTENT, EKF_LANDMARK_EXTENT, spacing), settings.maxRange);
+		}
+		else {
+			landmarks = LandmarkMap(makeLandmarkGrid(world.getOriginX() + spacing / 2, world.getOriginY() + spacing / 2,
+				world.getOriginX() + world.getColumns() * world.getResolution(), world.getOriginY() + world.getRows() * world.getResolution(), spacing, &world),
+				settings.maxRange);
+		}
+		ekf = std::make_unique<PoseEkf>(vehicle.getWheelbase());
+		ekf->reset(vehicle.getX(), vehicle.getY(), vehicle.getPhi());
+		landmarkSensor = std::make_unique<LandmarkSensor>(&landmarks, settings, ODOMETRY_DEFAULT_SEED, 1);
+		printf("EKF with %zu landmarks every %.2f [m]\n", landmarks.size(), spacing);
+	}
+
+	// End pose spread of the selected maneuver under wheel speed noise, computed when a
+	// schedule driven run starts and drawn until the next reset
+	std::unique_ptr<JobSystem> monteCarloJobs;
+	PerturbationSettings perturbation;
+	long monteCarloSamples = MONTE_CARLO_GUI_SAMPLES;
+	std::uint64_t monteCarloSeed = MONTE_CARLO_DEFAULT_SEED;
+	PoseDistribution monteCarloResult;
+	std::vector<double> monteCarloX, monteCarloY, monteCarloPhi;
+	bool monteCarloDone = false;
+	if (std::find(args.begin(), args.end(), "--monte-carlo") != args.end()) {
+		std::vector<std::string> monteCarloOptions = getOptionValues(args, "--monte-carlo");
+		if (monteCarloOptions.size() > 0)
+			monteCarloSamples = parseArgument<long>(monteCarloOptions[0], 1);
+		if (monteCarloOptions.size() > 1)
+			perturbation.speedNoise = parseArgument<double>(monteCarloOptions[1], 0);
+		if (monteCarloOptions.size() > 2)
+			perturbation.slip = parseArgument<double>(monteCarloOptions[2], 0);
+		if (monteCarloOptions.size() > 3)
+			perturbation.correlationTime = parseArgument<double>(monteCarloOptions[3], 0);
+		if (monteCarloOptions.size() > 4)
+			monteCarloSeed = parseArgument<std::uint64_t>(monteCarloOptions[4]);
+		monteCarloJobs = std::make_unique<JobSystem>(0);
+	}
+
+	// Heatmap under the grid, loaded from a file (e.g. of --bench-coverage) or counted live
+	// over the world map or the area around the origin across all runs of the session
+	CoverageMap coverage;
+	bool coverageLive = false;
+	long coverageCell = -1;
+	auto coverageTimer = std::chrono::steady_clock::now();
+	if (std::find(args.begin(), args.end(), "--coverage") != args.end()) {
+		std::vector<std::string> coverageOptions = getOptionValues(args, "--coverage");
+		if (coverageOptions.size() > 0) {
+			if (!coverage.loadFromFile(coverageOptions[0]))
+				return -1;
+			printf("Coverage map %ld x %ld cells with %llu visits\n", coverage.getColumns(), coverage.getRows(), static_cast<unsigned long long>(coverage.getTotal()));
+		}
+		else {
+			bool created = world.empty()
+				? coverage.create(std::lround(2 * COVERAGE_GUI_EXTENT / COVERAGE_DEFAULT_RESOLUTION), std::lround(2 * COVERAGE_GUI_EXTENT / COVERAGE_DEFAULT_RESOLUTION),
+					COVERAGE_DEFAULT_RESOLUTION, -COVERAGE_GUI_EXTENT, -COVERAGE_GUI_EXTENT)
+				: coverage.create(world.getColumns(), world.getRows(), world.getResolution(), world.getOriginX(), world.getOriginY());
+			if (!created)
+				return -1;
+			coverageLive = true;
+		}
+	}
+
+	// Keyframes of the current run for scrubbing back in time, schedule driven runs only
+	Timeline timeline = Timeline();
+	Vehicle scrubVehicle = Vehicle(DEFAULT_WHEELBASE);
+	long scrubStep = -1;
 
 	Grid grid = Grid(font);
 	grid.recalculate(sf::Vector2f(0, 0), window.getSize());
+	if (!world.empty())
+		grid.setWorld(&world);
+	if (!coverage.empty())
+		grid.setCoverage(&coverage);
 
 	Ruler rulers = Ruler();
 	rulers.recalculate(sf::Vector2f(0, 0), window.getSize(), panel.getSize());
 	
 	FileHandler logFileHandler = FileHandler();
-	logFileHandler.createNewFile();
+	logFileHandler.createNewFile(getLogSuffix());
+
+	// Every step of the window goes through the journal, recorded only with --record
+	SessionJournal journal;
+	if (std::find(args.begin(), args.end(), "--record") != args.end()) {
+		std::vector<std::string> recordOptions = getOptionValues(args, "--record");
+		journal.open((recordOptions.size() > 0) ? recordOptions[0] : JOURNAL_DEFAULT_FILE, vehicle);
+		remoteControl.setJournal(&journal);
+	}
 
 	// Count timer
 	auto end_time = std::chrono::high_resolution_clock::now(); // get current time again
@@ -1502,6 +5079,10 @@ int main() {
 
 	long stepCounter = 0;
 
+	// Simulation mode ends at the schedule end or a collision instead of logging a standing vehicle
+	StopMonitor scheduleStop;
+	bool runFinished = false;
+
 	while (window.isOpen())
 	{
 		if (config.getChangeStatus()) {
@@ -1509,13 +5090,24 @@ int main() {
 			grid.recolor();
 			grid.recalculate(sf::Vector2f(vehicle.getX(), -vehicle.getY()), window.getSize());
 			rulers.recolor();
-			vehicle.recolor();
 			config.setChangeStatus(false);
 		}
 
 		if (config.getPositionResetStatus()) {
-			vehicle.resetPosition();
-			vehicle.deleteTrail();
+			journal.resetPosition(vehicle);
+			resetTrails(vehicle, odometry.get());
+			timeline.clear();
+			scheduleStop.reset();
+			if (odometry)
+				odometry->reset(vehicle.getX(), vehicle.getY(), vehicle.getPhi());
+			if (ekf) {
+				ekf->reset(vehicle.getX(), vehicle.getY(), vehicle.getPhi());
+				landmarkSensor->resetSchedule();
+				observations.clear();
+			}
+			monteCarloDone = false;
+			coverageCell = -1;
+			runFinished = false;
 			config.setPositionResetStatus(false);
 		}
 
@@ -1526,13 +5118,29 @@ int main() {
 			draw_timer = calc_timer;
 			abso_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - abso_timer); // calculate time difference
 			stepCounter = 0;
-			vehicle.deleteTrail();
-			logFileHandler.createNewFile();
+			resetTrails(vehicle, odometry.get());
+			logFileHandler.createNewFile(getLogSuffix());
+			telemetry.resetSampleTime();
+			timeline.clear();
+			scheduleStop.reset();
+			if (lidar)
+				lidar->resetSchedule();
+			if (odometry)
+				odometry->reset(vehicle.getX(), vehicle.getY(), vehicle.getPhi());
+			if (ekf) {
+				ekf->reset(vehicle.getX(), vehicle.getY(), vehicle.getPhi());
+				landmarkSensor->resetSchedule();
+				observations.clear();
+			}
+			monteCarloDone = false;
+			coverageCell = -1;
+			scanValid = false;
+			runFinished = false;
 			config.setTimerResetStatus(false);
 		}
 
 		if (config.getDataStatus()) {
-			data.getInputData();
+			getInputData(data);
 		}
 
 		while (window.pollEvent(event))
@@ -1589,6 +5197,13 @@ int main() {
 
 			if (event.type == sf::Event::Closed) {
 				window.close();
+				journal.close();
+				if (coverageLive && coverage.getTotal() > 0) {
+					std::filesystem::create_directory("logData");
+					if (coverage.saveToFile(COVERAGE_DEFAULT_FILE))
+						std::cout << "Coverage map written to " << COVERAGE_DEFAULT_FILE << std::endl;
+				}
+				remoteControl.printLatencyStats();
 				return 0;
 			}
 		}
@@ -1597,12 +5212,81 @@ int main() {
 		// Calculating the simulation with fixed or variable time delta depending on the need of precision
 		// ==================================================================================================
 
-		if (config.getAppMode() == ApplicationMode::SIMULATION_MODE) {
-			if (config.getSimMode() != SimulationMode::GAME) {
-				data.setVehicleSpeed(stepCounter / SIMULATION_SECOND_STEP_AMOUNT, vehicle);
+		bool timelineEnabled = config.getAppMode() == ApplicationMode::SIMULATION_MODE && config.getSimMode() != SimulationMode::GAME;
+		if (!timelineEnabled && timelinePosition < 1) {
+			timelinePosition = 1;
+			panel.setSliderValue(0, 1);
+		}
+		bool scrubbing = timelineEnabled && timelinePosition < 1 && !timeline.empty();
+
+		if (scrubbing) {
+			// Simulation is paused while the slider is off the end
+			long first = timeline.getFirstStep();
+			long target = first + std::lround(timelinePosition * (timeline.getLastStep() - first));
+			if (target != scrubStep) {
+				timeline.seek(target, scrubVehicle, data);
+				scrubStep = target;
+			}
+		}
+		else if (config.getAppMode() == ApplicationMode::SIMULATION_MODE) {
+			scrubStep = -1;
+			if (!runFinished && config.getSimMode() != SimulationMode::GAME) {
+				StopReason reason = scheduleStop.check(getStepTime(stepCounter), vehicle.getX(), vehicle.getY(),
+					vehicle.lWheel.getTangencialVel(), vehicle.rWheel.getTangencialVel(), stepCounter >= ScenarioRun::getStepCount(data));
+				if (reason == StopReason::NONE && world.collidesCircle(vehicle.getX(), vehicle.getY(), vehicle.getWheelbase() / 2))
+					reason = StopReason::COLLISION;
+				if (reason != StopReason::NONE) {
+					// Nothing changes after the last speed change, stepping and logging end there
+					runFinished = true;
+					logFileHandler.flush();
+					printf("Run stopped by %s at %.3f [s], simulation and log stopped\n", getStopReasonName(reason), getStepTime(stepCounter));
+					printStatistics(vehicle.getStatistics());
+					if (odometry) {
+						printf("Odometry drift: position %.6f [m] | heading %.6f [rad]\n", odometry->getPositionError(vehicle.getX(), vehicle.getY()),
+							odometry->getHeadingError(vehicle.getPhi()));
+					}
+					if (ekf) {
+						printf("EKF error: position %.6f [m] | heading %.6f [rad]\n", std::hypot(ekf->getX() - vehicle.getX(), ekf->getY() - vehicle.getY()),
+							std::remainder(ekf->getPhi() - vehicle.getPhi(), 2 * M_PI));
+					}
+				}
+			}
+			if (monteCarloJobs && !monteCarloDone && stepCounter == 0 && config.getSimMode() != SimulationMode::GAME) {
+				double duration;
+				std::vector<SpeedSegment> segments = getAppliedSegments(data.getSchedule(), ScenarioRun::getStepCount(data), duration);
+				monteCarloX.resize(monteCarloSamples);
+				monteCarloY.resize(monteCarloSamples);
+				monteCarloPhi.resize(monteCarloSamples);
+				runMonteCarlo(segments, duration, vehicle.getWheelbase(), perturbation, vehicle.getX(), vehicle.getY(), vehicle.getPhi(),
+					monteCarloSamples, monteCarloSeed, monteCarloX.data(), monteCarloY.data(), monteCarloPhi.data(), *monteCarloJobs);
+				monteCarloResult = summarizePoses(monteCarloX, monteCarloY, monteCarloPhi);
+				monteCarloDone = true;
+				printf("Monte Carlo end pose of %ld runs: mean x = %.4f [m] | y = %.4f [m] | phi = %.4f [rad], 95 %% ellipse %.4f x %.4f [m]\n",
+					monteCarloSamples, monteCarloResult.mean(0, 0), monteCarloResult.mean(1, 0), monteCarloResult.mean(2, 0),
+					monteCarloResult.ellipseMajor, monteCarloResult.ellipseMinor);
+			}
+			if (!runFinished) {
+				if (timelineEnabled && timeline.empty()) {
+					timeline.record(stepCounter, vehicle, data.getSchedule());
+				}
+				if (config.getSimMode() != SimulationMode::GAME) {
+					data.setVehicleSpeed(getStepTime(stepCounter), vehicle);
+				}
+				else if (remoteControl.isEnabled()) {
+					remoteControl.applyPending(vehicle);
+				}
+				journal.step(vehicle, SIMULATION_FIXED_STEP);
+				if (odometry)
+					odometry->step(SIMULATION_FIXED_STEP, vehicle.lWheel.getTangencialVel(), vehicle.rWheel.getTangencialVel());
+				if (ekf)
+					ekf->predict(odometry->getLastDistanceLeft(), odometry->getLastDistanceRight());
+				stepCounter++;
+				if (timelineEnabled)
+					timeline.record(stepCounter, vehicle, data.getSchedule());
+				telemetry.publish(vehicle.getSample(getStepTime(stepCounter), stepCounter), vehicle.getStatistics());
+				if (telemetryRing.isEnabled())
+					telemetryRing.write(vehicle.getSample(getStepTime(stepCounter), stepCounter));
 			}
-			vehicle.recalculate(SIMULATION_FIXED_STEP);
-			stepCounter++;
 		}
 		else if (config.getAppMode() == ApplicationMode::GAME_MODE) {
 			end_time = std::chrono::high_resolution_clock::now(); // get current time again
@@ -1611,40 +5295,79 @@ int main() {
 
 			// Calculate data
 			if (calc_duration.count() >= 100) { // check if 10micro/s has elapsed
-				vehicle.recalculate(calc_duration.count() * TIME_uS);
+				if (remoteControl.isEnabled() && config.getSimMode() == SimulationMode::GAME) {
+					remoteControl.advance(vehicle, calc_duration.count() * TIME_uS);
+				}
+				else {
+					journal.step(vehicle, calc_duration.count() * TIME_uS);
+				}
+				// Speeds at the end of the interval, remote commands within it are not split
+				if (odometry)
+					odometry->step(calc_duration.count() * TIME_uS, vehicle.lWheel.getTangencialVel(), vehicle.rWheel.getTangencialVel());
+				if (ekf)
+					ekf->predict(odometry->getLastDistanceLeft(), odometry->getLastDistanceRight());
 				calc_timer = std::chrono::high_resolution_clock::now(); // reset start time
+				telemetry.publish(vehicle.getSample(abso_duration.count() * TIME_mS, stepCounter), vehicle.getStatistics());
+				if (telemetryRing.isEnabled())
+					telemetryRing.write(vehicle.getSample(abso_duration.count() * TIME_mS, stepCounter));
+			}
+		}
+
+		Vehicle& shown = scrubbing ? scrubVehicle : vehicle;
+		long shownStep = scrubbing ? scrubStep : stepCounter;
+
+		// Scans of the live vehicle at the lidar rate, the last one stays on screen
+		double sensorTime = (config.getAppMode() == ApplicationMode::GAME_MODE) ? (abso_duration.count() * TIME_mS) : getStepTime(stepCounter);
+		if (lidar && !scrubbing && !runFinished && config.getAppMode() != ApplicationMode::NONE && lidar->isScanDue(sensorTime)) {
+			scanX = vehicle.getX();
+			scanY = vehicle.getY();
+			scanPhi = vehicle.getPhi();
+			lidar->scan(world, scanX, scanY, scanPhi, scanRanges.data());
+			scanValid = true;
+			telemetry.publishScan(sensorTime, scanX, scanY, scanPhi, *lidar, scanRanges);
+		}
+		// Landmark observations of the true pose corrected into the filter at the sensor rate
+		if (ekf && !scrubbing && !runFinished && config.getAppMode() != ApplicationMode::NONE && landmarkSensor->isObservationDue(sensorTime)) {
+			observedX = vehicle.getX();
+			observedY = vehicle.getY();
+			landmarkSensor->observe(observedX, observedY, vehicle.getPhi(), world.empty() ? nullptr : &world, observations);
+			const LandmarkSensorSettings& sensor = landmarkSensor->getSettings();
+			for (const LandmarkObservation& observation : observations) {
+				const Landmark& landmark = landmarks.getLandmarks()[observation.landmark];
+				ekf->updateLandmark(observation.range, observation.bearing, landmark.x, landmark.y,
+					sensor.rangeNoise * sensor.rangeNoise, sensor.bearingNoise * sensor.bearingNoise);
+			}
+		}
+
+		// Visits of the live vehicle, the heatmap is repainted a few times per second
+		if (coverageLive && !scrubbing && !runFinished && config.getAppMode() != ApplicationMode::NONE) {
+			coverage.visit(vehicle.getX(), vehicle.getY(), coverageCell);
+			if (std::chrono::steady_clock::now() - coverageTimer > std::chrono::milliseconds(COVERAGE_REPAINT_INTERVAL)) {
+				grid.refreshCoverage();
+				coverageTimer = std::chrono::steady_clock::now();
 			}
 		}
 
-		grid.checkRecalculate(sf::Vector2f(vehicle.getX(), -vehicle.getY()), window.getSize());
-		rulers.recalculate(sf::Vector2f(vehicle.getX(), -vehicle.getY()), window.getSize(), panel.getSize());
+		grid.checkRecalculate(sf::Vector2f(shown.getX(), -shown.getY()), window.getSize());
+		rulers.recalculate(sf::Vector2f(shown.getX(), -shown.getY()), window.getSize(), panel.getSize());
+		StatisticsSample shownStatistics = shown.getStatistics();
 		panel.updateLabels(std::vector<double>{
-			vehicle.getTangencialVel(), 
-			vehicle.getAngularVel(), 
-			vehicle.lWheel.getTangencialVel(), 
-			vehicle.rWheel.getTangencialVel(),
-			vehicle.getX(), 
-			vehicle.getY(), 
-			(config.getAppMode()==ApplicationMode::GAME_MODE)?(abso_duration.count() * TIME_mS):(stepCounter / SIMULATION_SECOND_STEP_AMOUNT), 
-			(double)stepCounter});
+			shown.getTangencialVel(), 
+			shown.getAngularVel(), 
+			shown.lWheel.getTangencialVel(), 
+			shown.rWheel.getTangencialVel(),
+			shown.getX(), 
+			shown.getY(), 
+			(config.getAppMode()==ApplicationMode::GAME_MODE)?(abso_duration.count() * TIME_mS):getStepTime(shownStep), 
+			(double)shownStep,
+			shownStatistics.pathLength,
+			shownStatistics.totalRotation,
+			shownStatistics.maxSpeed,
+			shownStatistics.closureError});
 		
-		logFileHandler.writeToFile(std::vector<double>{
-			(config.getAppMode() == ApplicationMode::GAME_MODE) ? (abso_duration.count() * TIME_mS) : (stepCounter / SIMULATION_SECOND_STEP_AMOUNT), /*time*/
-			(double)stepCounter,				/*steps*/
-			vehicle.getTangencialVel(),			/*vehicle vT*/
-			vehicle.getAngularVel(),			/*vehicle omegaT*/
-			vehicle.getX(),						/*vehicle x*/
-			vehicle.getY(),						/*vehicle y*/
-			vehicle.getPhi(),					/*vehicle phi*/
-			vehicle.lWheel.getTangencialVel(),	/*L wheel vT*/
-			vehicle.lWheel.getAngularVel(),		/*L wheel omega*/
-			vehicle.lWheel.getX(),				/*L wheel x*/
-			vehicle.lWheel.getY(),				/*L wheel y*/
-			vehicle.rWheel.getTangencialVel(),	/*R wheel vT*/
-			vehicle.rWheel.getAngularVel(),		/*R wheel omega*/
-			vehicle.rWheel.getX(),				/*R wheel x*/
-			vehicle.rWheel.getY()});			/*R wheel y*/
-														
+		if (!scrubbing && !runFinished) {
+			logFileHandler.writeVehicleState((config.getAppMode() == ApplicationMode::GAME_MODE) ? (abso_duration.count() * TIME_mS) : getStepTime(stepCounter), stepCounter, vehicle);
+		}
 
 		// ==================================================================================================
 		// Drawing of the application
@@ -1652,11 +5375,26 @@ int main() {
 
 		window.clear(config.getColBackground());
 
-		simulationView.setCenter(vehicle.getX() * DEFAULT_SCALE, -vehicle.getY() * DEFAULT_SCALE);
+		simulationView.setCenter(shown.getX() * DEFAULT_SCALE, -shown.getY() * DEFAULT_SCALE);
 		window.setView(simulationView);
 		grid.draw(window);
 		rulers.draw(window);
-		vehicle.draw(window);
+		if (!scrubbing) {
+			vehicle.sampleWheelTrails();
+			if (odometry)
+				odometry->sampleTrail();
+		}
+		if (odometry && !scrubbing)
+			drawOdometry(window, *odometry);
+		if (lidar && scanValid && !scrubbing)
+			drawScan(window, scanX, scanY, scanPhi, *lidar, scanRanges);
+		if (ekf && !scrubbing)
+			drawLocalization(window, *ekf, landmarks, observations, observedX, observedY);
+		if (monteCarloDone)
+			drawMonteCarlo(window, monteCarloResult, monteCarloX, monteCarloY);
+		drawVehicle(window, shown);
+		if (!world.empty())
+			drawFootprint(window, shown, world.collidesCircle(shown.getX(), shown.getY(), shown.getWheelbase() / 2));
 
 		window.setView(window.getDefaultView());
 		panel.draw(window);